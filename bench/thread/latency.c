@@ -0,0 +1,117 @@
+/**
+ * @file latency.c
+ * @author andersonarc (e.andersonarc@gmail.com)
+ * @version 0.1
+ * @date 2021-06-10
+ *
+ *  Submit-to-completion latency benchmark
+ *
+ *  Submits a single task at a time, either as a task list
+ *  or through the queue, and measures the time until
+ *  the task returns, including the wakeup of a parked
+ *  worker. Prints the latency distribution.
+ */
+    /* includes */
+#include <stdlib.h>        /* qsort() */
+#include "suite.h"         /* benchmark suite */
+#include "ctool/assert/debug.h" /* debug assertions */
+
+    /* constant presets */
+#define CTOOL_BENCH_ITERATIONS 2000
+
+    /* typedefs */
+/**
+ * Probe task state
+ */
+typedef struct probe_t {
+    uint64_t work;
+    uint64_t completed;
+} probe_t;
+
+    /* sample tasks */
+task_output_t probe(task_input_t input) {
+    probe_t* state = input;
+    bench_work((task_input_t) (uintptr_t) state->work);
+    state->completed = bench_now();
+    return task_output_default;
+}
+
+    /* functions */
+/**
+ * Submits one probe task and waits for it to finish
+ *
+ * @param[in] manager The task manager
+ * @param[in] queue   If the task is enqueued instead of submitted
+ * @param[in] work    Work of the task in nanoseconds
+ *
+ * @return Time from submission to completion of the task in nanoseconds
+ */
+uint64_t run_probe(task_manager_t* manager, bool queue, uint64_t work) {
+    probe_t state = { .work = work };
+    task_t task = { probe, &state };
+    uint64_t start = bench_now();
+    if (queue) {
+        while (task_manager_enqueue(manager, task) != ST_OK) {
+            sched_yield();
+        }
+    } else {
+        task_list_t tasks;
+        status_t status = task_list_init(&tasks, 1);
+        assertdc_status(status, "failed to create task list");
+        tasks.data[0] = task;
+        status = task_manager_submit(manager, tasks);
+        assertdc_status(status, "failed to submit task list");
+    }
+    task_manager_await(manager);
+    return state.completed - start;
+}
+
+/**
+ * Measures the latency distribution of one
+ * configuration and prints it
+ *
+ * @param[in] manager The task manager
+ * @param[in] mode    Name of the submission mode
+ * @param[in] threads Number of threads
+ * @param[in] work    Work of a task in nanoseconds
+ */
+void measure(task_manager_t* manager, const char* mode, size_t threads, uint64_t work) {
+    static uint64_t latency[CTOOL_BENCH_ITERATIONS];
+    bool queue = mode[0] == 'q';
+    uint64_t total = 0;
+    for (size_t i = 0; i < CTOOL_BENCH_ITERATIONS; i++) {
+        latency[i] = run_probe(manager, queue, work);
+        total += latency[i];
+    }
+
+    qsort(latency, CTOOL_BENCH_ITERATIONS, sizeof(uint64_t), bench_compare);
+    printf("{\"benchmark\": \"latency\", \"mode\": \"%s\", \"threads\": %zu, \"work_ns\": %" PRIu64 ", "
+        "\"samples\": %d, \"mean_ns\": %" PRIu64 ", \"min_ns\": %" PRIu64 ", \"p50_ns\": %" PRIu64 ", \"p90_ns\": %" PRIu64 ", "
+        "\"p99_ns\": %" PRIu64 ", \"p999_ns\": %" PRIu64 ", \"max_ns\": %" PRIu64 "}\n",
+        mode, threads, work, CTOOL_BENCH_ITERATIONS, total / CTOOL_BENCH_ITERATIONS,
+        latency[0],
+        latency[CTOOL_BENCH_ITERATIONS / 2],
+        latency[CTOOL_BENCH_ITERATIONS * 9 / 10],
+        latency[CTOOL_BENCH_ITERATIONS * 99 / 100],
+        latency[CTOOL_BENCH_ITERATIONS * 999 / 1000],
+        latency[CTOOL_BENCH_ITERATIONS - 1]);
+}
+
+    /* main function */
+int main() {
+    size_t threads[CTOOL_BENCH_MAX_THREADS];
+    size_t counts = bench_threads(threads);
+
+    for (size_t t = 0; t < counts; t++) {
+        task_manager_t manager;
+        status_t status = task_manager_create(&manager, threads[t]);
+        assertdc_status(status, "failed to initialize task manager");
+
+        for (size_t g = 0; g < CTOOL_BENCH_GRANULARITIES; g++) {
+            measure(&manager, "list", threads[t], bench_granularity[g]);
+            measure(&manager, "queue", threads[t], bench_granularity[g]);
+        }
+        task_manager_delete(&manager);
+    }
+    return EXIT_SUCCESS;
+}
\ No newline at end of file
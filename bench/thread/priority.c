@@ -0,0 +1,125 @@
+/**
+ * @file priority.c
+ * @author andersonarc (e.andersonarc@gmail.com)
+ * @version 0.1
+ * @date 2021-06-04
+ * 
+ *  Task priority benchmark
+ * 
+ *  Saturates a task manager with low priority tasks,
+ *  each of them re-enqueueing itself, and measures 
+ *  the latency between enqueueing and execution 
+ *  of high and low priority probe tasks.
+ */
+    /* includes */
+#include <stdio.h>         /* printf */
+#include <stdint.h>        /* uint64_t */
+#include <sched.h>         /* sched_yield() */
+#include <time.h>          /* clock_gettime */
+#include "ctool/thread.h"  /* task manager */
+#include "ctool/assert/debug.h" /* debug assertions */
+#include "ctool/log.h"     /* logging */
+
+    /* constant presets */
+#define CTOOL_BENCH_THREADS 4
+#define CTOOL_BENCH_LOAD 256
+#define CTOOL_BENCH_LOAD_NS 20000
+#define CTOOL_BENCH_ITERATIONS 2000
+
+    /* time presets */
+struct timespec us200 = { 0, 1000 * 200 };
+
+    /* shared task manager */
+task_manager_t manager;
+atomic_int loaded = true;
+atomic_size_t probed = 0;
+
+    /* assistant functions */
+uint64_t now_ns() {
+    struct timespec time;
+    clock_gettime(CLOCK_MONOTONIC, &time);
+    return (uint64_t) time.tv_sec * 1000000000 + time.tv_nsec;
+}
+
+int compare_u64(const void* a, const void* b) {
+    uint64_t x = *(const uint64_t*) a, y = *(const uint64_t*) b;
+    return (x > y) - (x < y);
+}
+
+    /* sample tasks */
+task_output_t load(task_input_t input) {
+    uint64_t start = now_ns();
+    while (now_ns() - start < CTOOL_BENCH_LOAD_NS);
+    if (loaded) {
+        task_t task = { load, input };
+        while (task_manager_enqueue_priority(&manager, task, CTOOL_TASK_PRIORITY_LOW) != ST_OK) {
+            sched_yield();
+        }
+    }
+    return task_output_default;
+}
+
+task_output_t probe(task_input_t input) {
+    /* the input holds the enqueue timestamp, replace it with the latency */
+    uint64_t* latency = input;
+    *latency = now_ns() - *latency;
+    probed++;
+    return task_output_default;
+}
+
+    /* functions */
+/**
+ * Measures probe latency at a priority level
+ * and prints its distribution
+ * 
+ * @param[in] name     Name of the level
+ * @param[in] priority The priority level
+ */
+void measure(const char* name, task_priority_t priority) {
+    static uint64_t latency[CTOOL_BENCH_ITERATIONS];
+    probed = 0;
+    for (size_t i = 0; i < CTOOL_BENCH_ITERATIONS; i++) {
+        nanosleep(&us200, NULL);
+        latency[i] = now_ns();
+        task_t task = { probe, &latency[i] };
+        while (task_manager_enqueue_priority(&manager, task, priority) != ST_OK) {
+            sched_yield();
+        }
+    }
+
+    /* the load never lets the queues drain, wait for the probes only */
+    while (probed < CTOOL_BENCH_ITERATIONS) {
+        nanosleep(&us200, NULL);
+    }
+
+    qsort(latency, CTOOL_BENCH_ITERATIONS, sizeof(uint64_t), compare_u64);
+    printf("%s_latency_us min %.1f p50 %.1f p99 %.1f max %.1f\n", name,
+        latency[0] / 1000.0,
+        latency[CTOOL_BENCH_ITERATIONS / 2] / 1000.0,
+        latency[CTOOL_BENCH_ITERATIONS * 99 / 100] / 1000.0,
+        latency[CTOOL_BENCH_ITERATIONS - 1] / 1000.0);
+}
+
+    /* main function */
+int main() {
+    status_t status = ST_OK;
+
+    logi("initializing task manager with %d threads", CTOOL_BENCH_THREADS);
+    status = task_manager_create(&manager, CTOOL_BENCH_THREADS);
+    assertdc_status(status, "failed to initialize task manager");
+
+    logi("saturating the pool with %d low priority tasks of %d ns", CTOOL_BENCH_LOAD, CTOOL_BENCH_LOAD_NS);
+    for (size_t i = 0; i < CTOOL_BENCH_LOAD; i++) {
+        status = task_manager_enqueue_priority(&manager, (task_t) { load, task_input_default }, CTOOL_TASK_PRIORITY_LOW);
+        assertdc_status(status, "failed to enqueue load task");
+    }
+
+    logi("measuring enqueue-to-execution latency over %d probes per level", CTOOL_BENCH_ITERATIONS);
+    measure("high", CTOOL_TASK_PRIORITY_HIGH);
+    measure("low", CTOOL_TASK_PRIORITY_LOW);
+
+    loaded = false;
+    task_manager_await(&manager);
+    task_manager_delete(&manager);
+    return EXIT_SUCCESS;
+}
\ No newline at end of file
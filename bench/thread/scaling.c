@@ -0,0 +1,74 @@
+/**
+ * @file scaling.c
+ * @author andersonarc (e.andersonarc@gmail.com)
+ * @version 0.1
+ * @date 2021-06-10
+ *
+ *  Scaling efficiency benchmark
+ *
+ *  Executes the same task list on every thread count
+ *  and compares the time to the single thread run.
+ *  The efficiency is the speedup divided by the number
+ *  of threads, it can only reach 1 while there are
+ *  enough CPUs for the threads.
+ */
+    /* includes */
+#include "suite.h"         /* benchmark suite */
+#include "ctool/assert/debug.h" /* debug assertions */
+
+    /* functions */
+/**
+ * Measures the best time of a task list
+ * on a new task manager
+ *
+ * @param[in] scheduler The task scheduler
+ * @param[in] threads   Number of threads
+ * @param[in] size      Number of tasks
+ * @param[in] work      Work of a task in nanoseconds
+ *
+ * @return Time of the fastest repeat in nanoseconds
+ */
+uint64_t run(task_scheduler_t scheduler, size_t threads, size_t size, uint64_t work) {
+    task_manager_t manager;
+    task_manager_options_t options = { .threads = threads, .scheduler = scheduler };
+    status_t status = task_manager_create_custom(&manager, options);
+    assertdc_status(status, "failed to initialize task manager");
+
+    /* the first run is a warm-up */
+    uint64_t best = UINT64_MAX;
+    for (size_t i = 0; i <= CTOOL_BENCH_REPEATS; i++) {
+        uint64_t elapsed = bench_run_list(&manager, size, work);
+        assertdc_true(elapsed != 0, "failed to run %zu tasks", size);
+        if (i != 0 && elapsed < best) {
+            best = elapsed;
+        }
+    }
+    task_manager_delete(&manager);
+    return best;
+}
+
+    /* main function */
+int main() {
+    size_t threads[CTOOL_BENCH_MAX_THREADS];
+    size_t counts = bench_threads(threads);
+    task_scheduler_t schedulers[] = { CTOOL_TASK_SCHEDULER_SHARED, CTOOL_TASK_SCHEDULER_STEALING };
+
+    for (size_t s = 0; s < 2; s++) {
+        for (size_t g = 0; g < CTOOL_BENCH_GRANULARITIES; g++) {
+            /* thread counts start from one, it is the baseline */
+            uint64_t baseline = 0;
+            for (size_t t = 0; t < counts; t++) {
+                uint64_t elapsed = run(schedulers[s], threads[t], bench_tasks[g], bench_granularity[g]);
+                if (t == 0) {
+                    baseline = elapsed;
+                }
+                double speedup = (double) baseline / elapsed;
+                printf("{\"benchmark\": \"scaling\", \"scheduler\": \"%s\", \"cpus\": %zu, \"threads\": %zu, "
+                    "\"work_ns\": %" PRIu64 ", \"tasks\": %zu, \"seconds\": %.6f, \"speedup\": %.3f, \"efficiency\": %.3f}\n",
+                    bench_scheduler(schedulers[s]), bench_cpus(), threads[t], bench_granularity[g],
+                    bench_tasks[g], elapsed / 1e9, speedup, speedup / threads[t]);
+            }
+        }
+    }
+    return EXIT_SUCCESS;
+}
\ No newline at end of file
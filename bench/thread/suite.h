@@ -0,0 +1,135 @@
+/**
+ * @file suite.h
+ * @author andersonarc (e.andersonarc@gmail.com)
+ * @version 0.1
+ * @date 2021-06-10
+ *
+ *  Thread pool benchmark suite presets
+ *
+ *  The suite benchmarks run every thread count from 1
+ *  up to twice the number of online CPUs, doubling it,
+ *  and task granularities from an empty task to 10 us
+ *  of busy work. They print one JSON object per line
+ *  to stdout, so that results can be compared over time.
+ */
+    /* header guard */
+#ifndef CTOOL_BENCH_THREAD_SUITE_H
+#define CTOOL_BENCH_THREAD_SUITE_H
+
+    /* includes */
+#include <stdio.h>         /* printf */
+#include <stdint.h>        /* uint64_t */
+#include <inttypes.h>      /* PRIu64 */
+#include <sched.h>         /* sched_yield() */
+#include <time.h>          /* clock_gettime */
+#include <unistd.h>        /* sysconf() */
+#include "ctool/thread.h"  /* task manager */
+
+    /* constant presets */
+#define CTOOL_BENCH_MAX_THREADS 64
+#define CTOOL_BENCH_GRANULARITIES 4
+#define CTOOL_BENCH_REPEATS 3
+
+/**
+ * Busy work of a task in nanoseconds,
+ * and the number of tasks of a list for it
+ */
+static const uint64_t bench_granularity[CTOOL_BENCH_GRANULARITIES] = { 0, 100, 1000, 10000 };
+static const size_t bench_tasks[CTOOL_BENCH_GRANULARITIES] = { 1 << 18, 1 << 16, 1 << 14, 1 << 12 };
+
+    /* assistant functions */
+/**
+ * Returns the current value of the monotonic clock
+ *
+ * @return Time in nanoseconds
+ */
+static inline uint64_t bench_now() {
+    struct timespec time;
+    clock_gettime(CLOCK_MONOTONIC, &time);
+    return (uint64_t) time.tv_sec * 1000000000 + time.tv_nsec;
+}
+
+/**
+ * Compares two timings for qsort()
+ */
+static inline int bench_compare(const void* a, const void* b) {
+    uint64_t x = *(const uint64_t*) a, y = *(const uint64_t*) b;
+    return (x > y) - (x < y);
+}
+
+/**
+ * Returns the number of online CPUs
+ */
+static inline size_t bench_cpus() {
+    long cpus = sysconf(_SC_NPROCESSORS_ONLN);
+    return cpus > 0 ? (size_t) cpus : 1;
+}
+
+/**
+ * Fills the thread counts to benchmark
+ *
+ * @param[out] threads Array of CTOOL_BENCH_MAX_THREADS counts
+ *
+ * @return Number of thread counts
+ */
+static inline size_t bench_threads(size_t* threads) {
+    size_t count = 0, limit = 2 * bench_cpus();
+    for (size_t i = 1; i <= limit && i <= CTOOL_BENCH_MAX_THREADS; i *= 2) {
+        threads[count++] = i;
+    }
+    return count;
+}
+
+/**
+ * Returns the name of a task scheduler
+ */
+static inline const char* bench_scheduler(task_scheduler_t scheduler) {
+    return scheduler == CTOOL_TASK_SCHEDULER_STEALING ? "stealing" : "shared";
+}
+
+    /* sample tasks */
+/**
+ * Spins for the number of nanoseconds in the input,
+ * an empty task if it is zero
+ */
+static inline task_output_t bench_work(task_input_t input) {
+    uint64_t duration = (uintptr_t) input;
+    if (duration != 0) {
+        uint64_t start = bench_now();
+        while (bench_now() - start < duration);
+    }
+    return task_output_default;
+}
+
+    /* functions */
+/**
+ * Submits a list of tasks with the same work
+ * and waits for it to finish
+ *
+ * @param[in] manager The task manager
+ * @param[in] size    Number of tasks
+ * @param[in] work    Work of a task in nanoseconds
+ *
+ * @return Time from submission to completion in nanoseconds,
+ *          or zero if the list can't be submitted
+ */
+static inline uint64_t bench_run_list(task_manager_t* manager, size_t size, uint64_t work) {
+    task_list_t tasks;
+    if (task_list_init(&tasks, size) != ST_OK) {
+        return 0;
+    }
+    for (size_t i = 0; i < size; i++) {
+        tasks.data[i].function = bench_work;
+        tasks.data[i].input = (task_input_t) (uintptr_t) work;
+    }
+
+    uint64_t start = bench_now();
+    if (task_manager_submit(manager, tasks) != ST_OK) {
+        task_list_free(&tasks);
+        return 0;
+    }
+    task_manager_await(manager);
+    return bench_now() - start;
+}
+
+#endif /* CTOOL_BENCH_THREAD_SUITE_H */
\ No newline at end of file
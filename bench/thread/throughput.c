@@ -0,0 +1,89 @@
+/**
+ * @file throughput.c
+ * @author andersonarc (e.andersonarc@gmail.com)
+ * @version 0.1
+ * @date 2021-06-10
+ *
+ *  Empty task throughput benchmark
+ *
+ *  Measures how many empty tasks per second a task manager
+ *  executes, both as a submitted task list and as tasks
+ *  enqueued one by one, so that the result is dominated
+ *  by the scheduling overhead.
+ */
+    /* includes */
+#include "suite.h"         /* benchmark suite */
+#include "ctool/assert/debug.h" /* debug assertions */
+
+    /* functions */
+/**
+ * Enqueues empty tasks one by one
+ * and waits for them to finish
+ *
+ * @param[in] manager The task manager
+ * @param[in] size    Number of tasks
+ *
+ * @return Time from the first enqueue to completion in nanoseconds
+ */
+uint64_t run_queue(task_manager_t* manager, size_t size) {
+    task_t task = { bench_work, task_input_default };
+    uint64_t start = bench_now();
+    for (size_t i = 0; i < size; i++) {
+        while (task_manager_enqueue(manager, task) != ST_OK) {
+            sched_yield();
+        }
+    }
+    task_manager_await(manager);
+    return bench_now() - start;
+}
+
+/**
+ * Measures the throughput of one configuration
+ * and prints it, the best of the repeats is taken
+ *
+ * @param[in] manager   The task manager
+ * @param[in] mode      Name of the submission mode
+ * @param[in] scheduler The task scheduler
+ * @param[in] threads   Number of threads
+ */
+void measure(task_manager_t* manager, const char* mode, task_scheduler_t scheduler, size_t threads) {
+    bool queue = mode[0] == 'q';
+    size_t size = bench_tasks[0];
+    uint64_t best = UINT64_MAX;
+
+    /* the first run is a warm-up */
+    for (size_t i = 0; i <= CTOOL_BENCH_REPEATS; i++) {
+        uint64_t elapsed = queue ? run_queue(manager, size) : bench_run_list(manager, size, 0);
+        assertdc_true(elapsed != 0, "failed to run %zu tasks", size);
+        if (i != 0 && elapsed < best) {
+            best = elapsed;
+        }
+    }
+    printf("{\"benchmark\": \"throughput\", \"mode\": \"%s\", \"scheduler\": \"%s\", \"threads\": %zu, "
+        "\"tasks\": %zu, \"seconds\": %.6f, \"tasks_per_second\": %.0f}\n",
+        mode, bench_scheduler(scheduler), threads, size, best / 1e9, size * 1e9 / best);
+}
+
+    /* main function */
+int main() {
+    size_t threads[CTOOL_BENCH_MAX_THREADS];
+    size_t counts = bench_threads(threads);
+    task_scheduler_t schedulers[] = { CTOOL_TASK_SCHEDULER_SHARED, CTOOL_TASK_SCHEDULER_STEALING };
+
+    for (size_t s = 0; s < 2; s++) {
+        for (size_t t = 0; t < counts; t++) {
+            task_manager_t manager;
+            task_manager_options_t options = { .threads = threads[t], .scheduler = schedulers[s] };
+            status_t status = task_manager_create_custom(&manager, options);
+            assertdc_status(status, "failed to initialize task manager");
+
+            measure(&manager, "list", schedulers[s], threads[t]);
+            if (schedulers[s] == CTOOL_TASK_SCHEDULER_SHARED) {
+                /* the queues do not depend on the scheduler */
+                measure(&manager, "queue", schedulers[s], threads[t]);
+            }
+            task_manager_delete(&manager);
+        }
+    }
+    return EXIT_SUCCESS;
+}
\ No newline at end of file
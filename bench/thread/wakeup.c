@@ -0,0 +1,95 @@
+/**
+ * @file wakeup.c
+ * @author andersonarc (e.andersonarc@gmail.com)
+ * @version 0.1
+ * @date 2021-06-02
+ * 
+ *  Task manager wakeup benchmark
+ * 
+ *  Measures the latency between task_manager_submit()
+ *  and the first task execution on a parked pool, and
+ *  the CPU time consumed by idle workers.
+ */
+    /* includes */
+#include <stdio.h>         /* printf */
+#include <stdint.h>        /* uint64_t */
+#include <time.h>          /* clock_gettime */
+#include "ctool/thread.h"  /* task manager */
+#include "ctool/assert/debug.h" /* debug assertions */
+#include "ctool/log.h"     /* logging */
+
+    /* constant presets */
+#define CTOOL_BENCH_THREADS 8
+#define CTOOL_BENCH_ITERATIONS 1000
+#define CTOOL_BENCH_IDLE_MS 200
+
+    /* time presets */
+struct timespec ms1 = { 0, 1000 * 1000 };
+struct timespec idle = { 0, 1000 * 1000 * CTOOL_BENCH_IDLE_MS };
+
+    /* first execution timestamp */
+atomic_uint_fast64_t executed = 0;
+
+    /* assistant functions */
+uint64_t now_ns(clockid_t clock) {
+    struct timespec time;
+    clock_gettime(clock, &time);
+    return (uint64_t) time.tv_sec * 1000000000 + time.tv_nsec;
+}
+
+int compare_u64(const void* a, const void* b) {
+    uint64_t x = *(const uint64_t*) a, y = *(const uint64_t*) b;
+    return (x > y) - (x < y);
+}
+
+    /* sample tasks */
+task_output_t record(task_input_t input) {
+    uint_fast64_t expected = 0;
+    atomic_compare_exchange_strong(&executed, &expected, now_ns(CLOCK_MONOTONIC));
+    return task_output_default;
+}
+
+    /* main function */
+int main() {
+    status_t status = ST_OK;
+    task_manager_t manager;
+    static uint64_t latency[CTOOL_BENCH_ITERATIONS];
+
+    logi("initializing task manager with %d threads", CTOOL_BENCH_THREADS);
+    status = task_manager_create(&manager, CTOOL_BENCH_THREADS);
+    assertdc_status(status, "failed to initialize task manager");
+
+    /* measure CPU time used by the parked pool */
+    nanosleep(&ms1, NULL);
+    uint64_t cpu = now_ns(CLOCK_PROCESS_CPUTIME_ID);
+    nanosleep(&idle, NULL);
+    cpu = now_ns(CLOCK_PROCESS_CPUTIME_ID) - cpu;
+
+    logi("measuring submit-to-first-execution latency over %d submissions", CTOOL_BENCH_ITERATIONS);
+    for (size_t i = 0; i < CTOOL_BENCH_ITERATIONS; i++) {
+        task_list_t tasks;
+        status = task_list_init(&tasks, 1);
+        assertdc_status(status, "failed to create task list");
+        tasks.data[0].function = record;
+        tasks.data[0].input = task_input_default;
+
+        /* let the workers park before every submission */
+        nanosleep(&ms1, NULL);
+        executed = 0;
+        uint64_t start = now_ns(CLOCK_MONOTONIC);
+        status = task_manager_submit(&manager, tasks);
+        assertdc_status(status, "failed to submit task list");
+        task_manager_await(&manager);
+        latency[i] = executed - start;
+    }
+    task_manager_delete(&manager);
+
+    qsort(latency, CTOOL_BENCH_ITERATIONS, sizeof(uint64_t), compare_u64);
+    printf("idle_cpu_us %.1f (over %d ms)\n", cpu / 1000.0, CTOOL_BENCH_IDLE_MS);
+    printf("wakeup_us min %.1f p50 %.1f p99 %.1f max %.1f\n",
+        latency[0] / 1000.0,
+        latency[CTOOL_BENCH_ITERATIONS / 2] / 1000.0,
+        latency[CTOOL_BENCH_ITERATIONS * 99 / 100] / 1000.0,
+        latency[CTOOL_BENCH_ITERATIONS - 1] / 1000.0);
+    return EXIT_SUCCESS;
+}
\ No newline at end of file
@@ -25,7 +25,8 @@ typedef enum status_t {
     ST_FILE_FAIL, /* File access failure (fopen returned NULL, etc.)        */
     ST_ALLOC_FAIL, /* Memory allocation failure (malloc returned NULL, etc.) */
     ST_NET_FAIL,  /* Network failure (cannot open a socket, etc.)           */
-    ST_BAD_ARG     /* Bad argument passed to a function                      */
+    ST_BAD_ARG,    /* Bad argument passed to a function                      */
+    ST_BUSY        /* Resource is full or busy, retry later                  */
 } status_t;
 
 #endif /* CTOOL_STATUS_H */
\ No newline at end of file
@@ -10,7 +10,8 @@
  *  C11 threads for thread control. Thread safety is ensured by atomic index 
  *  and state, and verified by testing.
  * 
- *  @todo Different task execution modes (e.g. one function with multiple inputs)
+ *  If `CTOOL_THREAD_STATS` is defined, every worker counts
+ *  its executed tasks and time, see task_manager_stats().
  */
     /* header guard */
 #ifndef CTOOL_THREAD_H
@@ -18,6 +19,8 @@
 
     /* includes */
 #include <stdatomic.h> /* atomic types */
+#include <stdbool.h> /* boolean */
+#include <stdint.h> /* SIZE_MAX */
 #include <stdlib.h> /* free() */
 
 #ifdef CTOOL_THREAD_USE_POSIX
@@ -27,48 +30,48 @@
 #endif
 
 #include "ctool/status.h" /* return status */
+#include "ctool/thread/_internal.h" /* synchronization primitives */
+#include "ctool/thread/task.h" /* task type */
+#include "ctool/thread/deque.h" /* work-stealing deque */
+#include "ctool/thread/queue.h" /* task queue */
+#include "ctool/thread/affinity.h" /* worker placement */
 
     /* typedefs */
 /**
- * Input value for a task function
+ * Range function type for parallel loops,
+ * called with a chunk of indices from begin (inclusive)
+ * to end (exclusive) and a user context
  */
-typedef void* task_input_t;
+typedef void(*task_range_function_t)(size_t, size_t, task_input_t);
 
 /**
- * Output value for a task function
+ * Target execution time of a parallel loop chunk
+ * in nanoseconds, chunk sizes are adapted to it
  */
-#ifdef CTOOL_THREAD_USE_POSIX
-    typedef void* task_output_t;
-#else
-    typedef int task_output_t;
-#endif
+#define TASK_RANGE_CHUNK_TIME 50000
 
 /**
- * Default task output
+ * Task future callback state
  */
-#ifdef CTOOL_THREAD_USE_POSIX 
-    #define task_output_default NULL
-#else
-    #define task_output_default 0
-#endif
+typedef enum task_future_subscription_t {
+    CTOOL_TASK_FUTURE_FREE, CTOOL_TASK_FUTURE_REGISTERING, CTOOL_TASK_FUTURE_SUBSCRIBED
+} task_future_subscription_t;
 
 /**
- * Default task input
- */
-#define task_input_default NULL
-
-/**
- * Task function type
- */
-typedef task_output_t(*task_function_t)(task_input_t);
-
-/**
- * Task structure
+ * Task future structure
+ * 
+ * Holds the output of a task once `ready` is set.
+ * A `callback` can be subscribed while the future
+ * isn't ready, it is executed by the thread that
+ * completes the future, see task_future_subscribe().
+ * `subscribed` guards the callback.
  */
-typedef struct task_t {
-    task_function_t function;
-    task_input_t input;
-} task_t;
+typedef struct task_future_t {
+    atomic_int ready;
+    atomic_int subscribed;
+    task_t callback;
+    task_output_t output;
+} task_future_t;
 
 /**
  * Task list execution status
@@ -77,14 +80,43 @@ typedef enum task_list_status_t {
     CTOOL_TASK_LIST_WAITING, CTOOL_TASK_LIST_STOPPED, CTOOL_TASK_LIST_RUNNING
 } task_list_status_t;
 
+/**
+ * Task cancellation token
+ * 
+ * Can be shared by several task lists, and
+ * checked by long-running tasks themselves.
+ */
+typedef struct task_cancel_t {
+    atomic_int requested;
+} task_cancel_t;
+
 /**
  * Task list structure
+ * 
+ * The `pending` counter is decremented after each task
+ * returns, and the list is complete when it reaches zero.
+ * 
+ * Optional futures are stored in the same allocation
+ * right after the tasks, `futures[i]` receives 
+ * the output of `data[i]`.
+ * 
+ * Before a worker executes a task, it checks the optional
+ * `cancel` token and the `deadline`, an absolute time
+ * from task_deadline_after(), or 0 for none. Once either
+ * is reached, the remaining tasks are skipped and counted
+ * in `cancelled`, their futures are set ready with
+ * the default output.
  */
 typedef struct task_list_t {
     atomic_int status;
     atomic_size_t index;
+    atomic_size_t pending;
     size_t size;
     task_t* data;
+    task_future_t* futures;
+    task_cancel_t* cancel;
+    uint64_t deadline;
+    atomic_size_t cancelled;
 } task_list_t;
 
 /**
@@ -97,20 +129,214 @@ typedef struct task_list_t {
 #endif
 
 
+/**
+ * Task scheduling mode
+ * 
+ * Shared scheduler hands out tasks through
+ * the atomic index of the task list.
+ * 
+ * Stealing scheduler splits a submitted task list
+ * across per-worker deques, and idle workers steal
+ * tasks from their neighbours, so the workers
+ * do not contend on a single index.
+ */
+typedef enum task_scheduler_t {
+    CTOOL_TASK_SCHEDULER_SHARED, CTOOL_TASK_SCHEDULER_STEALING
+} task_scheduler_t;
+
+/**
+ * Task priority levels
+ * 
+ * Every level has its own queue, the queues are
+ * scanned from the highest level. Tasks of the current
+ * task list are taken after the normal level and
+ * before the low level.
+ */
+typedef enum task_priority_t {
+    CTOOL_TASK_PRIORITY_HIGH, CTOOL_TASK_PRIORITY_NORMAL, CTOOL_TASK_PRIORITY_LOW
+} task_priority_t;
+
+/**
+ * Number of task priority levels
+ */
+#define CTOOL_TASK_PRIORITIES 3
+
+/**
+ * Default time in nanoseconds after which
+ * an idle worker of an elastic pool is retired
+ */
+#define TASK_MANAGER_DEFAULT_IDLE_TIMEOUT 1000000000
+
+/**
+ * Worker index returned outside of a worker thread
+ */
+#define TASK_WORKER_NONE SIZE_MAX
+
+/**
+ * Task manager options
+ * 
+ * Zero-initialized fields select the defaults.
+ * 
+ * If `aging` is set, every `aging`-th task a worker
+ * picks is looked up from the lowest priority level
+ * instead, so that low priority tasks are not starved
+ * by a continuous stream of higher priority tasks.
+ * 
+ * If `affinity` is set, every worker is pinned to
+ * a CPU selected by the placement mode.
+ * 
+ * The pool starts with `threads` workers and is elastic
+ * if `min_threads` or `max_threads` differ from it.
+ * Workers are added while enqueued tasks outnumber
+ * the busy workers, up to `max_threads`, and a worker
+ * parked for `idle_timeout` nanoseconds is retired, 
+ * down to `min_threads`. Both bounds default to `threads`.
+ * 
+ * If `scratch_size` is set, every worker slot gets
+ * a zeroed scratch buffer of that many bytes, starting
+ * on its own cache line, see task_worker_scratch().
+ */
+typedef struct task_manager_options_t {
+    size_t threads;
+    task_scheduler_t scheduler;
+    size_t queue_size;
+    size_t aging;
+    task_affinity_t affinity;
+    size_t min_threads;
+    size_t max_threads;
+    uint64_t idle_timeout;
+    size_t scratch_size;
+} task_manager_options_t;
+
+/**
+ * Worker statistics
+ * 
+ * Times are in nanoseconds. `busy` is the time spent
+ * executing tasks, `idle` is the time spent parked, 
+ * and `wakeups` is the number of times the worker
+ * was woken up. `steals` counts the tasks taken from 
+ * other workers, and `misses` counts the steal attempts
+ * that found the deque of another worker empty.
+ */
+typedef struct task_worker_stats_t {
+    uint64_t executed;
+    uint64_t busy;
+    uint64_t idle;
+    uint64_t wakeups;
+    uint64_t steals;
+    uint64_t misses;
+    uint64_t longest;
+} task_worker_stats_t;
+
+/**
+ * Worker statistics counters
+ * 
+ * Written only by the worker itself, and 
+ * read concurrently by task_manager_stats().
+ */
+typedef struct task_worker_counters_t {
+    atomic_uint_fast64_t executed;
+    atomic_uint_fast64_t busy;
+    atomic_uint_fast64_t idle;
+    atomic_uint_fast64_t wakeups;
+    atomic_uint_fast64_t steals;
+    atomic_uint_fast64_t misses;
+    atomic_uint_fast64_t longest;
+} task_worker_counters_t;
+
+/**
+ * Worker thread structure
+ * 
+ * The `cpu` and `node` of a pinned worker are set
+ * before it starts, otherwise they are -1. A pinned
+ * worker allocates its deque after pinning itself,
+ * so that the memory is local to its node.
+ * 
+ * A worker is `joinable` from its start until its
+ * thread is joined, which happens after it is retired
+ * only when its slot is reused or the pool is deleted.
+ * 
+ * The `scratch` buffer and the user `data` pointer
+ * belong to the slot, so a worker started in place
+ * of a retired one inherits them.
+ */
+typedef struct task_worker_t {
+    struct task_manager_t* manager;
+    size_t index;
+    size_t picks;
+    int cpu;
+    int node;
+    bool joinable;
+    void* scratch;
+    void* data;
+    task_deque_t deque;
+    task_worker_counters_t counters;
+} task_worker_t;
+
 /**
  * Thread pool structure
+ * 
+ * Threads and workers are allocated for `capacity` slots,
+ * and the first `size` of them are running. Only the last
+ * running worker can retire, so the running workers
+ * always occupy the first slots. The `size` is changed
+ * with the manager locked, between `minimum` and `capacity`.
+ * 
+ * The scratch buffers of all slots are allocated
+ * as one `scratch` block, `scratch_size` bytes each.
  */
 typedef struct thread_pool_t {
-    size_t size;
+    atomic_size_t size;
+    size_t minimum;
+    size_t capacity;
+    uint64_t idle_timeout;
+    size_t scratch_size;
+    char* scratch;
     thread_t* data;
+    task_worker_t* workers;
 } thread_pool_t;
 
 /**
  * Task manager structure
+ * 
+ * Idle workers are parked on the `wakeup` condition
+ * and are woken up by every submission, which increments
+ * the `sequence` counter, or by an enqueued task if there
+ * are `sleepers`. Workers that are still inside the task
+ * list are counted in `active`. Workers that have 
+ * finished their initialization are counted in `started`,
+ * and those that failed it in `failed`.
+ * 
+ * Tasks can be enqueued at any time into the bounded
+ * `queues`, one per priority level, they are counted
+ * in `queued` until they return.
+ * 
+ * Completion of a task list is broadcasted through
+ * the `finished` condition and, if requested, 
+ * through an eventfd descriptor. Completion of a single
+ * future is broadcasted only if there are `waiters`.
+ * 
+ * While `paused` is set, the workers take no tasks
+ * and stay parked, the pool keeps its threads.
  */
 typedef struct task_manager_t {
     thread_pool_t pool;
     task_list_t tasks;
+    task_queue_t queues[CTOOL_TASK_PRIORITIES];
+    task_scheduler_t scheduler;
+    size_t aging;
+    thread_mutex_t lock;
+    thread_cond_t wakeup;
+    thread_cond_t finished;
+    size_t sequence;
+    size_t active;
+    size_t started;
+    size_t failed;
+    atomic_size_t sleepers;
+    atomic_size_t queued;
+    atomic_size_t waiters;
+    atomic_int paused;
+    int eventfd;
 } task_manager_t;
 
     /* functions */
@@ -127,6 +353,19 @@ typedef struct task_manager_t {
  */
 status_t task_manager_create(task_manager_t* manager, size_t threads);
 
+/**
+ * Creates a new task manager with custom options
+ * 
+ * @param[in] manager The task manager
+ * @param[in] options The options
+ * 
+ * @return ST_BAD_ARG if `threads` is out of the bounds,
+ *         ST_ALLOC_FAIL if an allocation fails, 
+ *         ST_FAIL if thread initialization fails,
+ *          otherwise ST_OK
+ */
+status_t task_manager_create_custom(task_manager_t* manager, task_manager_options_t options);
+
 /**
  * Creates a new task manager with specified
  * number of threads in a thread pool and executes
@@ -145,31 +384,317 @@ status_t task_manager_create_run(task_manager_t* manager, task_list_t tasks, siz
 /**
  * Deletes a task manager
  * 
- * The task list is freed automatically.
+ * The worker threads are stopped and joined,
+ * the task list is freed automatically. Tasks that
+ * have not started yet are abandoned, use
+ * task_manager_shutdown() first to finish them.
  * 
  * @param[in] manager The task manager
  */
 void task_manager_delete(task_manager_t* manager);
 
+/**
+ * Finishes every task of a task manager,
+ * then stops and joins the worker threads
+ * 
+ * A paused task manager is resumed first. Tasks can
+ * no longer be submitted or enqueued afterwards,
+ * the task manager still has to be deleted.
+ * 
+ * @param[in] manager The task manager
+ */
+void task_manager_shutdown(task_manager_t* manager);
+
+/**
+ * Pauses a task manager and waits until
+ * every worker is parked
+ * 
+ * Running tasks return normally, then the workers
+ * take no more tasks until task_manager_resume().
+ * Tasks can still be submitted and enqueued meanwhile.
+ * Must not be called from inside a task.
+ * 
+ * @param[in] manager The task manager
+ */
+void task_manager_pause(task_manager_t* manager);
+
+/**
+ * Resumes a paused task manager, the workers
+ * continue where they have stopped
+ * 
+ * @param[in] manager The task manager
+ */
+void task_manager_resume(task_manager_t* manager);
+
 /**
  * Submits a task list to a task manager
  * 
  * Previous task list is freed automatically.
+ * Parked workers are woken up immediately.
+ * Only one task list runs at a time, so a task 
+ * of the list can't submit another one, it should
+ * enqueue the tasks or use task_manager_parallel_for().
  * 
  * @param[in] manager The task manager
  * @param[in] tasks   The task list
  * 
- * @return ST_FAIL if previous task list is still running,
- *          otherwise ST_OK
+ * @return ST_FAIL if previous task list is still running
+ *          or the task manager is shut down,
+ *         ST_ALLOC_FAIL if the tasks can't be distributed
+ *          across the workers, otherwise ST_OK
  */
 status_t task_manager_submit(task_manager_t* manager, task_list_t tasks);
 
 /**
  * Waits for a task manager to finish all tasks
  * 
+ * The calling thread is blocked until the last
+ * task of the list and every queued task
+ * returns, without polling. A worker of the task
+ * manager would wait for its own task, so inside
+ * of a task use task_future_await() instead.
+ * 
  * @param[in] manager The task manager
+ * 
+ * @return ST_FAIL if called from inside a task
+ *          of the task manager, otherwise ST_OK
  */
-void task_manager_await(task_manager_t* manager);
+status_t task_manager_await(task_manager_t* manager);
+
+/**
+ * Waits for a task manager to finish all tasks,
+ * executing them on the calling thread meanwhile
+ * 
+ * The calling thread takes tasks of the current list
+ * until it is drained, then the queued tasks, and 
+ * then sleeps until the tasks still running 
+ * on the workers return. Fails inside of a task
+ * like task_manager_await(), see task_future_await().
+ * 
+ * @param[in] manager The task manager
+ * 
+ * @return ST_FAIL if called from inside a task
+ *          of the task manager, otherwise ST_OK
+ */
+status_t task_manager_await_helping(task_manager_t* manager);
+
+/**
+ * Executes one queued task or one task of the current
+ * task list of a task manager on the calling thread
+ * 
+ * A task waiting for other tasks can call it in a loop,
+ * so that the awaited tasks make progress even if
+ * every worker is busy.
+ * 
+ * @param[in] manager The task manager
+ * 
+ * @return false if there was no task to execute, otherwise true
+ */
+bool task_manager_help(task_manager_t* manager);
+
+/**
+ * Appends a task to the normal priority queue 
+ * of a task manager
+ * 
+ * Can be called from any thread at any time, 
+ * including from inside of a task. A parked
+ * worker is woken up to execute the task.
+ * A task enqueueing to its own task manager must
+ * not spin on ST_BUSY, since every worker may be
+ * spinning with nobody left to drain the queue,
+ * it should call task_manager_help() or execute
+ * the task itself instead.
+ * 
+ * @param[in] manager The task manager
+ * @param[in] task    The task
+ * 
+ * @return ST_FAIL if the task manager is shut down,
+ *         ST_BUSY if the queue is full, otherwise ST_OK
+ */
+status_t task_manager_enqueue(task_manager_t* manager, task_t task);
+
+/**
+ * Appends a task to the queue of specified
+ * priority level of a task manager
+ * 
+ * @param[in] manager  The task manager
+ * @param[in] task     The task
+ * @param[in] priority The priority level
+ * 
+ * @return ST_BAD_ARG if the priority level is invalid,
+ *         ST_FAIL if the task manager is shut down,
+ *         ST_BUSY if the queue is full, otherwise ST_OK
+ */
+status_t task_manager_enqueue_priority(task_manager_t* manager, task_t task, task_priority_t priority);
+
+/**
+ * Returns an eventfd descriptor of a task manager,
+ * creating it on the first call
+ * 
+ * The descriptor is non-blocking and becomes readable
+ * when a task list completes, its counter holds 
+ * the number of lists completed since the last read.
+ * It is closed by task_manager_delete().
+ * 
+ * @param[in]  manager The task manager
+ * @param[out] fd      The descriptor
+ * 
+ * @return ST_FAIL if eventfd is unavailable, otherwise ST_OK
+ */
+status_t task_manager_eventfd(task_manager_t* manager, int* fd);
+
+/**
+ * Executes one function over a range of indices
+ * on a task manager and waits for it to finish
+ * 
+ * Indices are handed out in chunks of at least `grain`
+ * indices. Each worker adapts its chunk size to the
+ * measured execution time, so that a chunk takes about
+ * TASK_RANGE_CHUNK_TIME, and shrinks it near the end
+ * of the range to balance the load. No task is
+ * allocated per index.
+ * 
+ * The loop is run by queued tasks and by the calling
+ * thread, which then executes other tasks until the
+ * last chunk returns. It does not depend on the task
+ * list, so loops can run concurrently with a list and
+ * with each other, and can be nested inside of tasks.
+ * 
+ * @param[in] manager  The task manager
+ * @param[in] begin    Range start, inclusive
+ * @param[in] end      Range end, exclusive
+ * @param[in] grain    Minimal chunk size
+ * @param[in] function The range function
+ * @param[in] context  User context passed to the function
+ * 
+ * @return ST_ALLOC_FAIL if an allocation fails,
+ *          otherwise ST_OK
+ */
+status_t task_manager_parallel_for(task_manager_t* manager, size_t begin, size_t end, size_t grain, 
+    task_range_function_t function, task_input_t context);
+
+/**
+ * Returns the number of skipped tasks of the
+ * current or the last task list of a task manager
+ * 
+ * The number is final once the list is complete,
+ * for example after task_manager_await().
+ * 
+ * @param[in] manager The task manager
+ * 
+ * @return Number of cancelled tasks
+ */
+size_t task_manager_cancelled(task_manager_t* manager);
+
+/**
+ * Takes a snapshot of the statistics of every worker
+ * of a task manager
+ * 
+ * The counters are read while the workers are running, 
+ * so the snapshot of each worker is only approximately
+ * consistent.
+ * 
+ * @param[in]  manager The task manager
+ * @param[out] stats   Array of `pool.capacity` statistics,
+ *                      retired workers keep their counters
+ * 
+ * @return ST_FAIL if the library was compiled 
+ *          without `CTOOL_THREAD_STATS`, otherwise ST_OK
+ */
+status_t task_manager_stats(task_manager_t* manager, task_worker_stats_t* stats);
+
+/**
+ * Returns the number of running workers
+ * of a task manager
+ * 
+ * The size of an elastic pool changes concurrently,
+ * so the value may be outdated once returned.
+ * 
+ * @param[in] manager The task manager
+ * 
+ * @return The number of workers
+ */
+size_t task_manager_size(task_manager_t* manager);
+
+/**
+ * Returns the worker running the calling thread
+ * 
+ * Tasks can use it to find their `node` and
+ * allocate memory close to the worker.
+ * 
+ * @return The worker, or NULL if called 
+ *          outside of a worker thread
+ */
+task_worker_t* task_worker_current();
+
+/**
+ * Returns the index of the worker running
+ * the calling thread
+ * 
+ * Indices are below the `max_threads` of the
+ * task manager and are never shared by two running
+ * workers, so a task can update the slot of its worker
+ * in a sharded array without atomics. Tasks executed
+ * by an awaiting thread, see task_future_await(),
+ * are not executed by a worker.
+ * 
+ * @return The index, or TASK_WORKER_NONE if
+ *          called outside of a worker thread
+ */
+size_t task_worker_index();
+
+/**
+ * Returns the scratch buffer of the worker
+ * running the calling thread
+ * 
+ * Tasks can use it for temporary data without
+ * allocating, or for counters of the worker.
+ * 
+ * @return The buffer, or NULL if called outside of
+ *          a worker thread or if the task manager 
+ *          has no scratch buffers
+ */
+void* task_worker_scratch();
+
+/**
+ * Returns the user data pointer of the worker
+ * running the calling thread
+ * 
+ * @return The pointer, or NULL if called 
+ *          outside of a worker thread
+ */
+void* task_worker_data();
+
+/**
+ * Returns the scratch buffer of a worker slot
+ * of a task manager
+ * 
+ * Can be used to combine the data of the workers
+ * once their tasks have returned.
+ * 
+ * @param[in] manager The task manager
+ * @param[in] index   Index of the worker
+ * 
+ * @return The buffer, or NULL if the index is out
+ *          of the pool or there are no scratch buffers
+ */
+void* task_manager_scratch(task_manager_t* manager, size_t index);
+
+/**
+ * Sets the user data pointer of a worker slot
+ * of a task manager
+ * 
+ * Should be set before the tasks that read it
+ * are submitted or enqueued.
+ * 
+ * @param[in] manager The task manager
+ * @param[in] index   Index of the worker
+ * @param[in] data    The pointer
+ * 
+ * @return ST_BAD_ARG if the index is out of the pool,
+ *          otherwise ST_OK
+ */
+status_t task_manager_set_data(task_manager_t* manager, size_t index, void* data);
 
 /**
  * Initializes a task list and allocates memory for it
@@ -181,6 +706,19 @@ void task_manager_await(task_manager_t* manager);
  */
 status_t task_list_init(task_list_t* tasks, size_t size);
 
+/**
+ * Initializes a task list with a future for every task
+ * 
+ * The futures are allocated in one block with the tasks
+ * and are freed together with the task list.
+ * 
+ * @param[in] tasks The task list
+ * @param[in] size  Tasks count
+ * 
+ * @return ST_ALLOC_FAIL if an allocation fails, otherwise ST_OK
+ */
+status_t task_list_init_futures(task_list_t* tasks, size_t size);
+
 /**
  * Frees memory allocated for a task list
  * 
@@ -190,4 +728,89 @@ static inline void task_list_free(task_list_t* tasks) {
     free(tasks->data);
 }
 
+/**
+ * Initializes a cancellation token
+ * 
+ * @param[in] cancel The token
+ */
+static inline void task_cancel_init(task_cancel_t* cancel) {
+    atomic_init(&cancel->requested, false);
+}
+
+/**
+ * Requests cancellation of the task lists 
+ * sharing a token
+ * 
+ * Tasks that have already started run to the end.
+ * 
+ * @param[in] cancel The token
+ */
+static inline void task_cancel_request(task_cancel_t* cancel) {
+    atomic_store_explicit(&cancel->requested, true, memory_order_release);
+}
+
+/**
+ * Checks if cancellation of a token was requested
+ * 
+ * @param[in] cancel The token
+ */
+static inline bool task_cancel_is_requested(task_cancel_t* cancel) {
+    return atomic_load_explicit(&cancel->requested, memory_order_acquire);
+}
+
+/**
+ * Computes a task list deadline 
+ * 
+ * @param[in] timeout Time from now in nanoseconds
+ * 
+ * @return The absolute deadline
+ */
+static inline uint64_t task_deadline_after(uint64_t timeout) {
+    return _ctool_thread_time() + timeout;
+}
+
+/**
+ * Checks if the task of a future has returned
+ * 
+ * @param[in] future The future
+ */
+static inline bool task_future_is_ready(task_future_t* future) {
+    return atomic_load_explicit(&future->ready, memory_order_acquire);
+}
+
+/**
+ * Subscribes a callback to be executed once 
+ * the task of a future returns
+ * 
+ * The callback is executed by the thread completing
+ * the future, so it should only schedule work, for
+ * example resume a fiber. A future has at most one 
+ * callback at a time.
+ * 
+ * @param[in] future   The future
+ * @param[in] callback The callback task
+ * 
+ * @return false if the future is already ready or has
+ *         another callback, the callback is not 
+ *         executed then, otherwise true
+ */
+bool task_future_subscribe(task_future_t* future, task_t callback);
+
+/**
+ * Waits for the task of a future to return
+ * 
+ * Queued tasks and tasks of the current list are
+ * executed by the calling thread while the future
+ * is not ready, so a task can wait for other tasks 
+ * without blocking its worker. To wait for all 
+ * futures of a list at once, use task_manager_await() 
+ * or task_manager_await_helping() instead.
+ * 
+ * @param[in] manager The task manager running the task
+ * @param[in] future  The future
+ * 
+ * @return Output of the task
+ */
+task_output_t task_future_await(task_manager_t* manager, task_future_t* future);
+
 #endif /* CTOOL_THREAD_H */
\ No newline at end of file
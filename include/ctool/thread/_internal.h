@@ -0,0 +1,160 @@
+/**
+ * @file _internal.h
+ * @author andersonarc (e.andersonarc@gmail.com)
+ * @version 0.1
+ * @date 2021-05-17
+ *
+ *  Thread pool internal definitions
+ *
+ *  Synchronization primitives used to park and wake
+ *  worker threads, mapped either to pthreads or
+ *  to C11 threads depending on `CTOOL_THREAD_USE_POSIX`.
+ */
+    /* header guard */
+#ifndef CTOOL_THREAD__INTERNAL_H
+#define CTOOL_THREAD__INTERNAL_H
+
+    /* includes */
+#include <stdint.h> /* uint64_t */
+#include <time.h> /* clock_gettime() */
+
+#ifdef CTOOL_THREAD_USE_POSIX
+    #include <pthread.h> /* posix threads api */
+#else
+    #include <threads.h> /* C11 threads api */
+#endif
+
+    /* defines */
+/**
+ * Size of a cache line, used to keep
+ * contended atomics apart from each other
+ */
+#define CTOOL_CACHE_LINE 64
+
+    /* typedefs */
+/**
+ * Mutex type
+ */
+#ifdef CTOOL_THREAD_USE_POSIX
+    typedef pthread_mutex_t thread_mutex_t;
+#else
+    typedef mtx_t thread_mutex_t;
+#endif
+
+/**
+ * Condition variable type
+ */
+#ifdef CTOOL_THREAD_USE_POSIX
+    typedef pthread_cond_t thread_cond_t;
+#else
+    typedef cnd_t thread_cond_t;
+#endif
+
+/**
+ * One-time initialization flag type
+ */
+#ifdef CTOOL_THREAD_USE_POSIX
+    typedef pthread_once_t thread_once_t;
+    #define CTOOL_THREAD_ONCE_INIT PTHREAD_ONCE_INIT
+#else
+    typedef once_flag thread_once_t;
+    #define CTOOL_THREAD_ONCE_INIT ONCE_FLAG_INIT
+#endif
+
+/**
+ * Calls a function exactly once for a flag,
+ * other callers wait until it has returned
+ *
+ * @param[in] flag     Pointer to the flag
+ * @param[in] function Function without arguments
+ */
+#ifdef CTOOL_THREAD_USE_POSIX
+    #define _ctool_call_once(flag, function) pthread_once(flag, function)
+#else
+    #define _ctool_call_once(flag, function) call_once(flag, function)
+#endif
+
+/**
+ * Mutex operations
+ *
+ * Initialization returns 0 on success
+ *
+ * @param[in] mutex Pointer to the mutex
+ */
+#ifdef CTOOL_THREAD_USE_POSIX
+    #define _ctool_mutex_init(mutex)    pthread_mutex_init(mutex, NULL)
+    #define _ctool_mutex_destroy(mutex) pthread_mutex_destroy(mutex)
+    #define _ctool_mutex_lock(mutex)    pthread_mutex_lock(mutex)
+    #define _ctool_mutex_unlock(mutex)  pthread_mutex_unlock(mutex)
+#else
+    #define _ctool_mutex_init(mutex)    (mtx_init(mutex, mtx_plain) != thrd_success)
+    #define _ctool_mutex_destroy(mutex) mtx_destroy(mutex)
+    #define _ctool_mutex_lock(mutex)    mtx_lock(mutex)
+    #define _ctool_mutex_unlock(mutex)  mtx_unlock(mutex)
+#endif
+
+/**
+ * Condition variable operations
+ *
+ * Initialization returns 0 on success
+ *
+ * @param[in] cond  Pointer to the condition variable
+ * @param[in] mutex Pointer to the mutex locked by the caller
+ */
+#ifdef CTOOL_THREAD_USE_POSIX
+    #define _ctool_cond_init(cond)         pthread_cond_init(cond, NULL)
+    #define _ctool_cond_destroy(cond)      pthread_cond_destroy(cond)
+    #define _ctool_cond_wait(cond, mutex)  pthread_cond_wait(cond, mutex)
+    #define _ctool_cond_signal(cond)       pthread_cond_signal(cond)
+    #define _ctool_cond_broadcast(cond)    pthread_cond_broadcast(cond)
+#else
+    #define _ctool_cond_init(cond)         (cnd_init(cond) != thrd_success)
+    #define _ctool_cond_destroy(cond)      cnd_destroy(cond)
+    #define _ctool_cond_wait(cond, mutex)  cnd_wait(cond, mutex)
+    #define _ctool_cond_signal(cond)       cnd_signal(cond)
+    #define _ctool_cond_broadcast(cond)    cnd_broadcast(cond)
+#endif
+
+/**
+ * Waits on a condition variable until
+ * an absolute deadline
+ *
+ * Returns 0 if the condition was signalled,
+ * the deadline is a realtime clock value
+ * 
+ * @param[in] cond     Pointer to the condition variable
+ * @param[in] mutex    Pointer to the mutex locked by the caller
+ * @param[in] deadline Pointer to the deadline timespec
+ */
+#ifdef CTOOL_THREAD_USE_POSIX
+    #define _ctool_cond_timedwait(cond, mutex, deadline) pthread_cond_timedwait(cond, mutex, deadline)
+#else
+    #define _ctool_cond_timedwait(cond, mutex, deadline) (cnd_timedwait(cond, mutex, deadline) != thrd_success)
+#endif
+
+    /* functions */
+/**
+ * Returns the current value of the monotonic clock
+ * 
+ * @return Time in nanoseconds
+ */
+static inline uint64_t _ctool_thread_time() {
+    struct timespec time;
+    clock_gettime(CLOCK_MONOTONIC, &time);
+    return (uint64_t) time.tv_sec * 1000000000 + time.tv_nsec;
+}
+
+/**
+ * Computes a deadline for _ctool_cond_timedwait()
+ * 
+ * @param[out] deadline The deadline
+ * @param[in]  timeout  Time from now in nanoseconds
+ */
+static inline void _ctool_thread_deadline(struct timespec* deadline, uint64_t timeout) {
+    clock_gettime(CLOCK_REALTIME, deadline);
+    uint64_t nanoseconds = deadline->tv_nsec + timeout % 1000000000;
+    deadline->tv_sec += timeout / 1000000000 + nanoseconds / 1000000000;
+    deadline->tv_nsec = nanoseconds % 1000000000;
+}
+
+#endif /* CTOOL_THREAD__INTERNAL_H */
\ No newline at end of file
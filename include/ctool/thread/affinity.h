@@ -0,0 +1,106 @@
+/**
+ * @file affinity.h
+ * @author andersonarc (e.andersonarc@gmail.com)
+ * @version 0.1
+ * @date 2021-06-05
+ * 
+ *  CPU and NUMA topology for worker placement
+ * 
+ *  The NUMA nodes and their CPUs are read from
+ *  /sys/devices/system/node, limited to the CPUs
+ *  the process is allowed to run on. Without NUMA
+ *  information, all allowed CPUs form a single node.
+ */
+    /* header guard */
+#ifndef CTOOL_THREAD_AFFINITY_H
+#define CTOOL_THREAD_AFFINITY_H
+
+    /* includes */
+#include <stddef.h> /* size_t */
+#include "ctool/status.h" /* return status */
+
+    /* typedefs */
+/**
+ * Worker placement mode
+ * 
+ * Compact placement fills the CPUs of one node
+ * before moving to the next one, so that workers
+ * share caches and memory. Spread placement assigns
+ * workers to the nodes in turn, to use the memory
+ * bandwidth of every node.
+ */
+typedef enum task_affinity_t {
+    CTOOL_TASK_AFFINITY_NONE, CTOOL_TASK_AFFINITY_COMPACT, CTOOL_TASK_AFFINITY_SPREAD
+} task_affinity_t;
+
+/**
+ * NUMA node structure
+ */
+typedef struct task_topology_node_t {
+    int id;
+    size_t size;
+    int* cpus;
+} task_topology_node_t;
+
+/**
+ * CPU topology structure
+ * 
+ * Only nodes with at least one allowed CPU are listed.
+ */
+typedef struct task_topology_t {
+    size_t size;
+    task_topology_node_t* nodes;
+} task_topology_t;
+
+    /* functions */
+/**
+ * Reads the CPU topology of the system
+ * 
+ * @param[in] topology The topology
+ * 
+ * @return ST_ALLOC_FAIL if an allocation fails,
+ *         ST_FAIL if the allowed CPUs can't be read,
+ *          otherwise ST_OK
+ */
+status_t task_topology_init(task_topology_t* topology);
+
+/**
+ * Frees memory allocated for a topology
+ * 
+ * @param[in] topology The topology
+ */
+void task_topology_free(task_topology_t* topology);
+
+/**
+ * Selects a CPU and a node for a worker
+ * 
+ * Workers beyond the number of CPUs wrap around.
+ * 
+ * @param[in]  topology The topology
+ * @param[in]  affinity Placement mode
+ * @param[in]  index    Index of the worker
+ * @param[out] cpu      The CPU, -1 if not pinned
+ * @param[out] node     The node, -1 if not pinned
+ */
+void task_topology_place(task_topology_t* topology, task_affinity_t affinity, size_t index, int* cpu, int* node);
+
+/**
+ * Pins the calling thread to a CPU
+ * 
+ * @param[in] cpu The CPU
+ * 
+ * @return ST_FAIL if the thread can't be pinned, otherwise ST_OK
+ */
+status_t task_affinity_pin(int cpu);
+
+/**
+ * Counts the CPUs the calling thread is allowed to run on
+ * 
+ * Falls back to the number of online CPUs
+ * if the affinity mask can't be read.
+ * 
+ * @return The number of CPUs, at least 1
+ */
+size_t task_affinity_cpus();
+
+#endif /* CTOOL_THREAD_AFFINITY_H */
\ No newline at end of file
@@ -0,0 +1,142 @@
+/**
+ * @file dag.h
+ * @author andersonarc (e.andersonarc@gmail.com)
+ * @version 0.1
+ * @date 2021-06-07
+ * 
+ *  Task dependency graph execution
+ * 
+ *  Every node of a graph holds a task and an atomic
+ *  counter of its unfinished predecessors. When a task
+ *  returns, the counters of its successors are decremented,
+ *  and the successors that reach zero become runnable
+ *  immediately, without a barrier between stages.
+ */
+    /* header guard */
+#ifndef CTOOL_THREAD_DAG_H
+#define CTOOL_THREAD_DAG_H
+
+    /* includes */
+#include <stdatomic.h> /* atomic types */
+#include <stdbool.h> /* boolean */
+#include <stddef.h> /* size_t */
+#include "ctool/status.h" /* return status */
+#include "ctool/thread.h" /* task manager */
+
+    /* typedefs */
+/**
+ * Task graph node structure
+ * 
+ * `successors` holds the indices of the nodes that
+ * depend on this one, `degree` is the number of its
+ * predecessors, and `pending` counts the predecessors
+ * that haven't returned yet while the graph is running.
+ */
+typedef struct task_dag_node_t {
+    task_t task;
+    atomic_size_t pending;
+    size_t degree;
+    size_t size;
+    size_t capacity;
+    size_t* successors;
+    struct task_dag_t* dag;
+    struct task_dag_node_t* next;
+} task_dag_node_t;
+
+/**
+ * Task graph structure
+ * 
+ * Nodes are counted in `remaining` until they return,
+ * completion of the graph is broadcasted through
+ * the `finished` condition.
+ */
+typedef struct task_dag_t {
+    size_t size;
+    size_t capacity;
+    task_dag_node_t* nodes;
+    task_manager_t* manager;
+    atomic_size_t remaining;
+    bool running;
+    thread_mutex_t lock;
+    thread_cond_t finished;
+} task_dag_t;
+
+    /* functions */
+/**
+ * Initializes an empty task graph
+ * 
+ * @param[in] dag      The graph
+ * @param[in] capacity Number of nodes to preallocate
+ * 
+ * @return ST_ALLOC_FAIL if an allocation fails,
+ *         ST_FAIL if synchronization primitives
+ *          can't be initialized, otherwise ST_OK
+ */
+status_t task_dag_init(task_dag_t* dag, size_t capacity);
+
+/**
+ * Frees memory allocated for a task graph
+ * 
+ * @param[in] dag The graph
+ */
+void task_dag_free(task_dag_t* dag);
+
+/**
+ * Appends a task to a task graph
+ * 
+ * @param[in]  dag  The graph
+ * @param[in]  task The task
+ * @param[out] node Index of the new node, may be NULL
+ * 
+ * @return ST_FAIL if the graph is running,
+ *         ST_ALLOC_FAIL if an allocation fails,
+ *          otherwise ST_OK
+ */
+status_t task_dag_add(task_dag_t* dag, task_t task, size_t* node);
+
+/**
+ * Makes a node of a task graph depend on another one,
+ * so that it is executed after the predecessor returns
+ * 
+ * @param[in] dag         The graph
+ * @param[in] node        Index of the dependent node
+ * @param[in] predecessor Index of the predecessor
+ * 
+ * @return ST_BAD_ARG if an index is out of bounds
+ *          or both indices are equal,
+ *         ST_FAIL if the graph is running,
+ *         ST_ALLOC_FAIL if an allocation fails,
+ *          otherwise ST_OK
+ */
+status_t task_dag_depend(task_dag_t* dag, size_t node, size_t predecessor);
+
+/**
+ * Starts the execution of a task graph on a task manager
+ * 
+ * The nodes without predecessors are enqueued immediately,
+ * and every other node is enqueued by the last of its
+ * predecessors. One of the successors is executed
+ * by the same worker without enqueueing it. If the queue
+ * of the manager is full, the calling thread executes
+ * the remaining nodes itself.
+ * 
+ * @param[in] manager The task manager
+ * @param[in] dag     The graph
+ * 
+ * @return ST_BAD_ARG if the graph has a cycle,
+ *         ST_FAIL if the graph is already running,
+ *          otherwise ST_OK
+ */
+status_t task_dag_run(task_manager_t* manager, task_dag_t* dag);
+
+/**
+ * Waits for every node of a running task graph to return
+ * 
+ * Once it returns, the graph can be modified 
+ * and run again.
+ * 
+ * @param[in] dag The graph
+ */
+void task_dag_await(task_dag_t* dag);
+
+#endif /* CTOOL_THREAD_DAG_H */
\ No newline at end of file
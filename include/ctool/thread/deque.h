@@ -0,0 +1,118 @@
+/**
+ * @file deque.h
+ * @author andersonarc (e.andersonarc@gmail.com)
+ * @version 0.1
+ * @date 2021-05-17
+ * 
+ *  Chase-Lev work-stealing deque of tasks
+ * 
+ *  The owner thread pushes and pops tasks at the bottom
+ *  of the deque without contention, while other threads
+ *  steal tasks from the top. The implementation follows
+ *  "Correct and Efficient Work-Stealing for Weak Memory Models"
+ *  by Le, Pop, Cohen and Zappa Nardelli (2013).
+ */
+    /* header guard */
+#ifndef CTOOL_THREAD_DEQUE_H
+#define CTOOL_THREAD_DEQUE_H
+
+    /* includes */
+#include <stdatomic.h> /* atomic types */
+#include <stdbool.h> /* boolean */
+#include <stddef.h> /* size_t, ptrdiff_t */
+#include "ctool/status.h" /* return status */
+#include "ctool/thread/task.h" /* task type */
+
+    /* defines */
+/**
+ * Default capacity of a deque, must be a power of two
+ */
+#define TASK_DEQUE_DEFAULT_SIZE 64
+
+    /* typedefs */
+/**
+ * Circular array of a deque
+ * 
+ * Arrays replaced while growing are kept in
+ * the `previous` chain until the deque is freed,
+ * because thieves may still be reading them.
+ */
+typedef struct task_deque_array_t {
+    size_t size;
+    struct task_deque_array_t* previous;
+    _Atomic(task_t*) data[];
+} task_deque_array_t;
+
+/**
+ * Work-stealing deque structure
+ */
+typedef struct task_deque_t {
+    atomic_ptrdiff_t top;
+    atomic_ptrdiff_t bottom;
+    _Atomic(task_deque_array_t*) array;
+} task_deque_t;
+
+    /* functions */
+/**
+ * Initializes an empty deque
+ * 
+ * @param[in] deque The deque
+ * @param[in] size  Initial capacity, a power of two
+ * 
+ * @return ST_ALLOC_FAIL if an allocation fails, otherwise ST_OK
+ */
+status_t task_deque_init(task_deque_t* deque, size_t size);
+
+/**
+ * Frees memory allocated for a deque
+ * 
+ * @param[in] deque The deque
+ */
+void task_deque_free(task_deque_t* deque);
+
+/**
+ * Pushes a task to the bottom of a deque,
+ * growing it if required
+ * 
+ * @note Only the owner of the deque may call this function
+ * 
+ * @param[in] deque The deque
+ * @param[in] task  The task
+ * 
+ * @return ST_ALLOC_FAIL if an allocation fails, otherwise ST_OK
+ */
+status_t task_deque_push(task_deque_t* deque, task_t* task);
+
+/**
+ * Pops a task from the bottom of a deque
+ * 
+ * @note Only the owner of the deque may call this function
+ * 
+ * @param[in] deque The deque
+ * 
+ * @return The task or NULL if the deque is empty
+ */
+task_t* task_deque_pop(task_deque_t* deque);
+
+/**
+ * Steals a task from the top of a deque
+ * 
+ * Can be called by any thread. If another thread
+ * takes the same task first, stealing is retried.
+ * 
+ * @param[in] deque The deque
+ * 
+ * @return The task or NULL if the deque is empty
+ */
+task_t* task_deque_steal(task_deque_t* deque);
+
+/**
+ * Checks if a deque is empty
+ * 
+ * @param[in] deque The deque
+ */
+static inline bool task_deque_is_empty(task_deque_t* deque) {
+    return atomic_load(&deque->bottom) <= atomic_load(&deque->top);
+}
+
+#endif /* CTOOL_THREAD_DEQUE_H */
\ No newline at end of file
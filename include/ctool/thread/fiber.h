@@ -0,0 +1,195 @@
+/**
+ * @file fiber.h
+ * @author andersonarc (e.andersonarc@gmail.com)
+ * @version 0.1
+ * @date 2021-06-10
+ * 
+ *  Stackful fibers on top of a task manager
+ * 
+ *  A fiber runs a task on its own small stack, and can
+ *  suspend itself to wait for a file descriptor or for
+ *  another task without blocking the worker thread, which
+ *  executes other tasks meanwhile. Suspended fibers are
+ *  resumed by enqueueing them to the task manager again,
+ *  so thousands of fibers are multiplexed over the few
+ *  threads of the pool. Fibers and their stacks are
+ *  reused after they finish.
+ */
+    /* header guard */
+#ifndef CTOOL_THREAD_FIBER_H
+#define CTOOL_THREAD_FIBER_H
+
+    /* includes */
+#include <stdint.h> /* uint32_t */
+#include <ucontext.h> /* execution contexts */
+#include "ctool/status.h" /* return status */
+#include "ctool/thread.h" /* task manager */
+
+    /* defines */
+/**
+ * Default stack size of a fiber in bytes
+ */
+#define TASK_FIBER_DEFAULT_STACK (64 * 1024)
+
+    /* typedefs */
+/**
+ * Fiber state
+ * 
+ * A fiber that leaves its stack tells the worker
+ * why: to be enqueued again, to wait for a file
+ * descriptor or a future, or because its task 
+ * has returned.
+ */
+typedef enum task_fiber_state_t {
+    CTOOL_TASK_FIBER_RUNNING, CTOOL_TASK_FIBER_YIELDED, 
+    CTOOL_TASK_FIBER_WAITING, CTOOL_TASK_FIBER_AWAITING,
+    CTOOL_TASK_FIBER_FINISHED
+} task_fiber_state_t;
+
+/**
+ * Fiber structure
+ * 
+ * `scheduler` is the context of the worker that
+ * resumed the fiber last, the fiber switches back
+ * to it when it leaves its stack. `next` links the
+ * fiber in the free list of its pool, or in the
+ * waiters of its file descriptor.
+ */
+typedef struct task_fiber_t {
+    ucontext_t context;
+    ucontext_t* scheduler;
+    struct task_fiber_pool_t* pool;
+    task_t task;
+    task_fiber_state_t state;
+    status_t status;
+    int fd;
+    uint32_t events;
+    task_future_t* future;
+    void* stack;
+    struct task_fiber_t* next;
+} task_fiber_t;
+
+/**
+ * Fiber pool structure
+ * 
+ * Finished fibers are kept in the `free` list.
+ * Fibers that haven't finished yet are counted in
+ * `active`. Fibers waiting for file descriptors are
+ * registered in the `epoll` instance, which is watched
+ * by the `poller` thread. `waiters` is indexed by the
+ * descriptor and lists the fibers waiting for it, 
+ * so several fibers can wait for the same descriptor.
+ */
+typedef struct task_fiber_pool_t {
+    task_manager_t* manager;
+    size_t stack_size;
+    task_fiber_t* free;
+    size_t active;
+    task_fiber_t** waiters;
+    size_t waiters_size;
+    thread_mutex_t lock;
+    thread_cond_t finished;
+    int epoll;
+    int wakeup;
+    thread_t poller;
+} task_fiber_pool_t;
+
+    /* functions */
+/**
+ * Creates a fiber pool on a task manager
+ * and starts its poller thread
+ * 
+ * @param[in] pool       The fiber pool
+ * @param[in] manager    The task manager
+ * @param[in] stack_size Stack size of a fiber in bytes,
+ *                       0 selects the default
+ * 
+ * @return ST_FAIL if the poller can't be started,
+ *          otherwise ST_OK
+ */
+status_t task_fiber_pool_create(task_fiber_pool_t* pool, task_manager_t* manager, size_t stack_size);
+
+/**
+ * Deletes a fiber pool
+ * 
+ * The fibers must have finished, 
+ * see task_fiber_pool_await().
+ * 
+ * @param[in] pool The fiber pool
+ */
+void task_fiber_pool_delete(task_fiber_pool_t* pool);
+
+/**
+ * Waits for every fiber of a pool to finish
+ * 
+ * Unlike task_manager_await(), also waits for 
+ * the fibers suspended on file descriptors.
+ * 
+ * @param[in] pool The fiber pool
+ */
+void task_fiber_pool_await(task_fiber_pool_t* pool);
+
+/**
+ * Runs a task in a new fiber
+ * 
+ * @param[in] pool The fiber pool
+ * @param[in] task The task
+ * 
+ * @return ST_ALLOC_FAIL if a fiber can't be allocated,
+ *         ST_FAIL if the task manager is shut down,
+ *         ST_BUSY if the queue of the task manager is full,
+ *          otherwise ST_OK
+ */
+status_t task_fiber_spawn(task_fiber_pool_t* pool, task_t task);
+
+/**
+ * Returns the fiber running the calling code
+ * 
+ * @return The fiber, or NULL outside of a fiber
+ */
+task_fiber_t* task_fiber_current();
+
+/**
+ * Suspends the current fiber and enqueues it again, 
+ * so other tasks can run
+ * 
+ * Does nothing outside of a fiber.
+ */
+void task_fiber_yield();
+
+/**
+ * Suspends the current fiber until a file descriptor
+ * is ready, for example before stream_read() 
+ * 
+ * Several fibers can wait for the same descriptor,
+ * each of them is resumed once one of its events
+ * is ready. Outside of a fiber, blocks the thread instead.
+ * 
+ * @param[in] fd     The file descriptor
+ * @param[in] events Epoll events to wait for,
+ *                   such as EPOLLIN or EPOLLOUT
+ * 
+ * @return ST_ALLOC_FAIL if the waiters can't be stored,
+ *         ST_FAIL if the descriptor can't be watched,
+ *          otherwise ST_OK
+ */
+status_t task_fiber_await_fd(int fd, uint32_t events);
+
+/**
+ * Waits for the task of a future to return, suspending
+ * the current fiber until it is ready
+ * 
+ * The fiber is subscribed to the future and resumed
+ * by the thread that completes it. If another fiber
+ * is already subscribed, the fiber yields until the
+ * future is ready instead.
+ * Outside of a fiber, calls task_future_await().
+ * 
+ * @param[in] manager The task manager running the task
+ * @param[in] future  The future
+ * 
+ * @return Output of the task
+ */
+task_output_t task_fiber_await_future(task_manager_t* manager, task_future_t* future);
+
+#endif /* CTOOL_THREAD_FIBER_H */
\ No newline at end of file
@@ -0,0 +1,44 @@
+/**
+ * @file global.h
+ * @author andersonarc (e.andersonarc@gmail.com)
+ * @version 0.1
+ * @date 2021-06-15
+ *
+ *  Process-wide shared task manager
+ *
+ *  Modules that need a thread pool can share a single
+ *  task manager instead of creating their own, so the
+ *  process keeps one worker per allowed CPU.
+ */
+    /* header guard */
+#ifndef CTOOL_THREAD_GLOBAL_H
+#define CTOOL_THREAD_GLOBAL_H
+
+    /* includes */
+#include "ctool/thread.h" /* task manager */
+
+    /* functions */
+/**
+ * Returns the process-wide task manager,
+ * creating it on the first call
+ * 
+ * The task manager has one worker per CPU the
+ * first caller is allowed to run on. Any thread can 
+ * call it, concurrent first calls create a single
+ * task manager. At exit, the task manager finishes
+ * its tasks and is deleted, unless exit is called
+ * from one of its workers. It must not be deleted
+ * by its users.
+ * 
+ * Only one task list can run at a time, so modules
+ * sharing the task manager should enqueue tasks or
+ * use task_manager_parallel_for() and the parallel
+ * operations, which run on the queues and complete
+ * on their own. task_manager_await() waits for the
+ * queued tasks of every module.
+ * 
+ * @return The task manager, or NULL if it can't be created
+ */
+task_manager_t* task_manager_global();
+
+#endif /* CTOOL_THREAD_GLOBAL_H */
\ No newline at end of file
@@ -0,0 +1,378 @@
+/**
+ * @file parallel.h
+ * @author andersonarc (e.andersonarc@gmail.com)
+ * @version 0.1
+ * @date 2021-06-09
+ * 
+ *  Generic parallel reduction and prefix scan
+ * 
+ *  The array is split into one contiguous block per worker
+ *  of a task manager. A reduction combines the partial
+ *  results of the blocks, and a scan reduces the blocks
+ *  first, scans the partial results, and then scans every
+ *  block again starting from its offset. The blocks are
+ *  executed as a parallel loop, see task_manager_parallel_for().
+ * 
+ *  The operator must be associative, and the identity must
+ *  be its neutral element. Floating point operators are not 
+ *  exactly associative, so their results might differ
+ *  slightly from a sequential loop.
+ */
+    /* header guard */
+#ifndef CTOOL_THREAD_PARALLEL_H
+#define CTOOL_THREAD_PARALLEL_H
+
+    /* includes */
+#include <stdlib.h> /* memory allocation */
+#include "ctool/status.h" /* return status */
+#include "ctool/assert/runtime.h" /* runtime assertions */
+#include "ctool/iteration.h" /* range iteration */
+#include "ctool/type/_internal.h" /* generic names */
+#include "ctool/thread.h" /* task manager */
+
+    /* defines */
+/**
+ * Minimal number of elements in a block, 
+ * smaller arrays are processed by the calling thread
+ */
+#define PARALLEL_MIN_BLOCK 4096
+
+/**
+ * Generates a generic name for
+ * a parallel operation of specified name
+ * 
+ * @param[in] name Name of the operation
+ */
+#define parallel_block(name)          _ctool_generic_type(parallel_block, name)
+#define parallel_run(name)            _ctool_generic_type(parallel_run, name)
+#define parallel_reduce(name)         _ctool_generic_function(parallel, name, reduce)
+#define parallel_scan_inclusive(name) _ctool_generic_function(parallel, name, scan_inclusive)
+#define parallel_scan_exclusive(name) _ctool_generic_function(parallel, name, scan_exclusive)
+
+/**
+ * Runs a parallel operation over an arraylist or a list
+ * 
+ * @param[in] name    Name of the operation
+ * @param[in] manager The task manager
+ * @param[in] list    Pointer to the arraylist or list
+ * @param[in] result  Pointer to the result or the output array
+ */
+#define parallel_reduce_list(name, manager, list, result) \
+    parallel_reduce(name)(manager, (list)->data, (list)->size, result)
+#define parallel_scan_inclusive_list(name, manager, list, result) \
+    parallel_scan_inclusive(name)(manager, (list)->data, (list)->size, result)
+#define parallel_scan_exclusive_list(name, manager, list, result) \
+    parallel_scan_exclusive(name)(manager, (list)->data, (list)->size, result)
+
+/**
+ * Declares parallel operations of specified name
+ * 
+ * @note The declaration should be placed in a header file
+ * 
+ * @param[in] name Name of the operations
+ * @param[in] type Type of the elements
+**/
+#define parallel_declare(name, type)                                                                                  \
+/**                                                                                                                   \
+ * Combines all elements of an array                                                                                  \
+ *                                                                                                                    \
+ * @param[in]  manager The task manager                                                                               \
+ * @param[in]  data    The array                                                                                      \
+ * @param[in]  size    Number of elements                                                                             \
+ * @param[out] result  The result, identity if empty                                                                  \
+ *                                                                                                                    \
+ * @return ST_ALLOC_FAIL if an allocation fails,                                                                      \
+ *          otherwise ST_OK                                                                                           \
+ */                                                                                                                   \
+status_t parallel_reduce(name)(task_manager_t* manager, const type* data, size_t size, type* result);                 \
+                                                                                                                      \
+/**                                                                                                                   \
+ * Writes the combination of every element with                                                                       \
+ * all of the preceding elements into an output array,                                                                \
+ * which may be the same as the input array                                                                           \
+ *                                                                                                                    \
+ * @param[in]  manager The task manager                                                                               \
+ * @param[in]  data    The array                                                                                      \
+ * @param[in]  size    Number of elements                                                                             \
+ * @param[out] output  The output array                                                                               \
+ *                                                                                                                    \
+ * @return ST_ALLOC_FAIL if an allocation fails,                                                                      \
+ *          otherwise ST_OK                                                                                           \
+ */                                                                                                                   \
+status_t parallel_scan_inclusive(name)(task_manager_t* manager, const type* data, size_t size, type* output);         \
+                                                                                                                      \
+/**                                                                                                                   \
+ * Writes the combination of all elements preceding                                                                   \
+ * every element into an output array, which may be                                                                   \
+ * the same as the input array                                                                                        \
+ *                                                                                                                    \
+ * @param[in]  manager The task manager                                                                               \
+ * @param[in]  data    The array                                                                                      \
+ * @param[in]  size    Number of elements                                                                             \
+ * @param[out] output  The output array                                                                               \
+ *                                                                                                                    \
+ * @return ST_ALLOC_FAIL if an allocation fails,                                                                      \
+ *          otherwise ST_OK                                                                                           \
+ */                                                                                                                   \
+status_t parallel_scan_exclusive(name)(task_manager_t* manager, const type* data, size_t size, type* output);
+
+/**
+ * Defines parallel operations of specified name
+ * 
+ * @note The definition should be placed in a source file
+ * 
+ * @param[in] name     Name of the operations
+ * @param[in] type     Type of the elements
+ * @param[in] operator Associative function or macro 
+ *                     combining two elements
+ * @param[in] identity Neutral element of the operator
+**/
+#define parallel_define(name, type, operator, identity)                                                               \
+/**                                                                                                                   \
+ * Block of an array processed by a worker                                                                            \
+ */                                                                                                                   \
+typedef struct parallel_block(name) {                                                                                 \
+    const type* data;                                                                                                 \
+    type* output;                                                                                                     \
+    size_t size;                                                                                                      \
+    type value;                                                                                                       \
+} parallel_block(name);                                                                                               \
+                                                                                                                      \
+/**                                                                                                                   \
+ * Block function executed on a range of blocks                                                                       \
+ */                                                                                                                   \
+typedef struct parallel_run(name) {                                                                                   \
+    parallel_block(name)* blocks;                                                                                     \
+    task_function_t function;                                                                                         \
+} parallel_run(name);                                                                                                 \
+                                                                                                                      \
+/**                                                                                                                   \
+ * Combines the elements of a block into its value                                                                    \
+ *                                                                                                                    \
+ * @param[in] input The block                                                                                         \
+ *                                                                                                                    \
+ * @return Default task output                                                                                        \
+ */                                                                                                                   \
+static task_output_t _ctool_generic_function(parallel, name, reduce_block)(task_input_t input) {                      \
+    parallel_block(name)* block = input;                                                                              \
+    type value = identity;                                                                                            \
+    iterate_array(i, block->size) {                                                                                   \
+        value = operator(value, block->data[i]);                                                                      \
+    }                                                                                                                 \
+    block->value = value;                                                                                             \
+    return task_output_default;                                                                                       \
+}                                                                                                                     \
+                                                                                                                      \
+/**                                                                                                                   \
+ * Scans a block inclusively, starting from its value                                                                 \
+ *                                                                                                                    \
+ * @param[in] input The block                                                                                         \
+ *                                                                                                                    \
+ * @return Default task output                                                                                        \
+ */                                                                                                                   \
+static task_output_t _ctool_generic_function(parallel, name, inclusive_block)(task_input_t input) {                   \
+    parallel_block(name)* block = input;                                                                              \
+    type value = block->value;                                                                                        \
+    iterate_array(i, block->size) {                                                                                   \
+        value = operator(value, block->data[i]);                                                                      \
+        block->output[i] = value;                                                                                     \
+    }                                                                                                                 \
+    return task_output_default;                                                                                       \
+}                                                                                                                     \
+                                                                                                                      \
+/**                                                                                                                   \
+ * Scans a block exclusively, starting from its value                                                                 \
+ *                                                                                                                    \
+ * @param[in] input The block                                                                                         \
+ *                                                                                                                    \
+ * @return Default task output                                                                                        \
+ */                                                                                                                   \
+static task_output_t _ctool_generic_function(parallel, name, exclusive_block)(task_input_t input) {                   \
+    parallel_block(name)* block = input;                                                                              \
+    type value = block->value;                                                                                        \
+    iterate_array(i, block->size) {                                                                                   \
+        type element = block->data[i];                                                                                \
+        block->output[i] = value;                                                                                     \
+        value = operator(value, element);                                                                             \
+    }                                                                                                                 \
+    return task_output_default;                                                                                       \
+}                                                                                                                     \
+                                                                                                                      \
+/**                                                                                                                   \
+ * Executes a block function on the blocks                                                                            \
+ * from begin (inclusive) to end (exclusive)                                                                          \
+ *                                                                                                                    \
+ * @param[in] begin Index of the first block                                                                          \
+ * @param[in] end   Index after the last block                                                                        \
+ * @param[in] input The blocks and the function                                                                       \
+ */                                                                                                                   \
+static void _ctool_generic_function(parallel, name, run_range)(size_t begin, size_t end, task_input_t input) {        \
+    parallel_run(name)* run = input;                                                                                  \
+    iterate_range_single(i, begin, end) {                                                                             \
+        run->function(&run->blocks[i]);                                                                               \
+    }                                                                                                                 \
+}                                                                                                                     \
+                                                                                                                      \
+/**                                                                                                                   \
+ * Executes a block function on every block                                                                           \
+ * as a parallel loop of a task manager                                                                               \
+ *                                                                                                                    \
+ * The calling thread executes blocks as well and waits                                                               \
+ * only for its own blocks, so operations can run at the                                                              \
+ * same time as a task list and from inside of tasks.                                                                 \
+ *                                                                                                                    \
+ * @param[in] manager  The task manager                                                                               \
+ * @param[in] blocks   The blocks                                                                                     \
+ * @param[in] count    Number of blocks                                                                               \
+ * @param[in] function The block function                                                                             \
+ *                                                                                                                    \
+ * @return ST_ALLOC_FAIL if an allocation fails,                                                                      \
+ *          otherwise ST_OK                                                                                           \
+ */                                                                                                                   \
+static status_t _ctool_generic_function(parallel, name, run)(task_manager_t* manager,                                 \
+        parallel_block(name)* blocks, size_t count, task_function_t function) {                                       \
+    parallel_run(name) run = { .blocks = blocks, .function = function };                                              \
+    return task_manager_parallel_for(manager, 0, count, 1,                                                            \
+        _ctool_generic_function(parallel, name, run_range), &run);                                                    \
+}                                                                                                                     \
+                                                                                                                      \
+/**                                                                                                                   \
+ * Splits an array into one block per worker                                                                          \
+ *                                                                                                                    \
+ * @param[in]  manager The task manager                                                                               \
+ * @param[in]  data    The array                                                                                      \
+ * @param[in]  output  The output array                                                                               \
+ * @param[in]  size    Number of elements                                                                             \
+ * @param[out] count   Number of blocks                                                                               \
+ *                                                                                                                    \
+ * @return The blocks or NULL if an allocation fails                                                                  \
+ */                                                                                                                   \
+static parallel_block(name)* _ctool_generic_function(parallel, name, split)(task_manager_t* manager,                  \
+        const type* data, type* output, size_t size, size_t* count) {                                                 \
+    *count = size / PARALLEL_MIN_BLOCK;                                                                               \
+    if (*count > manager->pool.size) {                                                                                \
+        *count = manager->pool.size;                                                                                  \
+    }                                                                                                                 \
+    if (*count == 0) {                                                                                                \
+        *count = 1;                                                                                                   \
+    }                                                                                                                 \
+    parallel_block(name)* blocks = malloc(sizeof(parallel_block(name)) * *count);                                     \
+    if (blocks == NULL) {                                                                                             \
+        loge("failed to allocate %zu blocks for a parallel " macro_stringify(name), *count);                          \
+        return NULL;                                                                                                  \
+    }                                                                                                                 \
+    iterate_array(i, *count) {                                                                                        \
+        size_t start = size * i / *count;                                                                             \
+        blocks[i].data = &data[start];                                                                                \
+        blocks[i].output = output != NULL ? &output[start] : NULL;                                                    \
+        blocks[i].size = size * (i + 1) / *count - start;                                                             \
+        blocks[i].value = identity;                                                                                   \
+    }                                                                                                                 \
+    return blocks;                                                                                                    \
+}                                                                                                                     \
+                                                                                                                      \
+/**                                                                                                                   \
+ * Combines all elements of an array                                                                                  \
+ *                                                                                                                    \
+ * @param[in]  manager The task manager                                                                               \
+ * @param[in]  data    The array                                                                                      \
+ * @param[in]  size    Number of elements                                                                             \
+ * @param[out] result  The result, identity if empty                                                                  \
+ *                                                                                                                    \
+ * @return ST_ALLOC_FAIL if an allocation fails,                                                                      \
+ *          otherwise ST_OK                                                                                           \
+ */                                                                                                                   \
+status_t parallel_reduce(name)(task_manager_t* manager, const type* data, size_t size, type* result) {                \
+    size_t count;                                                                                                     \
+    parallel_block(name)* blocks = _ctool_generic_function(parallel, name, split)(manager, data, NULL, size, &count); \
+    assertr_not_null(blocks, ST_ALLOC_FAIL);                                                                          \
+    status_t status = _ctool_generic_function(parallel, name, run)(manager, blocks, count,                            \
+        _ctool_generic_function(parallel, name, reduce_block));                                                       \
+    if (status == ST_OK) {                                                                                            \
+        /* combine the partial results */                                                                             \
+        type value = identity;                                                                                        \
+        iterate_array(i, count) {                                                                                     \
+            value = operator(value, blocks[i].value);                                                                 \
+        }                                                                                                             \
+        *result = value;                                                                                              \
+    }                                                                                                                 \
+    free(blocks);                                                                                                     \
+    return status;                                                                                                    \
+}                                                                                                                     \
+                                                                                                                      \
+/**                                                                                                                   \
+ * Scans an array in two passes, reducing the blocks                                                                  \
+ * first and then scanning every block from its offset                                                                \
+ *                                                                                                                    \
+ * @param[in] manager  The task manager                                                                               \
+ * @param[in] data     The array                                                                                      \
+ * @param[in] size     Number of elements                                                                             \
+ * @param[in] output   The output array                                                                               \
+ * @param[in] function The block scan function                                                                        \
+ *                                                                                                                    \
+ * @return ST_ALLOC_FAIL if an allocation fails,                                                                      \
+ *          otherwise ST_OK                                                                                           \
+ */                                                                                                                   \
+static status_t _ctool_generic_function(parallel, name, scan)(task_manager_t* manager,                                \
+        const type* data, size_t size, type* output, task_function_t function) {                                      \
+    size_t count;                                                                                                     \
+    parallel_block(name)* blocks = _ctool_generic_function(parallel, name, split)(manager, data, output, size,        \
+        &count);                                                                                                      \
+    assertr_not_null(blocks, ST_ALLOC_FAIL);                                                                          \
+    status_t status = ST_OK;                                                                                          \
+    if (count > 1) {                                                                                                  \
+        status = _ctool_generic_function(parallel, name, run)(manager, blocks, count - 1,                             \
+            _ctool_generic_function(parallel, name, reduce_block));                                                   \
+                                                                                                                      \
+        /* scan the partial results into the block offsets */                                                         \
+        type offset = identity;                                                                                       \
+        iterate_array(i, count) {                                                                                     \
+            type value = blocks[i].value;                                                                             \
+            blocks[i].value = offset;                                                                                 \
+            offset = operator(offset, value);                                                                         \
+        }                                                                                                             \
+    }                                                                                                                 \
+    if (status == ST_OK) {                                                                                            \
+        status = _ctool_generic_function(parallel, name, run)(manager, blocks, count, function);                      \
+    }                                                                                                                 \
+    free(blocks);                                                                                                     \
+    return status;                                                                                                    \
+}                                                                                                                     \
+                                                                                                                      \
+/**                                                                                                                   \
+ * Writes the combination of every element with                                                                       \
+ * all of the preceding elements into an output array,                                                                \
+ * which may be the same as the input array                                                                           \
+ *                                                                                                                    \
+ * @param[in]  manager The task manager                                                                               \
+ * @param[in]  data    The array                                                                                      \
+ * @param[in]  size    Number of elements                                                                             \
+ * @param[out] output  The output array                                                                               \
+ *                                                                                                                    \
+ * @return ST_ALLOC_FAIL if an allocation fails,                                                                      \
+ *          otherwise ST_OK                                                                                           \
+ */                                                                                                                   \
+status_t parallel_scan_inclusive(name)(task_manager_t* manager, const type* data, size_t size, type* output) {        \
+    return _ctool_generic_function(parallel, name, scan)(manager, data, size, output,                                 \
+        _ctool_generic_function(parallel, name, inclusive_block));                                                    \
+}                                                                                                                     \
+                                                                                                                      \
+/**                                                                                                                   \
+ * Writes the combination of all elements preceding                                                                   \
+ * every element into an output array, which may be                                                                   \
+ * the same as the input array                                                                                        \
+ *                                                                                                                    \
+ * @param[in]  manager The task manager                                                                               \
+ * @param[in]  data    The array                                                                                      \
+ * @param[in]  size    Number of elements                                                                             \
+ * @param[out] output  The output array                                                                               \
+ *                                                                                                                    \
+ * @return ST_ALLOC_FAIL if an allocation fails,                                                                      \
+ *          otherwise ST_OK                                                                                           \
+ */                                                                                                                   \
+status_t parallel_scan_exclusive(name)(task_manager_t* manager, const type* data, size_t size, type* output) {        \
+    return _ctool_generic_function(parallel, name, scan)(manager, data, size, output,                                 \
+        _ctool_generic_function(parallel, name, exclusive_block));                                                    \
+}
+
+#endif /* CTOOL_THREAD_PARALLEL_H */
\ No newline at end of file
@@ -0,0 +1,162 @@
+/**
+ * @file pipeline.h
+ * @author andersonarc (e.andersonarc@gmail.com)
+ * @version 0.1
+ * @date 2021-06-13
+ *
+ *  Bounded multi-stage pipeline on a task manager
+ *
+ *  Items pass through a chain of stages, every stage is
+ *  a task function that receives an item and returns the
+ *  item for the next stage. Stages are connected by bounded
+ *  lock-free rings, and a stage only takes an item when
+ *  the next ring has room for it, so a slow stage
+ *  holds back the stages before it.
+ *
+ *  Stages run as tasks of a shared task manager, started
+ *  when they have items and finished when they have none,
+ *  so the workers move to the stages that are behind.
+ */
+    /* header guard */
+#ifndef CTOOL_THREAD_PIPELINE_H
+#define CTOOL_THREAD_PIPELINE_H
+
+    /* includes */
+#include <stdatomic.h> /* atomic types */
+#include <stdbool.h> /* boolean */
+#include <stddef.h> /* size_t */
+#include "ctool/status.h" /* return status */
+#include "ctool/thread.h" /* task manager */
+
+    /* defines */
+/**
+ * Default capacity of the rings between stages,
+ * must be a power of two
+ */
+#define TASK_PIPELINE_DEFAULT_SIZE 256
+
+    /* typedefs */
+/**
+ * Pipeline ring cell structure
+ *
+ * The item with position `p` is stored in the cell
+ * `p % size`, whose `sequence` is `p` while it is free
+ * for that item and `p + 1` once the item is stored.
+ */
+typedef struct task_pipeline_cell_t {
+    atomic_size_t sequence;
+    task_input_t item;
+} task_pipeline_cell_t;
+
+/**
+ * Pipeline stage structure
+ *
+ * Items are taken from the `input` ring in the order
+ * of their positions, by at most `parallelism` tasks
+ * at once, which are counted in `active`.
+ */
+typedef struct task_pipeline_stage_t {
+    atomic_size_t head;
+    char _head_padding[CTOOL_CACHE_LINE - sizeof(atomic_size_t)];
+    atomic_size_t active;
+    size_t parallelism;
+    size_t index;
+    task_function_t function;
+    task_pipeline_cell_t* input;
+    struct task_pipeline_t* pipeline;
+} task_pipeline_stage_t;
+
+/**
+ * Pipeline structure
+ *
+ * Pushed items are counted by `tail`, the items that have
+ * left the last stage are counted in `completed`, and the
+ * stage tasks of all stages are counted in `running`.
+ * Completion of an item is broadcasted through the
+ * `finished` condition only if there are `waiters`.
+ */
+typedef struct task_pipeline_t {
+    atomic_size_t tail;
+    atomic_size_t completed;
+    atomic_size_t running;
+    atomic_size_t waiters;
+    size_t size;
+    size_t count;
+    size_t capacity;
+    task_pipeline_stage_t* stages;
+    task_manager_t* manager;
+    thread_mutex_t lock;
+    thread_cond_t finished;
+} task_pipeline_t;
+
+    /* functions */
+/**
+ * Initializes an empty pipeline on a task manager
+ *
+ * @param[in] pipeline The pipeline
+ * @param[in] manager  The task manager
+ * @param[in] capacity Maximal number of stages
+ * @param[in] size     Capacity of every ring, a power of two,
+ *                      or 0 for TASK_PIPELINE_DEFAULT_SIZE
+ *
+ * @return ST_BAD_ARG if the ring capacity is not a power of two,
+ *         ST_ALLOC_FAIL if an allocation fails,
+ *         ST_FAIL if synchronization primitives
+ *          can't be initialized, otherwise ST_OK
+ */
+status_t task_pipeline_init(task_pipeline_t* pipeline, task_manager_t* manager, size_t capacity, size_t size);
+
+/**
+ * Frees memory allocated for a pipeline
+ *
+ * Every pushed item must have completed,
+ * see task_pipeline_await().
+ *
+ * @param[in] pipeline The pipeline
+ */
+void task_pipeline_free(task_pipeline_t* pipeline);
+
+/**
+ * Appends a stage to a pipeline
+ *
+ * A stage with parallelism 1 is serial, it receives
+ * the items in the order they were pushed, even if
+ * the stages before it are parallel. If the function
+ * returns NULL, the item is dropped and the next
+ * stages skip it. The output of the last stage
+ * is discarded.
+ *
+ * @param[in] pipeline    The pipeline
+ * @param[in] function    The stage function
+ * @param[in] parallelism Maximal number of items processed
+ *                         at once, or 0 for every worker
+ *
+ * @return ST_FAIL if the pipeline is full
+ *          or items have been pushed already,
+ *         ST_ALLOC_FAIL if an allocation fails,
+ *          otherwise ST_OK
+ */
+status_t task_pipeline_add(task_pipeline_t* pipeline, task_function_t function, size_t parallelism);
+
+/**
+ * Pushes an item into the first stage of a pipeline
+ *
+ * Can be called from any thread at any time.
+ *
+ * @param[in] pipeline The pipeline
+ * @param[in] item     The item
+ *
+ * @return ST_FAIL if the pipeline has no stages,
+ *         ST_BUSY if the first ring is full, otherwise ST_OK
+ */
+status_t task_pipeline_push(task_pipeline_t* pipeline, task_input_t item);
+
+/**
+ * Waits for every pushed item to leave
+ * the last stage of a pipeline
+ *
+ * @param[in] pipeline The pipeline
+ */
+void task_pipeline_await(task_pipeline_t* pipeline);
+
+#endif /* CTOOL_THREAD_PIPELINE_H */
\ No newline at end of file
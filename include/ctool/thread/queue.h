@@ -0,0 +1,107 @@
+/**
+ * @file queue.h
+ * @author andersonarc (e.andersonarc@gmail.com)
+ * @version 0.1
+ * @date 2021-05-17
+ * 
+ *  Bounded lock-free multi-producer/multi-consumer task queue
+ * 
+ *  A ring of cells, each with its own sequence number,
+ *  as described by Dmitry Vyukov. Producers and consumers
+ *  claim positions with a compare-and-swap and never block.
+ */
+    /* header guard */
+#ifndef CTOOL_THREAD_QUEUE_H
+#define CTOOL_THREAD_QUEUE_H
+
+    /* includes */
+#include <stdatomic.h> /* atomic types */
+#include <stdbool.h> /* boolean */
+#include <stddef.h> /* size_t */
+#include "ctool/status.h" /* return status */
+#include "ctool/thread/_internal.h" /* cache line size */
+#include "ctool/thread/task.h" /* task type */
+
+    /* defines */
+/**
+ * Default capacity of a queue, must be a power of two
+ */
+#define TASK_QUEUE_DEFAULT_SIZE 1024
+
+    /* typedefs */
+/**
+ * Queue cell structure
+ */
+typedef struct task_queue_cell_t {
+    atomic_size_t sequence;
+    task_t task;
+} task_queue_cell_t;
+
+/**
+ * Task queue structure
+ * 
+ * Producer and consumer positions are padded
+ * to separate cache lines.
+ */
+typedef struct task_queue_t {
+    atomic_size_t tail;
+    char _tail_padding[CTOOL_CACHE_LINE - sizeof(atomic_size_t)];
+    atomic_size_t head;
+    char _head_padding[CTOOL_CACHE_LINE - sizeof(atomic_size_t)];
+    size_t size;
+    task_queue_cell_t* data;
+} task_queue_t;
+
+    /* functions */
+/**
+ * Initializes an empty queue
+ * 
+ * @param[in] queue The queue
+ * @param[in] size  Capacity, a power of two
+ * 
+ * @return ST_BAD_ARG if the capacity is not a power of two,
+ *         ST_ALLOC_FAIL if an allocation fails,
+ *          otherwise ST_OK
+ */
+status_t task_queue_init(task_queue_t* queue, size_t size);
+
+/**
+ * Frees memory allocated for a queue
+ * 
+ * @param[in] queue The queue
+ */
+void task_queue_free(task_queue_t* queue);
+
+/**
+ * Appends a task to the tail of a queue
+ * 
+ * @param[in] queue The queue
+ * @param[in] task  The task
+ * 
+ * @return false if the queue is full, otherwise true
+ */
+bool task_queue_push(task_queue_t* queue, task_t task);
+
+/**
+ * Removes a task from the head of a queue
+ * 
+ * @param[in]  queue The queue
+ * @param[out] task  The task
+ * 
+ * @return false if the queue is empty, otherwise true
+ */
+bool task_queue_pop(task_queue_t* queue, task_t* task);
+
+/**
+ * Checks if a queue is empty
+ * 
+ * A task that is being pushed concurrently
+ * may already make the queue look non-empty.
+ * 
+ * @param[in] queue The queue
+ */
+static inline bool task_queue_is_empty(task_queue_t* queue) {
+    return atomic_load(&queue->tail) == atomic_load(&queue->head);
+}
+
+#endif /* CTOOL_THREAD_QUEUE_H */
\ No newline at end of file
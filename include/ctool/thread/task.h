@@ -0,0 +1,61 @@
+/**
+ * @file task.h
+ * @author andersonarc (e.andersonarc@gmail.com)
+ * @version 0.1
+ * @date 2021-05-17
+ * 
+ *  Task type of the thread pool
+ * 
+ *  A task is a function pointer with an input value,
+ *  shared by task lists, queues and deques.
+ */
+    /* header guard */
+#ifndef CTOOL_THREAD_TASK_H
+#define CTOOL_THREAD_TASK_H
+
+    /* includes */
+#include <stddef.h> /* NULL */
+
+    /* typedefs */
+/**
+ * Input value for a task function
+ */
+typedef void* task_input_t;
+
+/**
+ * Output value for a task function
+ */
+#ifdef CTOOL_THREAD_USE_POSIX
+    typedef void* task_output_t;
+#else
+    typedef int task_output_t;
+#endif
+
+/**
+ * Default task output
+ */
+#ifdef CTOOL_THREAD_USE_POSIX 
+    #define task_output_default NULL
+#else
+    #define task_output_default 0
+#endif
+
+/**
+ * Default task input
+ */
+#define task_input_default NULL
+
+/**
+ * Task function type
+ */
+typedef task_output_t(*task_function_t)(task_input_t);
+
+/**
+ * Task structure
+ */
+typedef struct task_t {
+    task_function_t function;
+    task_input_t input;
+} task_t;
+
+#endif /* CTOOL_THREAD_TASK_H */
\ No newline at end of file
@@ -0,0 +1,143 @@
+/**
+ * @file timer.h
+ * @author andersonarc (e.andersonarc@gmail.com)
+ * @version 0.1
+ * @date 2021-06-08
+ * 
+ *  Delayed and periodic tasks on a hierarchical timer wheel
+ * 
+ *  Timers are kept in TASK_TIMER_LEVELS wheels of 
+ *  TASK_TIMER_SLOTS slots, each level covering 
+ *  TASK_TIMER_SLOTS times longer span than the previous 
+ *  one. Starting and cancelling a timer is O(1), and
+ *  a single timer thread moves the timers down the levels
+ *  and enqueues the expired tasks to a task manager.
+ */
+    /* header guard */
+#ifndef CTOOL_THREAD_TIMER_H
+#define CTOOL_THREAD_TIMER_H
+
+    /* includes */
+#include <stdbool.h> /* boolean */
+#include <stdint.h> /* uint64_t */
+#include "ctool/status.h" /* return status */
+#include "ctool/thread.h" /* task manager */
+
+    /* defines */
+/**
+ * Number of levels of a timer wheel
+ */
+#define TASK_TIMER_LEVELS 4
+
+/**
+ * Number of slots on every level, 
+ * must be a power of two
+ */
+#define TASK_TIMER_SLOT_BITS 6
+#define TASK_TIMER_SLOTS (1 << TASK_TIMER_SLOT_BITS)
+
+/**
+ * Default duration of a tick in nanoseconds
+ */
+#define TASK_TIMER_DEFAULT_RESOLUTION 1000000
+
+    /* typedefs */
+/**
+ * Timer structure
+ * 
+ * Allocated by the user and linked into a slot
+ * of the wheel while it is `active`, so no memory
+ * is allocated to start a timer. `expires` is the tick
+ * of the next expiration, and `interval` is the period
+ * in ticks, or 0 for a one-shot timer.
+ * 
+ * A timer must be zero-initialized before 
+ * it is started for the first time.
+ */
+typedef struct task_timer_t {
+    task_t task;
+    uint64_t expires;
+    uint64_t interval;
+    bool active;
+    struct task_timer_t* next;
+    struct task_timer_t** link;
+} task_timer_t;
+
+/**
+ * Timer wheel structure
+ * 
+ * Ticks before `current` have been processed. The timer
+ * thread waits on the `wakeup` condition until the tick
+ * `next`, on which a timer expires or is moved down 
+ * a level, or for good while there are no active timers.
+ */
+typedef struct task_timer_wheel_t {
+    task_manager_t* manager;
+    uint64_t resolution;
+    uint64_t origin;
+    uint64_t current;
+    uint64_t next;
+    size_t count;
+    bool stopped;
+    task_timer_t* slots[TASK_TIMER_LEVELS][TASK_TIMER_SLOTS];
+    thread_t thread;
+    thread_mutex_t lock;
+    thread_cond_t wakeup;
+} task_timer_wheel_t;
+
+    /* functions */
+/**
+ * Creates a timer wheel and starts its timer thread
+ * 
+ * @param[in] wheel      The timer wheel
+ * @param[in] manager    Task manager to execute the tasks
+ * @param[in] resolution Duration of a tick in nanoseconds,
+ *                       0 selects the default
+ * 
+ * @return ST_FAIL if the timer thread can't be started,
+ *          otherwise ST_OK
+ */
+status_t task_timer_wheel_create(task_timer_wheel_t* wheel, task_manager_t* manager, uint64_t resolution);
+
+/**
+ * Stops the timer thread of a timer wheel
+ * 
+ * Active timers are dropped, the tasks that 
+ * have already been enqueued are still executed.
+ * 
+ * @param[in] wheel The timer wheel
+ */
+void task_timer_wheel_delete(task_timer_wheel_t* wheel);
+
+/**
+ * Starts a timer, which enqueues a task after a delay
+ * and then, if `interval` is not 0, repeatedly
+ * with a fixed rate
+ * 
+ * Restarts the timer if it is already active.
+ * Expirations are rounded up to the next tick, and
+ * missed periods are skipped. If the queue of the task
+ * manager is full, the task is enqueued on the next tick.
+ * 
+ * @param[in] wheel    The timer wheel
+ * @param[in] timer    The timer
+ * @param[in] task     The task
+ * @param[in] delay    Delay in nanoseconds
+ * @param[in] interval Period in nanoseconds, or 0
+ */
+void task_timer_start(task_timer_wheel_t* wheel, task_timer_t* timer, task_t task, uint64_t delay, uint64_t interval);
+
+/**
+ * Cancels a timer
+ * 
+ * After it returns, the timer is not used by the wheel
+ * anymore, but a task enqueued before might still run.
+ * 
+ * @param[in] wheel The timer wheel
+ * @param[in] timer The timer
+ * 
+ * @return false if the timer was not active, otherwise true
+ */
+bool task_timer_cancel(task_timer_wheel_t* wheel, task_timer_t* timer);
+
+#endif /* CTOOL_THREAD_TIMER_H */
\ No newline at end of file
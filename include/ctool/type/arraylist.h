@@ -7,14 +7,26 @@
  *  Dynamically resizable generic list structure
  * 
  *  A simple arraylist implementation for C language.
- *  Each reallocation doubles the allocated memory size.
+ *  By default, each reallocation doubles the allocated memory
+ *  size, and the memory is trimmed once half of it is unused.
+ *  Other resizing methods can be selected with
+ *  arraylist_define_custom(), and shrinking methods
+ *  with arraylist_define_policy().
+ * 
+ *  An inline arraylist stores its first elements in the
+ *  structure itself and moves them to the heap only once
+ *  they don't fit, see arraylist_declare_inline(). It has
+ *  its own generic name, see arraylist_inline_name().
  */
     /* header guard */
 #ifndef CTOOL_TYPE_ARRAYLIST_H
 #define CTOOL_TYPE_ARRAYLIST_H
 
     /* includes */
+#include <stdbool.h> /* boolean */
+#include <stdint.h> /* SIZE_MAX */
 #include <stdlib.h> /* memory allocation */
+#include <string.h> /* memcpy(), memmove() */
 #include "ctool/assert/runtime.h" /* assertions */
 #include "ctool/type/_internal.h" /* internal definitions */
 #include "ctool/type/list.h" /* lists */
@@ -27,6 +39,13 @@
  */
 #define ARRAYLIST_DEFAULT_SIZE 2
 
+/**
+ * Smallest allocation size in bytes and memory page
+ * size assumed by the size class resizing method
+ */
+#define ARRAYLIST_MIN_CLASS_SIZE 16
+#define ARRAYLIST_PAGE_SIZE 4096
+
 /**
  * Generates a generic name for
  * an arraylist of specified type
@@ -47,6 +66,27 @@
 #define arraylist_init_empty(type)   _ctool_generic_function(arraylist, type, init_empty)
 #define arraylist_init_default(type) _ctool_generic_function(arraylist, type, init_default)
 #define arraylist_move_append(type)  _ctool_generic_function(arraylist, type, move_append)
+#define arraylist_reserve(type)          _ctool_generic_function(arraylist, type, reserve)
+#define arraylist_append_array(type)     _ctool_generic_function(arraylist, type, append_array)
+#define arraylist_append_arraylist(type) _ctool_generic_function(arraylist, type, append_arraylist)
+#define arraylist_insert_range(type)     _ctool_generic_function(arraylist, type, insert_range)
+#define arraylist_swap_remove(type)      _ctool_generic_function(arraylist, type, swap_remove)
+#define arraylist_remove_range(type)     _ctool_generic_function(arraylist, type, remove_range)
+#define arraylist_retain_if(type)        _ctool_generic_function(arraylist, type, retain_if)
+#define _arraylist_grow(type)            _ctool_generic_function(arraylist, type, grow)
+#define _arraylist_resize(type)          _ctool_generic_function(arraylist, type, resize)
+#define _arraylist_shrink(type)          _ctool_generic_function(arraylist, type, shrink)
+
+/**
+ * Generates a generic name for an inline
+ * arraylist of specified type and capacity,
+ * to be passed to the arraylist names above
+ * 
+ * @param[in] type     Type of the arraylist
+ * @param[in] capacity Number of elements stored inline
+ */
+#define arraylist_inline_name(type, capacity) macro_concatenate(macro_concatenate(type, _inline_), capacity)
+#define arraylist_inline(type, capacity)      arraylist(arraylist_inline_name(type, capacity))
 
 /**
  * Returns the last element of an arraylist
@@ -74,6 +114,22 @@
 #define arraylist_to_string(type, list) "arraylist<" macro_stringify(arraylist(type)) "> " #list " [%zu bytes used out of %zu]"
 #define arraylist_to_string_format(list) list.size, list._allocated_size
 
+/**
+ * Arraylist storage methods definition
+ * 
+ * @param[in] list Pointer to the arraylist
+ * 
+ * Heap storage allocates every element on the heap
+ * 
+ * Inline storage keeps the elements in the `_inline`
+ * buffer of the arraylist while they fit into it,
+ * its capacity is the minimal allocated size
+ */
+#define _arraylist_buffer_heap(list)     NULL
+#define _arraylist_buffer_inline(list)   ((list)->_inline)
+#define _arraylist_capacity_heap(list)   0
+#define _arraylist_capacity_inline(list) (sizeof((list)->_inline) / sizeof(*(list)->_inline))
+
 /**
  * Arraylist bare type definition,
  * with no functions declared
@@ -92,6 +148,30 @@ typedef struct arraylist(type) {                  \
     type* data;                                   \
 } arraylist(type);
 
+/**
+ * Inline arraylist bare type definition,
+ * with no functions declared
+ * 
+ * The `data` of an inline arraylist points to its own
+ * `_inline` buffer while the elements fit into it, so
+ * the arraylist must not be copied by value.
+ * The list of its type has to be declared already,
+ * for example with arraylist_declare().
+ * 
+ * @note The declaration should be placed in a header file
+ * 
+ * @param[in] type Type of the arraylist
+ * @param[in] capacity Number of elements stored inline
+ */
+#define arraylist_declare_inline_type(type, capacity)   \
+                                                        \
+typedef struct arraylist_inline(type, capacity) {       \
+    size_t _allocated_size;                             \
+    size_t size;                                        \
+    type* data;                                         \
+    type _inline[capacity];                             \
+} arraylist_inline(type, capacity);
+
 
 
 /**
@@ -101,7 +181,8 @@ typedef struct arraylist(type) {                  \
  * 
  * @param[in] type Type of the arraylist
 **/
-#define arraylist_declare_functions(type)         \
+#define arraylist_declare_functions(type) _arraylist_declare_functions(type, type, heap)
+#define _arraylist_declare_functions(name, type, storage) \
 /**                                               \
  * Appends a new element into an arraylist        \
  *                                                \
@@ -111,13 +192,12 @@ typedef struct arraylist(type) {                  \
  * @return ST_ALLOC_FAIL if an allocation fails,  \
  *          otherwise ST_OK                       \
  */                                               \
-status_t arraylist_add(type)(arraylist(type)* list, type element);     \
+status_t arraylist_add(name)(arraylist(name)* list, type element);     \
                                                   \
 /**                                               \
  * Removes an element at a specified index        \
  * from an arraylist, shrinking it                \
- * if new size is less or equal to                \
- * half of the allocated size                     \
+ * by the shrinking method                        \
  *                                                \
  * @param[in] list  The arraylist                 \
  * @param[in] index The index                     \
@@ -126,7 +206,7 @@ status_t arraylist_add(type)(arraylist(type)* list, type element);     \
  *         ST_ALLOC_FAIL if an allocation fails,  \
  *          otherwise ST_OK                       \
  */                                               \
-status_t arraylist_remove(type)(arraylist(type)* list, index_t index); \
+status_t arraylist_remove(name)(arraylist(name)* list, index_t index); \
                                                   \
 /**                                               \
  * Reallocates the internal array of an arraylist \
@@ -137,7 +217,7 @@ status_t arraylist_remove(type)(arraylist(type)* list, index_t index); \
  * @return ST_ALLOC_FAIL if an allocation fails,  \
  *          otherwise ST_OK                       \
  */                                               \
-status_t arraylist_trim(type)(arraylist(type)* list); \
+status_t arraylist_trim(name)(arraylist(name)* list); \
                                                   \
 /**                                               \
  * Initializes an arraylist with preallocated     \
@@ -151,7 +231,110 @@ status_t arraylist_trim(type)(arraylist(type)* list); \
  * @return ST_ALLOC_FAIL if an allocation fails,  \
  *          otherwise ST_OK                       \
  */                                               \
-status_t arraylist_init(type)(arraylist(type)* list, size_t size);  \
+status_t arraylist_init(name)(arraylist(name)* list, size_t size);  \
+                                                                    \
+/**                                                                 \
+ * Reallocates the internal array of an arraylist                   \
+ * to hold at least a specified number of elements,                 \
+ * if it is smaller                                                 \
+ *                                                                  \
+ * @param[in] list The arraylist                                    \
+ * @param[in] size The number of elements                           \
+ *                                                                  \
+ * @return ST_ALLOC_FAIL if an allocation fails,                    \
+ *          otherwise ST_OK                                         \
+ */                                                                 \
+status_t arraylist_reserve(name)(arraylist(name)* list, size_t size); \
+                                                                    \
+/**                                                                 \
+ * Appends elements of an array to an arraylist,                    \
+ * reallocating it at most once                                     \
+ *                                                                  \
+ * The array must not point into the arraylist.                     \
+ *                                                                  \
+ * @param[in] list  The arraylist                                   \
+ * @param[in] array The array                                       \
+ * @param[in] count The number of elements                          \
+ *                                                                  \
+ * @return ST_ALLOC_FAIL if an allocation fails,                    \
+ *          otherwise ST_OK                                         \
+ */                                                                 \
+status_t arraylist_append_array(name)(arraylist(name)* list, const type* array, size_t count); \
+                                                                    \
+/**                                                                 \
+ * Appends elements of an arraylist to another one,                 \
+ * reallocating it at most once                                     \
+ *                                                                  \
+ * An arraylist can be appended to itself.                          \
+ *                                                                  \
+ * @param[in] list  The arraylist                                   \
+ * @param[in] other The appended arraylist                          \
+ *                                                                  \
+ * @return ST_ALLOC_FAIL if an allocation fails,                    \
+ *          otherwise ST_OK                                         \
+ */                                                                 \
+status_t arraylist_append_arraylist(name)(arraylist(name)* list, const arraylist(name)* other); \
+                                                                    \
+/**                                                                 \
+ * Inserts elements of an array into an arraylist                   \
+ * before a specified index, reallocating it at most                \
+ * once and shifting the following elements once                    \
+ *                                                                  \
+ * The array must not point into the arraylist.                     \
+ *                                                                  \
+ * @param[in] list  The arraylist                                   \
+ * @param[in] index The index, up to the arraylist size             \
+ * @param[in] array The array                                       \
+ * @param[in] count The number of elements                          \
+ *                                                                  \
+ * @return ST_BAD_ARG if index is out of bounds,                    \
+ *         ST_ALLOC_FAIL if an allocation fails,                    \
+ *          otherwise ST_OK                                         \
+ */                                                                 \
+status_t arraylist_insert_range(name)(arraylist(name)* list, index_t index, const type* array, size_t count); \
+                                                                    \
+/**                                                                 \
+ * Removes an element at a specified index from                     \
+ * an arraylist by moving the last element in its place,            \
+ * which doesn't preserve the order of the elements                 \
+ *                                                                  \
+ * @param[in] list  The arraylist                                   \
+ * @param[in] index The index                                       \
+ *                                                                  \
+ * @return ST_BAD_ARG if index is out of bounds,                    \
+ *         ST_ALLOC_FAIL if an allocation fails,                    \
+ *          otherwise ST_OK                                         \
+ */                                                                 \
+status_t arraylist_swap_remove(name)(arraylist(name)* list, index_t index); \
+                                                                    \
+/**                                                                 \
+ * Removes a range of elements from an arraylist,                   \
+ * shifting the following elements once                            \
+ *                                                                  \
+ * @param[in] list  The arraylist                                   \
+ * @param[in] index Index of the first removed element              \
+ * @param[in] count The number of elements                          \
+ *                                                                  \
+ * @return ST_BAD_ARG if the range is out of bounds,                \
+ *         ST_ALLOC_FAIL if an allocation fails,                    \
+ *          otherwise ST_OK                                         \
+ */                                                                 \
+status_t arraylist_remove_range(name)(arraylist(name)* list, index_t index, size_t count); \
+                                                                    \
+/**                                                                 \
+ * Removes the elements of an arraylist that don't                  \
+ * satisfy a predicate in one pass, preserving                      \
+ * the order of the remaining ones                                  \
+ *                                                                  \
+ * @param[in] list      The arraylist                               \
+ * @param[in] predicate The predicate, returns true                 \
+ *                       for the elements to keep                   \
+ * @param[in] context   Context passed to the predicate             \
+ *                                                                  \
+ * @return ST_ALLOC_FAIL if an allocation fails,                    \
+ *          otherwise ST_OK                                         \
+ */                                                                 \
+status_t arraylist_retain_if(name)(arraylist(name)* list, bool (*predicate)(const type* element, void* context), void* context); \
                                                                     \
 /**                                                                 \
  * Frees the memory allocated for                                   \
@@ -159,10 +342,12 @@ status_t arraylist_init(type)(arraylist(type)* list, size_t size);  \
  *                                                                  \
  * @param[in] list The arraylist                                    \
  */                                                                 \
-static inline void arraylist_free(type)(arraylist(type)* list) {    \
-    free(list->data);                                               \
-    list->data = NULL;                                              \
-    list->_allocated_size = 0;                                      \
+static inline void arraylist_free(name)(arraylist(name)* list) {    \
+    if (list->data != macro_concatenate(_arraylist_buffer_, storage)(list)) { \
+        free(list->data);                                           \
+    }                                                               \
+    list->data = macro_concatenate(_arraylist_buffer_, storage)(list); \
+    list->_allocated_size = macro_concatenate(_arraylist_capacity_, storage)(list); \
     list->size = 0;                                                 \
 }                                                                   \
                                                                     \
@@ -171,8 +356,8 @@ static inline void arraylist_free(type)(arraylist(type)* list) {    \
  *                                                                  \
  * @param[in] list The arraylist                                    \
  */                                                                 \
-static inline status_t arraylist_pop(type)(arraylist(type)* list) { \
-    return arraylist_remove(type)(list, list->size - 1);            \
+static inline status_t arraylist_pop(name)(arraylist(name)* list) { \
+    return arraylist_remove(name)(list, list->size - 1);            \
 }                                                                   \
                                                                     \
 /**                                                                 \
@@ -180,7 +365,7 @@ static inline status_t arraylist_pop(type)(arraylist(type)* list) { \
  *                                                                  \
  * @param[in] list The arraylist                                    \
  */                                                                 \
-void arraylist_revert(type)(arraylist(type)* list);                 \
+void arraylist_revert(name)(arraylist(name)* list);                 \
                                                                     \
 /**                                                                 \
  * Transform the arraylist to a list,                               \
@@ -196,7 +381,7 @@ void arraylist_revert(type)(arraylist(type)* list);                 \
  * @return ST_FAIL if the arraylist can't be trimmed,               \
  *          otherwise ST_OK                                         \
  */                                                                 \
-status_t arraylist_to_list(type)(arraylist(type)* src, list(type)* dest); \
+status_t arraylist_to_list(name)(arraylist(name)* src, list(type)* dest); \
                                                                     \
 /**                                                                 \
  * Initializes an arraylist with one element                        \
@@ -207,9 +392,9 @@ status_t arraylist_to_list(type)(arraylist(type)* src, list(type)* dest); \
  * @return ST_FAIL if the arraylist can't be initialized,           \
  *          otherwise ST_OK                                         \
  */                                                                 \
-static inline status_t arraylist_init_with(type)(arraylist(type)* list, type element) { \
-    assertr_status(arraylist_init(type)(list, 0), ST_FAIL);                             \
-    assertr_status(arraylist_add(type)(list, element), ST_FAIL);                        \
+static inline status_t arraylist_init_with(name)(arraylist(name)* list, type element) { \
+    assertr_status(arraylist_init(name)(list, 0), ST_FAIL);                             \
+    assertr_status(arraylist_add(name)(list, element), ST_FAIL);                        \
     return ST_OK;                                                                       \
 }                                                                                       \
                                                                                         \
@@ -224,8 +409,8 @@ static inline status_t arraylist_init_with(type)(arraylist(type)* list, type ele
  * @return ST_FAIL if the arraylist cannot be initialized,                              \
  *          otherwise ST_OK                                                             \
  */                                                                                     \
-static inline status_t arraylist_init_empty(type)(arraylist(type)* list) {              \
-    assertr_status(arraylist_init(type)(list, 0), ST_FAIL);                             \
+static inline status_t arraylist_init_empty(name)(arraylist(name)* list) {              \
+    assertr_status(arraylist_init(name)(list, 0), ST_FAIL);                             \
     return ST_OK;                                                                       \
 }                                                                                       \
                                                                                         \
@@ -241,8 +426,8 @@ static inline status_t arraylist_init_empty(type)(arraylist(type)* list) {
  * @return ST_FAIL if the arraylist cannot be initialized,                              \
  *          otherwise ST_OK                                                             \
  */                                                                                     \
-static inline status_t arraylist_init_default(type)(arraylist(type)* list) {            \
-    assertr_status(arraylist_init(type)(list, ARRAYLIST_DEFAULT_SIZE), ST_FAIL);        \
+static inline status_t arraylist_init_default(name)(arraylist(name)* list) {            \
+    assertr_status(arraylist_init(name)(list, ARRAYLIST_DEFAULT_SIZE), ST_FAIL);        \
     return ST_OK;                                                                       \
 }                                                                                       \
                                                                                         \
@@ -260,9 +445,14 @@ static inline status_t arraylist_init_default(type)(arraylist(type)* list) {
  * @return ST_FAIL if the element cannot be added,                                      \
  *          otherwise ST_OK                                                             \
  */                                                                                     \
-static inline status_t arraylist_move_append(type)(arraylist(type)* list, type element, arraylist(type)* variable) { \
+static inline status_t arraylist_move_append(name)(arraylist(name)* list, type element, arraylist(name)* variable) { \
     *variable = *list;                                                                  \
-    assertr_status(arraylist_add(type)(variable, element), ST_FAIL);                    \
+    if (macro_concatenate(_arraylist_capacity_, storage)(list) != 0                     \
+            && list->data == macro_concatenate(_arraylist_buffer_, storage)(list)) {    \
+        /* the copied elements are in the inline buffer of the variable */              \
+        variable->data = macro_concatenate(_arraylist_buffer_, storage)(variable);      \
+    }                                                                                   \
+    assertr_status(arraylist_add(name)(variable, element), ST_FAIL);                    \
     return ST_OK;                                                                       \
 }
 
@@ -279,15 +469,66 @@ static inline status_t arraylist_move_append(type)(arraylist(type)* list, type e
 arraylist_declare_type(type);       \
 arraylist_declare_functions(type);
 
+/**
+ * Declares an inline arraylist of specified type,
+ * which stores up to a specified number of elements
+ * without allocating memory, and has the same
+ * functions as a regular arraylist under the name
+ * from arraylist_inline_name()
+ * 
+ * The list of its type has to be declared already,
+ * for example with arraylist_declare(), so regular
+ * and inline arraylists of a type can coexist.
+ * 
+ * @note The declaration should be placed in a header file
+ * 
+ * @param[in] type Type of the arraylist
+ * @param[in] capacity Number of elements stored inline
+**/
+#define arraylist_declare_inline(type, capacity) \
+arraylist_declare_inline_type(type, capacity);   \
+_arraylist_declare_functions(arraylist_inline_name(type, capacity), type, inline);
+
 
 
 
 
 
+/**
+ * Rounds a number of elements up, so that
+ * they fill an allocator size class
+ * 
+ * Allocations smaller than a page are rounded up
+ * to a power of two, which is a size class of common
+ * allocators, and bigger ones to whole pages.
+ * 
+ * @param[in] size    The number of elements
+ * @param[in] element Size of an element in bytes
+ * 
+ * @return The rounded number of elements
+ */
+static inline size_t _arraylist_round_size(size_t size, size_t element) {
+    if (size > (SIZE_MAX - ARRAYLIST_PAGE_SIZE) / element) {
+        return size;
+    }
+    size_t bytes = size * element;
+    if (bytes < ARRAYLIST_PAGE_SIZE) {
+        size_t rounded = ARRAYLIST_MIN_CLASS_SIZE;
+        while (rounded < bytes) {
+            rounded *= 2;
+        }
+        bytes = rounded;
+    } else {
+        bytes = (bytes + ARRAYLIST_PAGE_SIZE - 1) / ARRAYLIST_PAGE_SIZE * ARRAYLIST_PAGE_SIZE;
+    }
+    return bytes / element;
+}
+
 /**
  * Arraylist resizing methods definition
  * 
  * @param[in] size The size variable
+ * @param[in] type Type of the arraylist
  * 
  * Exact resizing increases arraylist size
  * each time an element is added, 
@@ -296,13 +537,62 @@ arraylist_declare_functions(type);
  * Double resizing multiplies arraylist size
  * by two each time an element is added,
  * reducing allocation overhead for big arraylists
+ * 
+ * One and a half resizing multiplies arraylist size
+ * by 1.5, wasting less memory than doubling while
+ * still growing geometrically
+ * 
+ * Size class resizing multiplies arraylist size
+ * by 1.5 and rounds the allocation up to fill the 
+ * allocator size class or the memory pages
+ * it would occupy anyway
+ */
+#define ARRAYLIST_RESIZE_EXACT          exact
+#define ARRAYLIST_RESIZE_DOUBLE         double
+#define ARRAYLIST_RESIZE_ONE_AND_HALF   one_and_half
+#define ARRAYLIST_RESIZE_SIZE_CLASS     size_class
+#define _ARRAYLIST_INITIAL_SIZE_exact        1
+#define _ARRAYLIST_INITIAL_SIZE_double       2
+#define _ARRAYLIST_INITIAL_SIZE_one_and_half 2
+#define _ARRAYLIST_INITIAL_SIZE_size_class   1
+#define _arraylist_resize_op_exact(size)        size + 1
+#define _arraylist_resize_op_double(size)       size * 2
+#define _arraylist_resize_op_one_and_half(size) (size) + ((size) + 1) / 2
+#define _arraylist_resize_op_size_class(size)   (size) + ((size) + 1) / 2
+#define _arraylist_round_op_exact(size, type)        (size)
+#define _arraylist_round_op_double(size, type)       (size)
+#define _arraylist_round_op_one_and_half(size, type) (size)
+#define _arraylist_round_op_size_class(size, type)   _arraylist_round_size(size, sizeof(type))
+
+/**
+ * Arraylist shrinking methods definition
+ * 
+ * Each method returns the allocated size an arraylist
+ * is shrunk to after an element is removed, it is
+ * applied again until the allocated size is kept
+ * 
+ * @param[in] size      The size variable
+ * @param[in] allocated The allocated size variable
+ * 
+ * Half shrinking trims the arraylist once its size
+ * is half of the allocated size, saving memory, but
+ * adding and removing an element at that boundary
+ * reallocates it each time
+ * 
+ * Quarter shrinking halves the allocated size once
+ * the size is a quarter of it, so the arraylist
+ * has to grow or shrink by a quarter again 
+ * before it is reallocated
+ * 
+ * Never shrinking keeps the allocated memory
+ * until the arraylist is trimmed or freed
  */
-#define ARRAYLIST_RESIZE_EXACT  exact
-#define ARRAYLIST_RESIZE_DOUBLE double
-#define _ARRAYLIST_INITIAL_SIZE_exact  1
-#define _ARRAYLIST_INITIAL_SIZE_double 2
-#define _arraylist_resize_op_exact(size)  size + 1
-#define _arraylist_resize_op_double(size) size * 2
+#define ARRAYLIST_SHRINK_HALF    half
+#define ARRAYLIST_SHRINK_QUARTER quarter
+#define ARRAYLIST_SHRINK_NEVER   never
+#define _arraylist_shrink_op_half(size, allocated)    ((size) <= (allocated) / 2 ? (size) : (allocated))
+#define _arraylist_shrink_op_quarter(size, allocated) ((size) <= (allocated) / 4 ? (allocated) / 2 : (allocated))
+#define _arraylist_shrink_op_never(size, allocated)   (allocated)
 
 /**
  * Defines an arraylist implementation of specified type
@@ -310,10 +600,99 @@ arraylist_declare_functions(type);
  * @note The definition should be placed in a source file
  * 
  * @param[in] type Type of the arraylist
- * @param[in] resize_method Arraylist resizing method ("ARRAYLIST_RESIZE_EXACT" or "ARRAYLIST_RESIZE_DOUBLE")
+ * @param[in] resize_method Arraylist resizing method ("ARRAYLIST_RESIZE_EXACT", "ARRAYLIST_RESIZE_DOUBLE",
+ *                           "ARRAYLIST_RESIZE_ONE_AND_HALF" or "ARRAYLIST_RESIZE_SIZE_CLASS")
 **/
 #define arraylist_define(type) arraylist_define_custom(type, ARRAYLIST_RESIZE_DOUBLE)
 #define arraylist_define_custom(type, resize_method) \
+    arraylist_define_policy(type, resize_method, ARRAYLIST_SHRINK_HALF)
+
+/**
+ * Defines an arraylist implementation of specified type
+ * with a resizing and a shrinking method
+ * 
+ * @note The definition should be placed in a source file
+ * 
+ * @param[in] type Type of the arraylist
+ * @param[in] resize_method Arraylist resizing method, see arraylist_define_custom()
+ * @param[in] shrink_method Arraylist shrinking method ("ARRAYLIST_SHRINK_HALF", "ARRAYLIST_SHRINK_QUARTER"
+ *                           or "ARRAYLIST_SHRINK_NEVER")
+**/
+#define arraylist_define_policy(type, resize_method, shrink_method) \
+    _arraylist_define(type, type, resize_method, shrink_method, heap)
+
+/**
+ * Defines an inline arraylist implementation of specified type
+ * 
+ * Once the elements don't fit into the inline buffer,
+ * they are moved to the heap, and they are moved back
+ * as soon as they fit into it again, whatever the
+ * shrinking method.
+ * 
+ * @note The definition should be placed in a source file
+ * 
+ * @param[in] type Type of the arraylist
+ * @param[in] capacity Number of elements stored inline, as declared
+ * @param[in] resize_method Arraylist resizing method, see arraylist_define_custom()
+ * @param[in] shrink_method Arraylist shrinking method, see arraylist_define_policy()
+**/
+#define arraylist_define_inline(type, capacity) \
+    arraylist_define_inline_custom(type, capacity, ARRAYLIST_RESIZE_DOUBLE)
+#define arraylist_define_inline_custom(type, capacity, resize_method) \
+    arraylist_define_inline_policy(type, capacity, resize_method, ARRAYLIST_SHRINK_HALF)
+#define arraylist_define_inline_policy(type, capacity, resize_method, shrink_method) \
+    _arraylist_define(arraylist_inline_name(type, capacity), type, resize_method, shrink_method, inline)
+
+#define _arraylist_define(name, type, resize_method, shrink_method, storage) \
+                                                  \
+/**                                               \
+ * Reallocates the internal array of an arraylist \
+ * to hold a specified number of elements,        \
+ * moving them between the inline buffer          \
+ * and the heap if required                       \
+ *                                                \
+ * The allocated size is not changed if an        \
+ * allocation fails.                              \
+ *                                                \
+ * @param[in] list      The arraylist             \
+ * @param[in] allocated The number of elements,   \
+ *                       at least the size        \
+ *                                                \
+ * @return ST_ALLOC_FAIL if an allocation fails,  \
+ *          otherwise ST_OK                       \
+ */                                               \
+static status_t _arraylist_resize(name)(arraylist(name)* list, size_t allocated) { \
+    type* buffer = macro_concatenate(_arraylist_buffer_, storage)(list); \
+    size_t capacity = macro_concatenate(_arraylist_capacity_, storage)(list); \
+    type* pointer;                                \
+    if (capacity != 0 && allocated <= capacity) { \
+        /* move the elements back into the inline buffer */ \
+        if (list->data != buffer) {               \
+            memcpy(buffer, list->data, list->size * sizeof(type)); \
+            free(list->data);                     \
+        }                                         \
+        pointer = buffer;                         \
+        allocated = capacity;                     \
+    } else if (allocated == 0) {                  \
+        free(list->data);                         \
+        pointer = NULL;                           \
+    } else if (capacity != 0 && list->data == buffer) { \
+        /* move the elements out of the inline buffer */ \
+        pointer = (type*) malloc(allocated * sizeof(type)); \
+        if (pointer == NULL) {                    \
+            return ST_ALLOC_FAIL;                 \
+        }                                         \
+        memcpy(pointer, buffer, list->size * sizeof(type)); \
+    } else {                                      \
+        pointer = (type*) realloc(list->data, allocated * sizeof(type)); \
+        if (pointer == NULL) {                    \
+            return ST_ALLOC_FAIL;                 \
+        }                                         \
+    }                                             \
+    list->data = pointer;                         \
+    list->_allocated_size = allocated;            \
+    return ST_OK;                                 \
+}                                                 \
                                                   \
 /**                                               \
  * Appends a new element into an arraylist        \
@@ -324,45 +703,32 @@ arraylist_declare_functions(type);
  * @return ST_ALLOC_FAIL if an allocation fails,  \
  *          otherwise ST_OK                       \
  */                                               \
-status_t arraylist_add(type)(arraylist(type)* list, type element) { \
+status_t arraylist_add(name)(arraylist(name)* list, type element) { \
     /* check for free space */                    \
     if (list->size == list->_allocated_size) {    \
-        /* new pointer */                         \
-        type* pointer;                            \
-                                                  \
         /* new size */                            \
-        size_t old_size = list->_allocated_size;  \
+        size_t new_size;                          \
                                                   \
         /* check for empty list */                \
         if (list->_allocated_size == 0 || list->data == NULL) { \
             /* first allocation */                \
-            list->_allocated_size = macro_concatenate(_ARRAYLIST_INITIAL_SIZE_, resize_method); \
-                                                  \
-            /* allocate memory */                 \
-            pointer = (type*) malloc(list->_allocated_size * sizeof(type)); \
+            new_size = macro_concatenate(_arraylist_round_op_, resize_method)( \
+                macro_concatenate(_ARRAYLIST_INITIAL_SIZE_, resize_method), type); \
         } else {                                  \
             /* increase allocated length */       \
-            list->_allocated_size = macro_concatenate(_arraylist_resize_op_, resize_method)(list->_allocated_size); \
-                                                  \
-            /* reallocate memory */               \
-            pointer = (type*) realloc(list->data, list->_allocated_size * sizeof(type)); \
+            new_size = macro_concatenate(_arraylist_round_op_, resize_method)( \
+                macro_concatenate(_arraylist_resize_op_, resize_method)(list->_allocated_size), type); \
         }                                         \
                                                   \
-        /* null check */                          \
-        if (pointer == NULL) {                    \
+        /* reallocate memory */                   \
+        if (_arraylist_resize(name)(list, new_size) != ST_OK) { \
             /* log an error */                    \
-            loge("memory reallocation to size %zu failed while adding new element to a " macro_stringify(arraylist(type)) \
-                " with size %zu and allocated size %zu", list->_allocated_size, list->size, old_size); \
-                                                  \
-            /* revert allocated size */           \
-            list->_allocated_size = old_size;     \
+            loge("memory reallocation to size %zu failed while adding new element to a " macro_stringify(arraylist(name)) \
+                " with size %zu and allocated size %zu", new_size, list->size, list->_allocated_size); \
                                                   \
             /* fail */                            \
             return ST_ALLOC_FAIL;                 \
         }                                         \
-                                                  \
-        /* assign new pointer */                  \
-        list->data = pointer;                     \
     }                                             \
                                                   \
     /* add new element */                         \
@@ -375,11 +741,48 @@ status_t arraylist_add(type)(arraylist(type)* list, type element) { \
     return ST_OK;                                 \
 }                                                 \
                                                   \
+/**                                               \
+ * Shrinks the internal array of an arraylist     \
+ * by the shrinking method, after elements        \
+ * are removed                                    \
+ *                                                \
+ * The method is repeated until it keeps the      \
+ * allocated size, so a bulk removal reallocates  \
+ * the array only once.                           \
+ * An inline arraylist moves back into its buffer \
+ * once the elements fit, with any method.        \
+ *                                                \
+ * @param[in] list The arraylist                  \
+ *                                                \
+ * @return ST_ALLOC_FAIL if an allocation fails,  \
+ *          otherwise ST_OK                       \
+ */                                               \
+static status_t _arraylist_shrink(name)(arraylist(name)* list) { \
+    size_t capacity = macro_concatenate(_arraylist_capacity_, storage)(list); \
+    size_t allocated = list->_allocated_size;     \
+    size_t target;                                \
+    while ((target = macro_concatenate(_arraylist_shrink_op_, shrink_method)(list->size, allocated)) < allocated) { \
+        allocated = target;                       \
+    }                                             \
+    if (capacity != 0 && list->size <= capacity   \
+            && list->data != macro_concatenate(_arraylist_buffer_, storage)(list)) { \
+        /* the elements fit into the inline buffer again, whatever the method */ \
+        allocated = capacity;                     \
+    } else if (allocated >= list->_allocated_size) { \
+        return ST_OK;                             \
+    }                                             \
+    if (_arraylist_resize(name)(list, allocated) != ST_OK) { \
+        loge("memory reallocation to size %zu failed while shrinking a " macro_stringify(arraylist(name)) \
+            " with size %zu and allocated size %zu", allocated, list->size, list->_allocated_size); \
+        return ST_ALLOC_FAIL;                     \
+    }                                             \
+    return ST_OK;                                 \
+}                                                 \
+                                                  \
 /**                                               \
  * Removes an element at specified index          \
  * from an arraylist, shrinking it                \
- * if new size is less or equal to                \
- * half of the allocated size                     \
+ * by the shrinking method                        \
  *                                                \
  * @param[in] list  The arraylist                 \
  * @param[in] index The index                     \
@@ -388,7 +791,7 @@ status_t arraylist_add(type)(arraylist(type)* list, type element) { \
  *         ST_ALLOC_FAIL if an allocation fails,  \
  *          otherwise ST_OK                       \
  */                                               \
-status_t arraylist_remove(type)(arraylist(type)* list, index_t index) {   \
+status_t arraylist_remove(name)(arraylist(name)* list, index_t index) {   \
     /* check for index being out of bounds (and arraylist being empty) */ \
     assertr_false(index >= list->size, ST_BAD_ARG);    \
                                                        \
@@ -397,16 +800,12 @@ status_t arraylist_remove(type)(arraylist(type)* list, index_t index) {   \
                                                        \
     if (index < list->size) {                          \
         /* shift arraylist elements in place of the removed one */      \
-        iterate_range_single(i, index, list->size) {   \
-            list->data[i] = list->data[i + 1];         \
-        }                                              \
+        memmove(list->data + index, list->data + index + 1, (list->size - index) * sizeof(type)); \
     }                                                  \
     /* if the element is the last, do nothing */       \
                                                        \
-    if (list->size <= list->_allocated_size / 2) {     \
-        /* trim the arraylist */                       \
-        assertr_status(arraylist_trim(type)(list), ST_ALLOC_FAIL); \
-    }                                                  \
+    /* shrink the arraylist */                         \
+    assertr_status(_arraylist_shrink(name)(list), ST_ALLOC_FAIL); \
                                                        \
     /* success */                                      \
     return ST_OK;                                      \
@@ -421,39 +820,24 @@ status_t arraylist_remove(type)(arraylist(type)* list, index_t index) {   \
  * @return ST_ALLOC_FAIL if an allocation fails,       \
  *          otherwise ST_OK                            \
  */                                                    \
-status_t arraylist_trim(type)(arraylist(type)* list) { \
+status_t arraylist_trim(name)(arraylist(name)* list) { \
     /* if the list is unallocated, return */             \
     if (list->_allocated_size == 0) {                    \
-        logw("attempted to trim an unallocated " macro_stringify(arraylist(type)) \
+        logw("attempted to trim an unallocated " macro_stringify(arraylist(name)) \
                 " with size %zu and allocated size %zu", list->size, list->_allocated_size); \
         return ST_OK;                                     \
     }                                                     \
                                                           \
-    /* if the list is empty, free memory */               \
-    if (list->size == 0) {                                \
-        free(list->data);                                 \
-        list->data = NULL;                                \
-    } else {                                              \
-        /* else, reallocate memory */                     \
-        type* pointer = (type*) realloc(list->data, list->size * sizeof(type)); \
-                                                          \
-        /* null check */                                  \
-        if (pointer == NULL) {                            \
-            /* log an error */                            \
-            loge("memory reallocation failed while trimming a " macro_stringify(arraylist(type)) \
-                    " with size %zu and allocated size %zu", list->size, list->_allocated_size); \
-                                                          \
-            /* fail */                                    \
-            return ST_ALLOC_FAIL;                         \
-        }                                                 \
+    /* reallocate memory, or free it if the list is empty */ \
+    if (_arraylist_resize(name)(list, list->size) != ST_OK) { \
+        /* log an error */                                \
+        loge("memory reallocation failed while trimming a " macro_stringify(arraylist(name)) \
+                " with size %zu and allocated size %zu", list->size, list->_allocated_size); \
                                                           \
-        /* assign new pointer */                          \
-        list->data = pointer;                             \
+        /* fail */                                        \
+        return ST_ALLOC_FAIL;                             \
     }                                                     \
                                                           \
-    /* change allocated size */                           \
-    list->_allocated_size = list->size;                   \
-                                                          \
     /* success */                                      \
     return ST_OK;                                      \
 }                                                      \
@@ -470,11 +854,12 @@ status_t arraylist_trim(type)(arraylist(type)* list) { \
  * @return ST_ALLOC_FAIL if an allocation fails,       \
  *          otherwise ST_OK                            \
  */                                                    \
-status_t arraylist_init(type)(arraylist(type)* list, size_t size) { \
+status_t arraylist_init(name)(arraylist(name)* list, size_t size) { \
+    size_t capacity = macro_concatenate(_arraylist_capacity_, storage)(list); \
     list->size = 0;                                                 \
-    list->_allocated_size = size;                                   \
-    if (size == 0) {                                                \
-        list->data = NULL;                                          \
+    list->_allocated_size = size > capacity ? size : capacity;      \
+    if (size <= capacity) {                                         \
+        list->data = macro_concatenate(_arraylist_buffer_, storage)(list); \
     } else {                                                        \
         assertr_malloc(list->data, sizeof(type) * size, type*)      \
     }                                                               \
@@ -488,7 +873,7 @@ status_t arraylist_init(type)(arraylist(type)* list, size_t size) { \
  *                                                                  \
  * @param[in] list The arraylist                                    \
  */                                                                 \
-void arraylist_revert(type)(arraylist(type)* list) {                \
+void arraylist_revert(name)(arraylist(name)* list) {                \
     iterate_array(i, list->size / 2) {                              \
         index_t inverted = list->size - i - 1;                      \
         type tmp = list->data[i];                                   \
@@ -511,14 +896,229 @@ void arraylist_revert(type)(arraylist(type)* list) {                \
  * @return ST_FAIL if the arraylist can't be trimmed,               \
  *          otherwise ST_OK                                         \
  */                                                                 \
-status_t arraylist_to_list(type)(arraylist(type)* src, list(type)* dest) {  \
+status_t arraylist_to_list(name)(arraylist(name)* src, list(type)* dest) {  \
     if (src->size != src->_allocated_size) {                                \
-        assertr_status(arraylist_trim(type)(src), ST_FAIL);                 \
+        assertr_status(arraylist_trim(name)(src), ST_FAIL);                 \
+    }                                                                       \
+                                                                            \
+    if (macro_concatenate(_arraylist_capacity_, storage)(src) != 0          \
+            && src->data == macro_concatenate(_arraylist_buffer_, storage)(src)) { \
+        /* a list can't take the inline buffer, copy it */                  \
+        dest->data = NULL;                                                  \
+        if (src->size != 0) {                                               \
+            assertr_malloc(dest->data, sizeof(type) * src->size, type*)     \
+            memcpy(dest->data, src->data, sizeof(type) * src->size);        \
+        }                                                                   \
+        dest->size = src->size;                                             \
+        return ST_OK;                                                       \
     }                                                                       \
                                                                             \
     dest->data = src->data;                                                 \
     dest->size = src->size;                                                 \
     return ST_OK;                                                           \
+}                                                                           \
+                                                                            \
+/**                                                                         \
+ * Reallocates the internal array of an arraylist                           \
+ * to hold at least a specified number of elements,                         \
+ * if it is smaller                                                         \
+ *                                                                          \
+ * @param[in] list The arraylist                                            \
+ * @param[in] size The number of elements                                   \
+ *                                                                          \
+ * @return ST_ALLOC_FAIL if an allocation fails,                            \
+ *          otherwise ST_OK                                                 \
+ */                                                                         \
+status_t arraylist_reserve(name)(arraylist(name)* list, size_t size) {      \
+    if (size <= list->_allocated_size && (list->data != NULL || size == 0)) { \
+        return ST_OK;                                                       \
+    }                                                                       \
+    assertrc_true(size <= SIZE_MAX / sizeof(type), ST_ALLOC_FAIL,           \
+        "%zu elements are too many for a " macro_stringify(arraylist(name)), size) \
+                                                                            \
+    if (_arraylist_resize(name)(list, size) != ST_OK) {                     \
+        loge("memory reallocation to size %zu failed while reserving a " macro_stringify(arraylist(name)) \
+            " with size %zu and allocated size %zu", size, list->size, list->_allocated_size); \
+        return ST_ALLOC_FAIL;                                               \
+    }                                                                       \
+    return ST_OK;                                                           \
+}                                                                           \
+                                                                            \
+/**                                                                         \
+ * Makes room for a specified number of new elements                        \
+ * in an arraylist, growing it by the resizing method                       \
+ * or to the required size if that is not enough                            \
+ *                                                                          \
+ * @param[in] list  The arraylist                                           \
+ * @param[in] count The number of new elements                              \
+ *                                                                          \
+ * @return ST_ALLOC_FAIL if an allocation fails,                            \
+ *          otherwise ST_OK                                                 \
+ */                                                                         \
+static status_t _arraylist_grow(name)(arraylist(name)* list, size_t count) { \
+    if (list->data != NULL && count <= list->_allocated_size - list->size) { \
+        return ST_OK;                                                       \
+    }                                                                       \
+    assertrc_true(count <= SIZE_MAX - list->size, ST_ALLOC_FAIL,            \
+        "%zu new elements are too many for a " macro_stringify(arraylist(name)), count) \
+                                                                            \
+    size_t required = list->size + count;                                   \
+    size_t grown = list->_allocated_size == 0 || list->data == NULL         \
+        ? macro_concatenate(_ARRAYLIST_INITIAL_SIZE_, resize_method)        \
+        : macro_concatenate(_arraylist_resize_op_, resize_method)(list->_allocated_size); \
+    return arraylist_reserve(name)(list,                                    \
+        macro_concatenate(_arraylist_round_op_, resize_method)(grown > required ? grown : required, type)); \
+}                                                                           \
+                                                                            \
+/**                                                                         \
+ * Appends elements of an array to an arraylist,                            \
+ * reallocating it at most once                                             \
+ *                                                                          \
+ * The array must not point into the arraylist.                             \
+ *                                                                          \
+ * @param[in] list  The arraylist                                           \
+ * @param[in] array The array                                               \
+ * @param[in] count The number of elements                                  \
+ *                                                                          \
+ * @return ST_ALLOC_FAIL if an allocation fails,                            \
+ *          otherwise ST_OK                                                 \
+ */                                                                         \
+status_t arraylist_append_array(name)(arraylist(name)* list, const type* array, size_t count) { \
+    if (count == 0) {                                                       \
+        return ST_OK;                                                       \
+    }                                                                       \
+    assertr_status(_arraylist_grow(name)(list, count), ST_ALLOC_FAIL);      \
+    memcpy(list->data + list->size, array, count * sizeof(type));           \
+    list->size += count;                                                    \
+    return ST_OK;                                                           \
+}                                                                           \
+                                                                            \
+/**                                                                         \
+ * Appends elements of an arraylist to another one,                         \
+ * reallocating it at most once                                             \
+ *                                                                          \
+ * An arraylist can be appended to itself.                                  \
+ *                                                                          \
+ * @param[in] list  The arraylist                                           \
+ * @param[in] other The appended arraylist                                  \
+ *                                                                          \
+ * @return ST_ALLOC_FAIL if an allocation fails,                            \
+ *          otherwise ST_OK                                                 \
+ */                                                                         \
+status_t arraylist_append_arraylist(name)(arraylist(name)* list, const arraylist(name)* other) { \
+    size_t count = other->size;                                             \
+    if (count == 0) {                                                       \
+        return ST_OK;                                                       \
+    }                                                                       \
+    assertr_status(_arraylist_grow(name)(list, count), ST_ALLOC_FAIL);      \
+                                                                            \
+    /* read the data pointer after growing, in case other is the list */    \
+    memcpy(list->data + list->size, other->data, count * sizeof(type));     \
+    list->size += count;                                                    \
+    return ST_OK;                                                           \
+}                                                                           \
+                                                                            \
+/**                                                                         \
+ * Inserts elements of an array into an arraylist                           \
+ * before a specified index, reallocating it at most                        \
+ * once and shifting the following elements once                           \
+ *                                                                          \
+ * The array must not point into the arraylist.                             \
+ *                                                                          \
+ * @param[in] list  The arraylist                                           \
+ * @param[in] index The index, up to the arraylist size                     \
+ * @param[in] array The array                                               \
+ * @param[in] count The number of elements                                  \
+ *                                                                          \
+ * @return ST_BAD_ARG if index is out of bounds,                            \
+ *         ST_ALLOC_FAIL if an allocation fails,                            \
+ *          otherwise ST_OK                                                 \
+ */                                                                         \
+status_t arraylist_insert_range(name)(arraylist(name)* list, index_t index, const type* array, size_t count) { \
+    assertr_false(index > list->size, ST_BAD_ARG);                          \
+    if (count == 0) {                                                       \
+        return ST_OK;                                                       \
+    }                                                                       \
+    assertr_status(_arraylist_grow(name)(list, count), ST_ALLOC_FAIL);      \
+    memmove(list->data + index + count, list->data + index, (list->size - index) * sizeof(type)); \
+    memcpy(list->data + index, array, count * sizeof(type));                \
+    list->size += count;                                                    \
+    return ST_OK;                                                           \
+}                                                                           \
+                                                                            \
+/**                                                                         \
+ * Removes an element at a specified index from                             \
+ * an arraylist by moving the last element in its place,                    \
+ * which doesn't preserve the order of the elements                         \
+ *                                                                          \
+ * @param[in] list  The arraylist                                           \
+ * @param[in] index The index                                               \
+ *                                                                          \
+ * @return ST_BAD_ARG if index is out of bounds,                            \
+ *         ST_ALLOC_FAIL if an allocation fails,                            \
+ *          otherwise ST_OK                                                 \
+ */                                                                         \
+status_t arraylist_swap_remove(name)(arraylist(name)* list, index_t index) { \
+    assertr_false(index >= list->size, ST_BAD_ARG);                         \
+    list->size--;                                                           \
+    list->data[index] = list->data[list->size];                             \
+    assertr_status(_arraylist_shrink(name)(list), ST_ALLOC_FAIL);           \
+    return ST_OK;                                                           \
+}                                                                           \
+                                                                            \
+/**                                                                         \
+ * Removes a range of elements from an arraylist,                           \
+ * shifting the following elements once                                    \
+ *                                                                          \
+ * @param[in] list  The arraylist                                           \
+ * @param[in] index Index of the first removed element                      \
+ * @param[in] count The number of elements                                  \
+ *                                                                          \
+ * @return ST_BAD_ARG if the range is out of bounds,                        \
+ *         ST_ALLOC_FAIL if an allocation fails,                            \
+ *          otherwise ST_OK                                                 \
+ */                                                                         \
+status_t arraylist_remove_range(name)(arraylist(name)* list, index_t index, size_t count) { \
+    assertr_false(index > list->size || count > list->size - index, ST_BAD_ARG); \
+    if (count == 0) {                                                       \
+        return ST_OK;                                                       \
+    }                                                                       \
+    memmove(list->data + index, list->data + index + count,                 \
+        (list->size - index - count) * sizeof(type));                       \
+    list->size -= count;                                                    \
+    assertr_status(_arraylist_shrink(name)(list), ST_ALLOC_FAIL);           \
+    return ST_OK;                                                           \
+}                                                                           \
+                                                                            \
+/**                                                                         \
+ * Removes the elements of an arraylist that don't                          \
+ * satisfy a predicate in one pass, preserving                              \
+ * the order of the remaining ones                                          \
+ *                                                                          \
+ * @param[in] list      The arraylist                                       \
+ * @param[in] predicate The predicate, returns true                         \
+ *                       for the elements to keep                           \
+ * @param[in] context   Context passed to the predicate                     \
+ *                                                                          \
+ * @return ST_ALLOC_FAIL if an allocation fails,                            \
+ *          otherwise ST_OK                                                 \
+ */                                                                         \
+status_t arraylist_retain_if(name)(arraylist(name)* list, bool (*predicate)(const type* element, void* context), void* context) { \
+    size_t kept = 0;                                                        \
+    iterate_array(i, list->size) {                                          \
+        if (predicate(&list->data[i], context)) {                           \
+            if (kept != i) {                                                \
+                list->data[kept] = list->data[i];                           \
+            }                                                               \
+            kept++;                                                         \
+        }                                                                   \
+    }                                                                       \
+    if (kept == list->size) {                                               \
+        return ST_OK;                                                       \
+    }                                                                       \
+    list->size = kept;                                                      \
+    assertr_status(_arraylist_shrink(name)(list), ST_ALLOC_FAIL);           \
+    return ST_OK;                                                           \
 }
 
 #endif /* CTOOL_TYPE_ARRAYLIST_H */
\ No newline at end of file
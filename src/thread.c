@@ -12,63 +12,689 @@
  */
     /* includes */
 #include "ctool/thread.h" /* this */
-#include <time.h> /* sleep */
+#include <stdint.h> /* uint64_t */
+#include <string.h> /* memset() */
+#include <unistd.h> /* write(), close() */
+#ifdef __linux__
+    #include <sys/eventfd.h> /* eventfd */
+#endif
 #include "ctool/assert/runtime.h" /* runtime assertions */
 #include "ctool/iteration.h" /* range iteration */
 
-    /* static content */
-/**
- * Default time for waiting (100 milliseconds)
- */
-const struct timespec idle_time = { 0, 100000000 };
-
     /* defines */
 /**
  * Initializes a thread instance and
- * executes a task list on it
+ * executes tasks of a task manager on it
  * 
  * @param[in] thread Pointer to the thread
- * @param[in] tasks  The task list
+ * @param[in] worker The worker of a task manager
+ * 
+ * @return 0 if everything is OK
+ */
+#ifdef CTOOL_THREAD_USE_POSIX
+    #define thread_initialize(thread, worker) pthread_create(thread, NULL, (task_function_t) &task_thread_main, worker)
+#else
+    #define thread_initialize(thread, worker) thrd_create(thread, (task_function_t) &task_thread_main, worker)
+#endif
+
+/**
+ * Waits for a thread to exit
+ * 
+ * @param[in] thread The thread
  * 
  * @return 0 if everything is OK
  */
 #ifdef CTOOL_THREAD_USE_POSIX
-    #define thread_initialize(thread, tasks) pthread_create(thread, NULL, (task_function_t) &task_thread_main, tasks)
+    #define thread_join(thread) pthread_join(thread, NULL)
+#else
+    #define thread_join(thread) thrd_join(thread, NULL)
+#endif
+
+/**
+ * Worker statistics operations, 
+ * compiled out unless `CTOOL_THREAD_STATS` is defined
+ * 
+ * Only the worker updates its own counters,
+ * so they are not read-modify-written atomically.
+ * 
+ * @param[in] worker The worker
+ * @param[in] field  Name of the counter
+ * @param[in] value  Value to add
+ * @param[in] start  Start time of a task
+ */
+#ifdef CTOOL_THREAD_STATS
+    #define task_worker_stats_time() _ctool_thread_time()
+    #define task_worker_stats_add(worker, field, value) \
+        atomic_store_explicit(&(worker)->counters.field, \
+            atomic_load_explicit(&(worker)->counters.field, memory_order_relaxed) + (value), memory_order_relaxed)
+    #define task_worker_stats_task(worker, start) task_worker_record(worker, start)
 #else
-    #define thread_initialize(thread, tasks) thrd_create(&manager->pool.data[i], (task_function_t) &task_thread_main, tasks)
+    #define task_worker_stats_time() 0
+    #define task_worker_stats_add(worker, field, value) ((void) (value))
+    #define task_worker_stats_task(worker, start) ((void) (start))
 #endif
 
+/**
+ * Time in nanoseconds after which a worker waiting for
+ * a future or a parallel loop looks for tasks to execute again
+ */
+#define TASK_FUTURE_HELP_INTERVAL 1000000
+
+    /* typedefs */
+/**
+ * Shared state of a parallel loop
+ * 
+ * The executed indices are counted in `done`. The state
+ * is freed by the last of the caller and the loop tasks
+ * to drop its reference, so a loop task that starts
+ * after the loop is done does not touch freed memory.
+ */
+typedef struct task_range_t {
+    atomic_size_t next;
+    atomic_size_t done;
+    atomic_size_t references;
+    size_t end;
+    size_t size;
+    size_t grain;
+    size_t workers;
+    task_range_function_t function;
+    task_input_t context;
+    task_manager_t* manager;
+} task_range_t;
+
+    /* variables */
+/**
+ * Worker running the current thread
+ */
+static _Thread_local task_worker_t* task_worker_self = NULL;
+
     /* functions */
 /**
- * Executes a task list concurrently with
- * other threads
+ * Checks if the calling thread is a worker
+ * of a task manager
+ * 
+ * @param[in] manager The task manager
+ */
+static inline bool task_manager_is_worker(task_manager_t* manager) {
+    return task_worker_self != NULL && task_worker_self->manager == manager;
+}
+
+/**
+ * Marks the current task list of a task manager
+ * as complete and notifies the waiting threads
+ * 
+ * @param[in] manager The task manager
+ */
+static void task_manager_complete(task_manager_t* manager) {
+    _ctool_mutex_lock(&manager->lock);
+    if (manager->tasks.status == CTOOL_TASK_LIST_RUNNING) {
+        manager->tasks.status = CTOOL_TASK_LIST_WAITING;
+    }
+    if (manager->eventfd >= 0) {
+        uint64_t value = 1;
+        if (write(manager->eventfd, &value, sizeof(value)) != sizeof(value)) {
+            logw("failed to signal the eventfd of a task manager");
+        }
+    }
+    _ctool_cond_broadcast(&manager->finished);
+    _ctool_mutex_unlock(&manager->lock);
+}
+
+/**
+ * Wakes up the threads waiting on the `finished`
+ * condition, if there are any
+ * 
+ * @param[in] manager The task manager
+ */
+static inline void task_manager_notify(task_manager_t* manager) {
+    if (atomic_load(&manager->waiters) > 0) {
+        _ctool_mutex_lock(&manager->lock);
+        _ctool_cond_broadcast(&manager->finished);
+        _ctool_mutex_unlock(&manager->lock);
+    }
+}
+
+/**
+ * Stores the output of a task in its future 
+ * and executes the subscribed callback
+ * 
+ * @param[in] future The future
+ * @param[in] output Output of the task
+ */
+static inline void task_future_complete(task_future_t* future, task_output_t output) {
+    future->output = output;
+    atomic_store(&future->ready, true);
+    /* a subscriber that is still registering sees the future ready */
+    int expected = CTOOL_TASK_FUTURE_SUBSCRIBED;
+    if (atomic_compare_exchange_strong(&future->subscribed, &expected, CTOOL_TASK_FUTURE_FREE)) {
+        future->callback.function(future->callback.input);
+    }
+}
+
+/**
+ * Executes a task of the current task list, 
+ * stores its output if the list has futures
+ * and completes the list if it was the last task
+ * 
+ * @param[in] manager The task manager
+ * @param[in] task    The task
+ */
+static inline void task_manager_execute(task_manager_t* manager, task_t* task) {
+    task_output_t output = task->function(task->input);
+    if (manager->tasks.futures != NULL) {
+        task_future_complete(&manager->tasks.futures[task - manager->tasks.data], output);
+        task_manager_notify(manager);
+    }
+    if (atomic_fetch_sub(&manager->tasks.pending, 1) == 1) {
+        task_manager_complete(manager);
+    }
+}
+
+/**
+ * Checks if a task list is cancelled
+ * or has reached its deadline
  * 
  * @param[in] tasks The task list
+ */
+static inline bool task_list_is_cancelled(task_list_t* tasks) {
+    return (tasks->cancel != NULL && task_cancel_is_requested(tasks->cancel))
+        || (tasks->deadline != 0 && _ctool_thread_time() >= tasks->deadline);
+}
+
+/**
+ * Skips a task of the current task list instead
+ * of executing it, its future receives the default output
  * 
- * @return Default task output
+ * @param[in] manager The task manager
+ * @param[in] task    The task
+ */
+static void task_manager_skip(task_manager_t* manager, task_t* task) {
+    atomic_fetch_add_explicit(&manager->tasks.cancelled, 1, memory_order_relaxed);
+    if (manager->tasks.futures != NULL) {
+        task_future_complete(&manager->tasks.futures[task - manager->tasks.data], task_output_default);
+        task_manager_notify(manager);
+    }
+    if (atomic_fetch_sub(&manager->tasks.pending, 1) == 1) {
+        task_manager_complete(manager);
+    }
+}
+
+#ifdef CTOOL_THREAD_STATS
+/**
+ * Records an executed task in the statistics of a worker
+ * 
+ * @param[in] worker The worker
+ * @param[in] start  Start time of the task
+ */
+static void task_worker_record(task_worker_t* worker, uint64_t start) {
+    uint64_t elapsed = _ctool_thread_time() - start;
+    task_worker_stats_add(worker, executed, 1);
+    task_worker_stats_add(worker, busy, elapsed);
+    if (elapsed > atomic_load_explicit(&worker->counters.longest, memory_order_relaxed)) {
+        atomic_store_explicit(&worker->counters.longest, elapsed, memory_order_relaxed);
+    }
+}
+#endif
+
+/**
+ * Checks if every queue of a task manager is empty
+ * 
+ * @param[in] manager The task manager
+ */
+static inline bool task_manager_queues_empty(task_manager_t* manager) {
+    iterate_array(i, CTOOL_TASK_PRIORITIES) {
+        if (!task_queue_is_empty(&manager->queues[i])) {
+            return false;
+        }
+    }
+    return true;
+}
+
+/**
+ * Executes a task from the queues of a task manager,
+ * if there is one, scanning specified number of
+ * priority levels from the highest one
+ * 
+ * Every `aging`-th call of a worker scans all 
+ * levels from the lowest one instead.
+ * 
+ * @param[in] worker The worker
+ * @param[in] levels Number of levels to scan
+ * 
+ * @return false if the scanned queues are empty, otherwise true
  */
-task_output_t task_thread_main(task_list_t* tasks) {
-    while (tasks->status != CTOOL_TASK_LIST_STOPPED) {
-        /* wait for new tasks */
-        if (tasks->status == CTOOL_TASK_LIST_WAITING) {
-            nanosleep(&idle_time, NULL);
+static bool task_worker_execute_queued(task_worker_t* worker, size_t levels) {
+    task_manager_t* manager = worker->manager;
+    bool aging = manager->aging != 0 && ++worker->picks % manager->aging == 0;
+    if (atomic_load_explicit(&manager->queued, memory_order_relaxed) == 0) {
+        return false;
+    }
+
+    task_t task;
+    size_t count = aging ? CTOOL_TASK_PRIORITIES : levels;
+    iterate_array(i, count) {
+        size_t level = aging ? CTOOL_TASK_PRIORITIES - 1 - i : i;
+        if (task_queue_pop(&manager->queues[level], &task)) {
+            uint64_t start = task_worker_stats_time();
+            task.function(task.input);
+            task_worker_stats_task(worker, start);
+            if (atomic_fetch_sub(&manager->queued, 1) == 1) {
+                task_manager_notify(manager);
+            }
+            return true;
+        }
+    }
+    return false;
+}
+
+/**
+ * Executes tasks of the current task list
+ * by taking indices from its shared atomic index
+ * 
+ * Queued tasks of high and normal priority are
+ * executed first, so they are not delayed until
+ * the task list is exhausted.
+ * 
+ * @param[in] worker The worker
+ */
+static void task_worker_run_shared(task_worker_t* worker) {
+    task_list_t* tasks = &worker->manager->tasks;
+    while (tasks->status == CTOOL_TASK_LIST_RUNNING && !worker->manager->paused) {
+        if (task_worker_execute_queued(worker, CTOOL_TASK_PRIORITY_LOW)) {
+            continue;
         }
 
         /* get a task index safely */
         size_t index = atomic_fetch_add(&tasks->index, 1);
         if (index >= tasks->size) {
-            /* out of tasks, go to sleep */
-            tasks->status = CTOOL_TASK_LIST_WAITING;
+            /* out of tasks */
+            break;
+        }
+        if (task_list_is_cancelled(tasks)) {
+            task_manager_skip(worker->manager, &tasks->data[index]);
+            continue;
+        }
+
+        /* execute a task */
+        uint64_t start = task_worker_stats_time();
+        task_manager_execute(worker->manager, &tasks->data[index]);
+        task_worker_stats_task(worker, start);
+    }
+}
+
+/**
+ * Steals a task from the deques of other workers,
+ * starting from the closest neighbour
+ * 
+ * @param[in] worker The worker
+ * 
+ * @return The task or NULL if all deques are empty
+ */
+static task_t* task_worker_steal(task_worker_t* worker) {
+    thread_pool_t* pool = &worker->manager->pool;
+    iterate_range_single(i, 1, pool->size) {
+        task_worker_t* victim = &pool->workers[(worker->index + i) % pool->size];
+        task_t* task = task_deque_steal(&victim->deque);
+        if (task != NULL) {
+            task_worker_stats_add(worker, steals, 1);
+            return task;
+        }
+        task_worker_stats_add(worker, misses, 1);
+    }
+    return NULL;
+}
+
+/**
+ * Executes tasks of the current task list
+ * from the deque of a worker, stealing tasks
+ * from other workers when it is empty
+ * 
+ * No tasks are pushed while a list is running, 
+ * so once every deque is found empty, 
+ * the list is exhausted. Queued tasks of high 
+ * and normal priority are executed first.
+ * 
+ * @param[in] worker The worker
+ */
+static void task_worker_run_stealing(task_worker_t* worker) {
+    task_list_t* tasks = &worker->manager->tasks;
+    while (tasks->status == CTOOL_TASK_LIST_RUNNING && !worker->manager->paused) {
+        if (task_worker_execute_queued(worker, CTOOL_TASK_PRIORITY_LOW)) {
+            continue;
+        }
+
+        task_t* current = task_deque_pop(&worker->deque);
+        if (current == NULL) {
+            current = task_worker_steal(worker);
+        }
+        if (current == NULL) {
+            /* out of tasks */
+            break;
+        }
+        if (task_list_is_cancelled(tasks)) {
+            task_manager_skip(worker->manager, current);
             continue;
         }
 
         /* execute a task */
-        task_t current = tasks->data[index];
-        current.function(current.input);
+        uint64_t start = task_worker_stats_time();
+        task_manager_execute(worker->manager, current);
+        task_worker_stats_task(worker, start);
+    }
+}
+
+/**
+ * Pins a worker to its CPU and allocates its deque,
+ * then reports to the task manager that it started
+ * 
+ * @note Leaves the manager locked
+ * 
+ * @param[in] worker The worker
+ */
+static void task_worker_start(task_worker_t* worker) {
+    task_manager_t* manager = worker->manager;
+    status_t status = ST_OK;
+    task_worker_self = worker;
+    if (worker->cpu >= 0 && task_affinity_pin(worker->cpu) != ST_OK) {
+        /* keep running unpinned */
+        worker->cpu = -1;
+        worker->node = -1;
+    }
+
+    /* memory is placed on the node that touches it first */
+    if (manager->scheduler == CTOOL_TASK_SCHEDULER_STEALING && atomic_load(&worker->deque.array) == NULL) {
+        status = task_deque_init(&worker->deque, TASK_DEQUE_DEFAULT_SIZE);
+    }
+
+    _ctool_mutex_lock(&manager->lock);
+    manager->started++;
+    if (status != ST_OK) {
+        manager->failed++;
+    }
+    _ctool_cond_broadcast(&manager->finished);
+}
+
+/**
+ * Parks a worker until it is woken up
+ * 
+ * Workers of an elastic pool wait 
+ * at most for the idle timeout.
+ * 
+ * @note Must be called with the manager locked
+ * 
+ * @param[in] worker The worker
+ * 
+ * @return false if the idle timeout has expired, otherwise true
+ */
+static bool task_worker_park(task_worker_t* worker) {
+    task_manager_t* manager = worker->manager;
+    if (manager->pool.minimum == manager->pool.capacity) {
+        _ctool_cond_wait(&manager->wakeup, &manager->lock);
+        return true;
+    }
+    struct timespec deadline;
+    _ctool_thread_deadline(&deadline, manager->pool.idle_timeout);
+    return _ctool_cond_timedwait(&manager->wakeup, &manager->lock, &deadline) == 0;
+}
+
+/**
+ * Retires a worker if it is the last running
+ * worker and the pool is above its minimum size
+ * 
+ * @note Must be called with the manager locked
+ * 
+ * @param[in] worker The worker
+ * 
+ * @return true if the worker is retired
+ */
+static bool task_worker_retire(task_worker_t* worker) {
+    thread_pool_t* pool = &worker->manager->pool;
+    if (worker->index + 1 != pool->size || pool->size <= pool->minimum) {
+        return false;
     }
+    atomic_store(&pool->size, worker->index);
+    return true;
+}
+
+/**
+ * Executes task lists and queued tasks of 
+ * a task manager concurrently with other threads
+ * 
+ * When there is no work, the thread is parked
+ * on a condition variable until a new task list
+ * is submitted or a task is enqueued, so idle 
+ * workers use no CPU time. An elastic pool retires
+ * its last worker once it stays parked 
+ * for the idle timeout.
+ * 
+ * A paused worker leaves the task list
+ * and stays parked until it is resumed.
+ * 
+ * @param[in] worker The worker
+ * 
+ * @return Default task output
+ */
+task_output_t task_thread_main(task_worker_t* worker) {
+    task_manager_t* manager = worker->manager;
+    task_list_t* tasks = &manager->tasks;
+    size_t sequence = 0;
+    bool retired = false;
+
+    task_worker_start(worker);
+    while (true) {
+        /* wait for new tasks, the producers check the sleepers after enqueueing */
+        atomic_fetch_add(&manager->sleepers, 1);
+        if (manager->paused) {
+            /* task_manager_pause() waits for every worker to park */
+            _ctool_cond_broadcast(&manager->finished);
+        }
+        uint64_t parked = task_worker_stats_time();
+        bool expired = false;
+        while (tasks->status != CTOOL_TASK_LIST_STOPPED && (manager->paused 
+                || (manager->sequence == sequence && task_manager_queues_empty(manager)))) {
+            if (expired && task_worker_retire(worker)) {
+                retired = true;
+                break;
+            }
+            expired = !task_worker_park(worker);
+            if (!expired) {
+                task_worker_stats_add(worker, wakeups, 1);
+            }
+        }
+        task_worker_stats_add(worker, idle, task_worker_stats_time() - parked);
+        atomic_fetch_sub(&manager->sleepers, 1);
+        if (retired || tasks->status == CTOOL_TASK_LIST_STOPPED) {
+            break;
+        }
+
+        if (manager->sequence != sequence) {
+            /* enter the task list */
+            sequence = manager->sequence;
+            manager->active++;
+            _ctool_mutex_unlock(&manager->lock);
+
+            if (manager->scheduler == CTOOL_TASK_SCHEDULER_STEALING) {
+                task_worker_run_stealing(worker);
+            } else {
+                task_worker_run_shared(worker);
+            }
+
+            /* leave the task list */
+            _ctool_mutex_lock(&manager->lock);
+            manager->active--;
+            if (manager->active == 0) {
+                _ctool_cond_broadcast(&manager->finished);
+            }
+            if (manager->paused) {
+                /* enter the list again once resumed */
+                sequence--;
+            }
+        }
+        _ctool_mutex_unlock(&manager->lock);
+
+        /* drain the queues, then go to sleep */
+        while (tasks->status != CTOOL_TASK_LIST_STOPPED && !manager->paused
+            && task_worker_execute_queued(worker, CTOOL_TASK_PRIORITIES));
+        _ctool_mutex_lock(&manager->lock);
+    }
+    _ctool_mutex_unlock(&manager->lock);
     return task_output_default;
 }
 
+/**
+ * Splits a task list across the deques of the workers,
+ * so that each worker pops a contiguous block of tasks
+ * in the original order
+ * 
+ * @note Must be called with the manager locked
+ *       and no workers inside a task list
+ * 
+ * @param[in] manager The task manager
+ * @param[in] tasks   The task list
+ * 
+ * @return ST_ALLOC_FAIL if an allocation fails, otherwise ST_OK
+ */
+static status_t task_manager_distribute(task_manager_t* manager, task_list_t* tasks) {
+    size_t threads = manager->pool.size;
+    iterate_array(i, threads) {
+        task_deque_t* deque = &manager->pool.workers[i].deque;
+        size_t start = tasks->size * i / threads;
+        size_t end = tasks->size * (i + 1) / threads;
+
+        /* push in reverse, the owner pops from the bottom */
+        for (size_t j = end; j > start; j--) {
+            if (task_deque_push(deque, &tasks->data[j - 1]) != ST_OK) {
+                /* take back everything that was pushed */
+                iterate_array(k, i + 1) {
+                    while (task_deque_pop(&manager->pool.workers[k].deque) != NULL);
+                }
+                assertrc_fail(ST_ALLOC_FAIL, "failed to distribute %zu tasks across %zu workers", tasks->size, threads)
+            }
+        }
+    }
+    return ST_OK;
+}
+
+/**
+ * Starts a worker in the next free slot of an 
+ * elastic pool, if there are more enqueued tasks
+ * than running workers and none of them is parked
+ * 
+ * @param[in] manager The task manager
+ */
+static void task_manager_grow(task_manager_t* manager) {
+    thread_pool_t* pool = &manager->pool;
+    _ctool_mutex_lock(&manager->lock);
+    size_t index = pool->size;
+    if (index < pool->capacity && manager->tasks.status != CTOOL_TASK_LIST_STOPPED
+            && atomic_load(&manager->sleepers) == 0 && atomic_load(&manager->queued) > index) {
+        task_worker_t* worker = &pool->workers[index];
+        if (worker->joinable) {
+            /* the retired thread has released the lock and is exiting */
+            thread_join(pool->data[index]);
+            worker->joinable = false;
+        }
+
+        /* a retired worker keeps its empty deque */
+        if (manager->scheduler == CTOOL_TASK_SCHEDULER_STEALING && atomic_load(&worker->deque.array) == NULL
+                && task_deque_init(&worker->deque, TASK_DEQUE_DEFAULT_SIZE) != ST_OK) {
+            logw("failed to allocate a deque for a new worker");
+        } else if (thread_initialize(&pool->data[index], worker) != 0) {
+            logw("failed to start a new worker");
+        } else {
+            worker->joinable = true;
+            atomic_store(&pool->size, index + 1);
+        }
+    }
+    _ctool_mutex_unlock(&manager->lock);
+}
+
+/**
+ * Initializes synchronization primitives of
+ * a task manager and starts its thread pool
+ * 
+ * @param[in] manager The task manager
+ * @param[in] options The options
+ * 
+ * @return ST_BAD_ARG if `threads` is out of the bounds,
+ *         ST_ALLOC_FAIL if an allocation fails, 
+ *         ST_FAIL if thread initialization fails,
+ *          otherwise ST_OK
+ */
+static status_t task_manager_start(task_manager_t* manager, task_manager_options_t options) {
+    size_t threads = options.threads;
+    size_t minimum = options.min_threads != 0 ? options.min_threads : threads;
+    size_t capacity = options.max_threads != 0 ? options.max_threads : threads;
+    assertrc_true(minimum <= threads && threads <= capacity, ST_BAD_ARG,
+        "%zu threads are out of the bounds from %zu to %zu", threads, minimum, capacity)
+    manager->scheduler = options.scheduler;
+    manager->pool.size = threads;
+    manager->pool.minimum = minimum;
+    manager->pool.capacity = capacity;
+    manager->pool.idle_timeout = options.idle_timeout != 0 ? options.idle_timeout : TASK_MANAGER_DEFAULT_IDLE_TIMEOUT;
+    assertr_malloc(manager->pool.data, sizeof(thread_t) * capacity, thread_t*)
+    assertr_malloc(manager->pool.workers, sizeof(task_worker_t) * capacity, task_worker_t*)
+
+    /* round the buffers up to whole cache lines, so that workers don't share them */
+    size_t scratch_size = (options.scratch_size + CTOOL_CACHE_LINE - 1) / CTOOL_CACHE_LINE * CTOOL_CACHE_LINE;
+    manager->pool.scratch_size = scratch_size;
+    manager->pool.scratch = NULL;
+    if (scratch_size != 0) {
+        manager->pool.scratch = aligned_alloc(CTOOL_CACHE_LINE, scratch_size * capacity);
+        assertrc_true(manager->pool.scratch != NULL, ST_ALLOC_FAIL,
+            "failed to allocate %zu bytes of scratch buffers", scratch_size * capacity)
+        memset(manager->pool.scratch, 0, scratch_size * capacity);
+    }
+    task_topology_t topology = { 0 };
+    if (options.affinity != CTOOL_TASK_AFFINITY_NONE && task_topology_init(&topology) != ST_OK) {
+        logw("cpu topology is unavailable, workers won't be pinned");
+    }
+    iterate_array(i, capacity) {
+        task_worker_t* worker = &manager->pool.workers[i];
+        worker->manager = manager;
+        worker->index = i;
+        worker->picks = 0;
+        worker->joinable = false;
+        worker->scratch = scratch_size != 0 ? manager->pool.scratch + scratch_size * i : NULL;
+        worker->data = NULL;
+        task_topology_place(&topology, options.affinity, i, &worker->cpu, &worker->node);
+        atomic_init(&worker->deque.array, NULL);
+        worker->counters = (task_worker_counters_t) { 0 };
+    }
+    task_topology_free(&topology);
+
+    manager->active = 0;
+    manager->started = 0;
+    manager->failed = 0;
+    manager->waiters = 0;
+    manager->sleepers = 0;
+    manager->queued = 0;
+    manager->paused = false;
+    manager->aging = options.aging;
+    iterate_array(i, CTOOL_TASK_PRIORITIES) {
+        assertr_status(task_queue_init(&manager->queues[i], 
+            options.queue_size != 0 ? options.queue_size : TASK_QUEUE_DEFAULT_SIZE), ST_FAIL);
+    }
+    manager->eventfd = -1;
+    assertr_zero(_ctool_mutex_init(&manager->lock), ST_FAIL);
+    assertr_zero(_ctool_cond_init(&manager->wakeup), ST_FAIL);
+    assertr_zero(_ctool_cond_init(&manager->finished), ST_FAIL);
+    iterate_array(i, threads) {
+        assertr_zero(thread_initialize(&manager->pool.data[i], &manager->pool.workers[i]), 
+            ST_FAIL);
+        manager->pool.workers[i].joinable = true;
+    }
+
+    /* wait for the workers to allocate their deques */
+    _ctool_mutex_lock(&manager->lock);
+    while (manager->started < threads) {
+        _ctool_cond_wait(&manager->finished, &manager->lock);
+    }
+    _ctool_mutex_unlock(&manager->lock);
+    assertrc_zero(manager->failed, ST_ALLOC_FAIL, "failed to initialize %zu workers", manager->failed)
+    return ST_OK;
+}
+
 /**
  * Creates a new task manager with specified
  * number of threads in a thread pool
@@ -81,17 +707,31 @@ task_output_t task_thread_main(task_list_t* tasks) {
  *          otherwise ST_OK
  */
 status_t task_manager_create(task_manager_t* manager, size_t threads) {
-    manager->pool.size = threads;
-    assertr_malloc(manager->pool.data, sizeof(thread_t) * threads, thread_t*)
+    return task_manager_create_custom(manager, (task_manager_options_t) { .threads = threads });
+}
+
+/**
+ * Creates a new task manager with custom options
+ * 
+ * @param[in] manager The task manager
+ * @param[in] options The options
+ * 
+ * @return ST_ALLOC_FAIL if an allocation fails, 
+ *         ST_FAIL if thread initialization fails,
+ *          otherwise ST_OK
+ */
+status_t task_manager_create_custom(task_manager_t* manager, task_manager_options_t options) {
     manager->tasks.status = CTOOL_TASK_LIST_WAITING;
     manager->tasks.data = NULL;
     manager->tasks.index = 0;
+    manager->tasks.pending = 0;
     manager->tasks.size = 0;
-    iterate_array(i, threads) {
-        assertr_zero(thread_initialize(&manager->pool.data[i], &manager->tasks), 
-            ST_FAIL);
-    }
-    return ST_OK;
+    manager->tasks.futures = NULL;
+    manager->tasks.cancel = NULL;
+    manager->tasks.deadline = 0;
+    manager->tasks.cancelled = 0;
+    manager->sequence = 0;
+    return task_manager_start(manager, options);
 }
 
 /**
@@ -108,57 +748,802 @@ status_t task_manager_create(task_manager_t* manager, size_t threads) {
  *          otherwise ST_OK
  */
 status_t task_manager_create_run(task_manager_t* manager, task_list_t tasks, size_t threads) {
-    manager->pool.size = threads;
-    assertr_malloc(manager->pool.data, sizeof(thread_t) * threads, thread_t*)
     manager->tasks = tasks;
-    iterate_array(i, threads) {
-        assertr_zero(thread_initialize(&manager->pool.data[i], &manager->tasks), 
-            ST_FAIL);
+    /* nothing to execute in an empty list */
+    if (tasks.size == 0) {
+        manager->tasks.status = CTOOL_TASK_LIST_WAITING;
     }
-    return ST_OK;
+    manager->sequence = 1;
+    return task_manager_start(manager, (task_manager_options_t) { .threads = threads });
 }
 
 /**
- * Deletes a task manager
+ * Stops the worker threads of a task manager
+ * and waits for them to exit
  * 
- * The task list is freed automatically.
+ * The joined workers are no longer joinable,
+ * so stopping twice is harmless.
  * 
  * @param[in] manager The task manager
  */
-void task_manager_delete(task_manager_t* manager) {
+static void task_manager_stop(task_manager_t* manager) {
+    _ctool_mutex_lock(&manager->lock);
     manager->tasks.status = CTOOL_TASK_LIST_STOPPED;
-    free(manager->pool.data);
-    task_list_free(&manager->tasks);
+    _ctool_cond_broadcast(&manager->wakeup);
+    _ctool_cond_broadcast(&manager->finished);
+    _ctool_mutex_unlock(&manager->lock);
+
+    /* the workers still use the manager, wait for them to exit */
+    iterate_array(i, manager->pool.capacity) {
+        if (manager->pool.workers[i].joinable) {
+            thread_join(manager->pool.data[i]);
+            manager->pool.workers[i].joinable = false;
+        }
+    }
 }
 
 /**
- * Submits a task list to a task manager
+ * Deletes a task manager
  * 
- * Previous task list is freed automatically.
+ * The worker threads are stopped and joined,
+ * the task list is freed automatically. Tasks that
+ * have not started yet are abandoned, use
+ * task_manager_shutdown() first to finish them.
  * 
  * @param[in] manager The task manager
- * @param[in] tasks   The task list
+ */
+void task_manager_delete(task_manager_t* manager) {
+    task_manager_stop(manager);
+    if (manager->eventfd >= 0) {
+        close(manager->eventfd);
+    }
+    _ctool_cond_destroy(&manager->finished);
+    _ctool_cond_destroy(&manager->wakeup);
+    _ctool_mutex_destroy(&manager->lock);
+    iterate_array(i, manager->pool.capacity) {
+        task_deque_free(&manager->pool.workers[i].deque);
+    }
+    free(manager->pool.workers);
+    free(manager->pool.data);
+    free(manager->pool.scratch);
+    iterate_array(i, CTOOL_TASK_PRIORITIES) {
+        task_queue_free(&manager->queues[i]);
+    }
+    task_list_free(&manager->tasks);
+}
+
+/**
+ * Finishes every task of a task manager,
+ * then stops and joins the worker threads
  * 
- * @return ST_FAIL if previous task list is still running,
- *          otherwise ST_OK
+ * A paused task manager is resumed first. Tasks can
+ * no longer be submitted or enqueued afterwards,
+ * the task manager still has to be deleted.
+ * 
+ * @param[in] manager The task manager
+ */
+void task_manager_shutdown(task_manager_t* manager) {
+    task_manager_resume(manager);
+    task_manager_await(manager);
+    task_manager_stop(manager);
+}
+
+/**
+ * Pauses a task manager and waits until
+ * every worker is parked
+ * 
+ * Running tasks return normally, then the workers
+ * take no more tasks until task_manager_resume().
+ * Tasks can still be submitted and enqueued meanwhile.
+ * Must not be called from inside a task.
+ * 
+ * @param[in] manager The task manager
+ */
+void task_manager_pause(task_manager_t* manager) {
+    _ctool_mutex_lock(&manager->lock);
+    manager->paused = true;
+    while (manager->tasks.status != CTOOL_TASK_LIST_STOPPED && manager->sleepers < manager->pool.size) {
+        _ctool_cond_wait(&manager->finished, &manager->lock);
+    }
+    _ctool_mutex_unlock(&manager->lock);
+}
+
+/**
+ * Resumes a paused task manager, the workers
+ * continue where they have stopped
+ * 
+ * @param[in] manager The task manager
+ */
+void task_manager_resume(task_manager_t* manager) {
+    _ctool_mutex_lock(&manager->lock);
+    manager->paused = false;
+    _ctool_cond_broadcast(&manager->wakeup);
+    _ctool_mutex_unlock(&manager->lock);
+}
+
+/**
+ * Submits a task list to a task manager
+ * 
+ * Previous task list is freed automatically.
+ * Parked workers are woken up immediately.
+ * Only one task list runs at a time, so a task 
+ * of the list can't submit another one, it should
+ * enqueue the tasks or use task_manager_parallel_for().
+ * 
+ * @param[in] manager The task manager
+ * @param[in] tasks   The task list
+ * 
+ * @return ST_FAIL if previous task list is still running
+ *          or the task manager is shut down,
+ *         ST_ALLOC_FAIL if the tasks can't be distributed
+ *          across the workers, otherwise ST_OK
  */
 status_t task_manager_submit(task_manager_t* manager, task_list_t tasks) {
-    assertrc_false(manager->tasks.status == CTOOL_TASK_LIST_RUNNING, ST_FAIL, 
-        "previous tasks haven't completed yet, use task_manager_await() to wait for them")
+    _ctool_mutex_lock(&manager->lock);
+    if (manager->tasks.status == CTOOL_TASK_LIST_RUNNING) {
+        _ctool_mutex_unlock(&manager->lock);
+        assertrc_false(task_manager_is_worker(manager), ST_FAIL, 
+            "a task can't submit a task list while another one is running, enqueue the tasks instead")
+        assertrc_fail(ST_FAIL, "previous tasks haven't completed yet, use task_manager_await() to wait for them")
+    }
+    if (manager->tasks.status == CTOOL_TASK_LIST_STOPPED) {
+        _ctool_mutex_unlock(&manager->lock);
+        assertrc_fail(ST_FAIL, "the task manager is shut down")
+    }
+
+    /* wait for the workers to leave the previous task list */
+    while (manager->active > 0) {
+        _ctool_cond_wait(&manager->finished, &manager->lock);
+    }
+    if (manager->scheduler == CTOOL_TASK_SCHEDULER_STEALING) {
+        status_t status = task_manager_distribute(manager, &tasks);
+        if (status != ST_OK) {
+            _ctool_mutex_unlock(&manager->lock);
+            return status;
+        }
+    }
     task_list_free(&manager->tasks);
-    manager->tasks = tasks;
+
+    /* the status is read by draining workers, so it is not copied with the list */
+    manager->tasks.data = tasks.data;
+    manager->tasks.size = tasks.size;
+    manager->tasks.futures = tasks.futures;
+    manager->tasks.cancel = tasks.cancel;
+    manager->tasks.deadline = tasks.deadline;
+    manager->tasks.index = tasks.index;
+    manager->tasks.pending = tasks.pending;
+    manager->tasks.cancelled = tasks.cancelled;
+    /* nothing to execute in an empty list */
+    manager->tasks.status = tasks.size != 0 ? tasks.status : CTOOL_TASK_LIST_WAITING;
+
+    /* wake up as many workers as there are tasks */
+    manager->sequence++;
+    if (tasks.size >= manager->pool.size) {
+        _ctool_cond_broadcast(&manager->wakeup);
+    } else {
+        iterate_array(i, tasks.size) {
+            _ctool_cond_signal(&manager->wakeup);
+        }
+    }
+    _ctool_mutex_unlock(&manager->lock);
     return ST_OK;
 }
 
+/**
+ * Executes a task from the queues of a task manager
+ * on the calling thread, if there is one and
+ * the task manager is not paused
+ * 
+ * @param[in] manager The task manager
+ * 
+ * @return false if no task was executed, otherwise true
+ */
+static bool task_manager_help_queued(task_manager_t* manager) {
+    if (manager->paused || atomic_load_explicit(&manager->queued, memory_order_relaxed) == 0) {
+        return false;
+    }
+    task_t task;
+    iterate_array(level, CTOOL_TASK_PRIORITIES) {
+        if (task_queue_pop(&manager->queues[level], &task)) {
+            task.function(task.input);
+            if (atomic_fetch_sub(&manager->queued, 1) == 1) {
+                task_manager_notify(manager);
+            }
+            return true;
+        }
+    }
+    return false;
+}
+
+/**
+ * Executes tasks of the current task list of
+ * a task manager on the calling thread
+ * 
+ * The calling thread takes tasks from the shared index, 
+ * or steals them from the workers, as a worker would.
+ * It is counted in `active` meanwhile, so that
+ * the list is not replaced under it.
+ * 
+ * @param[in] manager The task manager
+ * @param[in] limit   Maximal number of tasks to execute
+ * 
+ * @return Number of executed tasks
+ */
+static size_t task_manager_help_list(task_manager_t* manager, size_t limit) {
+    task_list_t* tasks = &manager->tasks;
+    size_t executed = 0;
+    if (tasks->status != CTOOL_TASK_LIST_RUNNING) {
+        return 0;
+    }
+
+    _ctool_mutex_lock(&manager->lock);
+    if (tasks->status != CTOOL_TASK_LIST_RUNNING) {
+        _ctool_mutex_unlock(&manager->lock);
+        return 0;
+    }
+    manager->active++;
+    _ctool_mutex_unlock(&manager->lock);
+
+    while (executed < limit && tasks->status == CTOOL_TASK_LIST_RUNNING && !manager->paused) {
+        task_t* task = NULL;
+        if (manager->scheduler == CTOOL_TASK_SCHEDULER_STEALING) {
+            for (size_t i = 0; i < manager->pool.size && task == NULL; i++) {
+                task = task_deque_steal(&manager->pool.workers[i].deque);
+            }
+        } else {
+            size_t index = atomic_fetch_add(&tasks->index, 1);
+            task = index < tasks->size ? &tasks->data[index] : NULL;
+        }
+        if (task == NULL) {
+            /* out of tasks */
+            break;
+        }
+        if (task_list_is_cancelled(tasks)) {
+            task_manager_skip(manager, task);
+        } else {
+            task_manager_execute(manager, task);
+        }
+        executed++;
+    }
+
+    _ctool_mutex_lock(&manager->lock);
+    manager->active--;
+    if (manager->active == 0) {
+        _ctool_cond_broadcast(&manager->finished);
+    }
+    _ctool_mutex_unlock(&manager->lock);
+    return executed;
+}
+
+/**
+ * Executes one queued task or one task of the current
+ * task list of a task manager on the calling thread
+ * 
+ * A task waiting for other tasks can call it in a loop,
+ * so that the awaited tasks make progress even if
+ * every worker is busy.
+ * 
+ * @param[in] manager The task manager
+ * 
+ * @return false if there was no task to execute, otherwise true
+ */
+bool task_manager_help(task_manager_t* manager) {
+    return task_manager_help_queued(manager) || task_manager_help_list(manager, 1) > 0;
+}
+
+/**
+ * Executes tasks of a task manager on the calling thread
+ * until a condition is met, and sleeps while there
+ * are no tasks to execute
+ * 
+ * The thread that meets the condition has to call
+ * task_manager_notify() afterwards. A worker of the task
+ * manager looks for new tasks from time to time while
+ * sleeping, since the other workers may be waiting too.
+ * 
+ * @param[in] manager The task manager
+ * @param[in] done    The condition
+ * @param[in] state   State passed to the condition
+ */
+static void task_manager_help_until(task_manager_t* manager, bool (*done)(void*), void* state) {
+    bool worker = task_manager_is_worker(manager);
+    while (!done(state)) {
+        if (task_manager_help(manager)) {
+            continue;
+        }
+
+        /* register as a waiter before checking again, so the broadcast is not missed */
+        atomic_fetch_add(&manager->waiters, 1);
+        _ctool_mutex_lock(&manager->lock);
+        if (!worker) {
+            while (!done(state)) {
+                _ctool_cond_wait(&manager->finished, &manager->lock);
+            }
+        } else if (!done(state)) {
+            struct timespec deadline;
+            _ctool_thread_deadline(&deadline, TASK_FUTURE_HELP_INTERVAL);
+            _ctool_cond_timedwait(&manager->finished, &manager->lock, &deadline);
+        }
+        _ctool_mutex_unlock(&manager->lock);
+        atomic_fetch_sub(&manager->waiters, 1);
+    }
+}
+
+/**
+ * Waits for a task manager to finish all tasks,
+ * executing them on the calling thread meanwhile
+ * 
+ * The calling thread takes tasks of the current list
+ * until it is drained, then the queued tasks, and 
+ * then sleeps until the tasks still running 
+ * on the workers return. Fails inside of a task
+ * like task_manager_await(), see task_future_await().
+ * 
+ * @param[in] manager The task manager
+ * 
+ * @return ST_FAIL if called from inside a task
+ *          of the task manager, otherwise ST_OK
+ */
+status_t task_manager_await_helping(task_manager_t* manager) {
+    assertrc_false(task_manager_is_worker(manager), ST_FAIL, 
+        "task_manager_await_helping() would wait for the calling task, use task_future_await() instead")
+    task_manager_help_list(manager, SIZE_MAX);
+    while (task_manager_help_queued(manager));
+    return task_manager_await(manager);
+}
+
 /**
  * Waits for a task manager to finish all tasks
  * 
+ * The calling thread is blocked until the last
+ * task of the list and every queued task
+ * returns, without polling. A worker of the task
+ * manager would wait for its own task, so inside
+ * of a task use task_future_await() instead.
+ * 
  * @param[in] manager The task manager
+ * 
+ * @return ST_FAIL if called from inside a task
+ *          of the task manager, otherwise ST_OK
  */
-void task_manager_await(task_manager_t* manager) {
-    while (manager->tasks.status == CTOOL_TASK_LIST_RUNNING) {
-        nanosleep(&idle_time, NULL);
+status_t task_manager_await(task_manager_t* manager) {
+    assertrc_false(task_manager_is_worker(manager), ST_FAIL, 
+        "task_manager_await() would wait for the calling task, use task_future_await() instead")
+    atomic_fetch_add(&manager->waiters, 1);
+    _ctool_mutex_lock(&manager->lock);
+    while (manager->tasks.status == CTOOL_TASK_LIST_RUNNING 
+            || (manager->tasks.status != CTOOL_TASK_LIST_STOPPED && atomic_load(&manager->queued) > 0)) {
+        _ctool_cond_wait(&manager->finished, &manager->lock);
     }
+    _ctool_mutex_unlock(&manager->lock);
+    atomic_fetch_sub(&manager->waiters, 1);
+    return ST_OK;
+}
+
+/**
+ * Appends a task to the normal priority queue 
+ * of a task manager
+ * 
+ * Can be called from any thread at any time, 
+ * including from inside of a task. A parked
+ * worker is woken up to execute the task.
+ * A task enqueueing to its own task manager must
+ * not spin on ST_BUSY, since every worker may be
+ * spinning with nobody left to drain the queue,
+ * it should call task_manager_help() or execute
+ * the task itself instead.
+ * 
+ * @param[in] manager The task manager
+ * @param[in] task    The task
+ * 
+ * @return ST_FAIL if the task manager is shut down,
+ *         ST_BUSY if the queue is full, otherwise ST_OK
+ */
+status_t task_manager_enqueue(task_manager_t* manager, task_t task) {
+    return task_manager_enqueue_priority(manager, task, CTOOL_TASK_PRIORITY_NORMAL);
+}
+
+/**
+ * Appends a task to the queue of specified
+ * priority level of a task manager
+ * 
+ * @param[in] manager  The task manager
+ * @param[in] task     The task
+ * @param[in] priority The priority level
+ * 
+ * @return ST_BAD_ARG if the priority level is invalid,
+ *         ST_FAIL if the task manager is shut down,
+ *         ST_BUSY if the queue is full, otherwise ST_OK
+ */
+status_t task_manager_enqueue_priority(task_manager_t* manager, task_t task, task_priority_t priority) {
+    assertr_false((size_t) priority >= CTOOL_TASK_PRIORITIES, ST_BAD_ARG)
+    assertrc_false(manager->tasks.status == CTOOL_TASK_LIST_STOPPED, ST_FAIL, "the task manager is shut down")
+
+    /* count the task first, so that awaiting does not miss it */
+    atomic_fetch_add(&manager->queued, 1);
+    if (!task_queue_push(&manager->queues[priority], task)) {
+        if (atomic_fetch_sub(&manager->queued, 1) == 1) {
+            task_manager_notify(manager);
+        }
+        return ST_BUSY;
+    }
+
+    /* wake up a worker if every worker might be parked */
+    atomic_thread_fence(memory_order_seq_cst);
+    if (atomic_load(&manager->sleepers) > 0) {
+        _ctool_mutex_lock(&manager->lock);
+        _ctool_cond_signal(&manager->wakeup);
+        _ctool_mutex_unlock(&manager->lock);
+    } else if (manager->pool.size < manager->pool.capacity && atomic_load(&manager->queued) > manager->pool.size) {
+        /* every worker is busy and the tasks are waiting */
+        task_manager_grow(manager);
+    }
+    return ST_OK;
+}
+
+/**
+ * Returns an eventfd descriptor of a task manager,
+ * creating it on the first call
+ * 
+ * The descriptor is non-blocking and becomes readable
+ * when a task list completes, its counter holds 
+ * the number of lists completed since the last read.
+ * It is closed by task_manager_delete().
+ * 
+ * @param[in]  manager The task manager
+ * @param[out] fd      The descriptor
+ * 
+ * @return ST_FAIL if eventfd is unavailable, otherwise ST_OK
+ */
+status_t task_manager_eventfd(task_manager_t* manager, int* fd) {
+#ifdef __linux__
+    _ctool_mutex_lock(&manager->lock);
+    if (manager->eventfd < 0) {
+        manager->eventfd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    }
+    *fd = manager->eventfd;
+    _ctool_mutex_unlock(&manager->lock);
+    assertrc_false(*fd < 0, ST_FAIL, "failed to create an eventfd for the task manager")
+    return ST_OK;
+#else
+    assertrc_fail(ST_FAIL, "eventfd is only available on linux")
+#endif
+}
+
+/**
+ * Takes the next chunk of a parallel loop
+ * 
+ * The index is only advanced up to the end
+ * of the range, so it never wraps around.
+ * 
+ * @param[in]  range The parallel loop
+ * @param[in]  chunk Chunk size
+ * @param[out] begin Chunk start, inclusive
+ * @param[out] end   Chunk end, exclusive
+ * 
+ * @return false if the range is exhausted, otherwise true
+ */
+static bool task_range_take(task_range_t* range, size_t chunk, size_t* begin, size_t* end) {
+    size_t next = atomic_load(&range->next);
+    do {
+        if (next >= range->end) {
+            return false;
+        }
+        *end = range->end - next > chunk ? next + chunk : range->end;
+    } while (!atomic_compare_exchange_weak(&range->next, &next, *end));
+    *begin = next;
+    return true;
+}
+
+/**
+ * Executes chunks of a parallel loop until 
+ * the range is exhausted
+ * 
+ * The chunk size starts at the grain and is doubled
+ * or halved to keep the chunk execution time close 
+ * to TASK_RANGE_CHUNK_TIME, but it never exceeds
+ * a fraction of the remaining indices per worker.
+ * 
+ * @param[in] range The parallel loop
+ */
+static void task_range_execute(task_range_t* range) {
+    size_t chunk = range->grain;
+    size_t begin, end;
+    while (task_range_take(range, chunk, &begin, &end)) {
+        /* execute and time a chunk */
+        uint64_t start = _ctool_thread_time();
+        range->function(begin, end, range->context);
+        uint64_t elapsed = _ctool_thread_time() - start;
+        if (atomic_fetch_add(&range->done, end - begin) + (end - begin) == range->size) {
+            /* the caller may be waiting */
+            task_manager_notify(range->manager);
+        }
+
+        /* adapt the chunk size */
+        if (elapsed < TASK_RANGE_CHUNK_TIME / 2) {
+            chunk *= 2;
+        } else if (elapsed > TASK_RANGE_CHUNK_TIME * 2 && chunk / 2 >= range->grain) {
+            chunk /= 2;
+        }
+
+        /* leave enough chunks for the other workers */
+        size_t next = atomic_load_explicit(&range->next, memory_order_relaxed);
+        size_t remaining = next < range->end ? range->end - next : 0;
+        size_t limit = remaining / (2 * range->workers);
+        if (chunk > limit) {
+            chunk = limit > range->grain ? limit : range->grain;
+        }
+    }
+}
+
+/**
+ * Drops a reference to a parallel loop,
+ * freeing it if it was the last one
+ * 
+ * @param[in] range The parallel loop
+ */
+static void task_range_release(task_range_t* range) {
+    if (atomic_fetch_sub(&range->references, 1) == 1) {
+        free(range);
+    }
+}
+
+/**
+ * Checks if every index of a parallel loop is executed
+ * 
+ * @param[in] range The parallel loop
+ */
+static bool task_range_is_done(void* range) {
+    return atomic_load(&((task_range_t*) range)->done) == ((task_range_t*) range)->size;
+}
+
+/**
+ * Executes chunks of a parallel loop as a queued task
+ * 
+ * @param[in] range The parallel loop
+ * 
+ * @return Default task output
+ */
+static task_output_t task_range_main(task_range_t* range) {
+    task_range_execute(range);
+    task_range_release(range);
+    return task_output_default;
+}
+
+/**
+ * Executes one function over a range of indices
+ * on a task manager and waits for it to finish
+ * 
+ * Indices are handed out in chunks of at least `grain`
+ * indices. Each worker adapts its chunk size to the
+ * measured execution time, so that a chunk takes about
+ * TASK_RANGE_CHUNK_TIME, and shrinks it near the end
+ * of the range to balance the load. No task is
+ * allocated per index.
+ * 
+ * The loop is run by queued tasks and by the calling
+ * thread, which then executes other tasks until the
+ * last chunk returns. It does not depend on the task
+ * list, so loops can run concurrently with a list and
+ * with each other, and can be nested inside of tasks.
+ * 
+ * @param[in] manager  The task manager
+ * @param[in] begin    Range start, inclusive
+ * @param[in] end      Range end, exclusive
+ * @param[in] grain    Minimal chunk size
+ * @param[in] function The range function
+ * @param[in] context  User context passed to the function
+ * 
+ * @return ST_ALLOC_FAIL if an allocation fails,
+ *          otherwise ST_OK
+ */
+status_t task_manager_parallel_for(task_manager_t* manager, size_t begin, size_t end, size_t grain, 
+    task_range_function_t function, task_input_t context) {
+    if (grain == 0) {
+        grain = 1;
+    }
+    if (end <= begin) {
+        return ST_OK;
+    }
+    if (end - begin <= grain) {
+        /* a single chunk, not worth waking the workers */
+        function(begin, end, context);
+        return ST_OK;
+    }
+
+    /* one loop task per worker, the calling worker runs the loop itself */
+    size_t tasks = task_manager_size(manager);
+    if (task_manager_is_worker(manager)) {
+        tasks--;
+    }
+    if (manager->tasks.status == CTOOL_TASK_LIST_STOPPED) {
+        tasks = 0;
+    }
+    task_range_t* range;
+    assertr_malloc(range, sizeof(task_range_t), task_range_t*)
+    atomic_init(&range->next, begin);
+    atomic_init(&range->done, 0);
+    atomic_init(&range->references, tasks + 1);
+    range->end = end;
+    range->size = end - begin;
+    range->grain = grain;
+    range->workers = tasks + 1;
+    range->function = function;
+    range->context = context;
+    range->manager = manager;
+
+    /* a full queue leaves more chunks for the calling thread */
+    task_t task = { .function = (task_function_t) &task_range_main, .input = range };
+    size_t enqueued = 0;
+    while (enqueued < tasks && task_manager_enqueue(manager, task) == ST_OK) {
+        enqueued++;
+    }
+    atomic_fetch_sub(&range->references, tasks - enqueued);
+
+    task_range_execute(range);
+    task_manager_help_until(manager, task_range_is_done, range);
+    task_range_release(range);
+    return ST_OK;
+}
+
+/**
+ * Returns the number of skipped tasks of the
+ * current or the last task list of a task manager
+ * 
+ * The number is final once the list is complete,
+ * for example after task_manager_await().
+ * 
+ * @param[in] manager The task manager
+ * 
+ * @return Number of cancelled tasks
+ */
+size_t task_manager_cancelled(task_manager_t* manager) {
+    return atomic_load(&manager->tasks.cancelled);
+}
+
+/**
+ * Takes a snapshot of the statistics of every worker
+ * of a task manager
+ * 
+ * The counters are read while the workers are running, 
+ * so the snapshot of each worker is only approximately
+ * consistent.
+ * 
+ * @param[in]  manager The task manager
+ * @param[out] stats   Array of `pool.capacity` statistics,
+ *                      retired workers keep their counters
+ * 
+ * @return ST_FAIL if the library was compiled 
+ *          without `CTOOL_THREAD_STATS`, otherwise ST_OK
+ */
+status_t task_manager_stats(task_manager_t* manager, task_worker_stats_t* stats) {
+#ifdef CTOOL_THREAD_STATS
+    iterate_array(i, manager->pool.capacity) {
+        task_worker_counters_t* counters = &manager->pool.workers[i].counters;
+        stats[i] = (task_worker_stats_t) {
+            .executed = atomic_load_explicit(&counters->executed, memory_order_relaxed),
+            .busy = atomic_load_explicit(&counters->busy, memory_order_relaxed),
+            .idle = atomic_load_explicit(&counters->idle, memory_order_relaxed),
+            .wakeups = atomic_load_explicit(&counters->wakeups, memory_order_relaxed),
+            .steals = atomic_load_explicit(&counters->steals, memory_order_relaxed),
+            .misses = atomic_load_explicit(&counters->misses, memory_order_relaxed),
+            .longest = atomic_load_explicit(&counters->longest, memory_order_relaxed)
+        };
+    }
+    return ST_OK;
+#else
+    assertrc_fail(ST_FAIL, "task manager statistics are disabled, define CTOOL_THREAD_STATS to enable them")
+#endif
+}
+
+/**
+ * Returns the number of running workers
+ * of a task manager
+ * 
+ * The size of an elastic pool changes concurrently,
+ * so the value may be outdated once returned.
+ * 
+ * @param[in] manager The task manager
+ * 
+ * @return The number of workers
+ */
+size_t task_manager_size(task_manager_t* manager) {
+    return atomic_load(&manager->pool.size);
+}
+
+/**
+ * Returns the worker running the calling thread
+ * 
+ * Tasks can use it to find their `node` and
+ * allocate memory close to the worker.
+ * 
+ * @return The worker, or NULL if called 
+ *          outside of a worker thread
+ */
+task_worker_t* task_worker_current() {
+    return task_worker_self;
+}
+
+/**
+ * Returns the index of the worker running
+ * the calling thread
+ * 
+ * Indices are below the `max_threads` of the
+ * task manager and are never shared by two running
+ * workers, so a task can update the slot of its worker
+ * in a sharded array without atomics. Tasks executed
+ * by an awaiting thread, see task_future_await(),
+ * are not executed by a worker.
+ * 
+ * @return The index, or TASK_WORKER_NONE if
+ *          called outside of a worker thread
+ */
+size_t task_worker_index() {
+    return task_worker_self != NULL ? task_worker_self->index : TASK_WORKER_NONE;
+}
+
+/**
+ * Returns the scratch buffer of the worker
+ * running the calling thread
+ * 
+ * Tasks can use it for temporary data without
+ * allocating, or for counters of the worker.
+ * 
+ * @return The buffer, or NULL if called outside of
+ *          a worker thread or if the task manager 
+ *          has no scratch buffers
+ */
+void* task_worker_scratch() {
+    return task_worker_self != NULL ? task_worker_self->scratch : NULL;
+}
+
+/**
+ * Returns the user data pointer of the worker
+ * running the calling thread
+ * 
+ * @return The pointer, or NULL if called 
+ *          outside of a worker thread
+ */
+void* task_worker_data() {
+    return task_worker_self != NULL ? task_worker_self->data : NULL;
+}
+
+/**
+ * Returns the scratch buffer of a worker slot
+ * of a task manager
+ * 
+ * Can be used to combine the data of the workers
+ * once their tasks have returned.
+ * 
+ * @param[in] manager The task manager
+ * @param[in] index   Index of the worker
+ * 
+ * @return The buffer, or NULL if the index is out
+ *          of the pool or there are no scratch buffers
+ */
+void* task_manager_scratch(task_manager_t* manager, size_t index) {
+    return index < manager->pool.capacity ? manager->pool.workers[index].scratch : NULL;
+}
+
+/**
+ * Sets the user data pointer of a worker slot
+ * of a task manager
+ * 
+ * Should be set before the tasks that read it
+ * are submitted or enqueued.
+ * 
+ * @param[in] manager The task manager
+ * @param[in] index   Index of the worker
+ * @param[in] data    The pointer
+ * 
+ * @return ST_BAD_ARG if the index is out of the pool,
+ *          otherwise ST_OK
+ */
+status_t task_manager_set_data(task_manager_t* manager, size_t index, void* data) {
+    assertrc_true(index < manager->pool.capacity, ST_BAD_ARG,
+        "worker %zu is out of the pool of %zu", index, manager->pool.capacity)
+    manager->pool.workers[index].data = data;
+    return ST_OK;
 }
 
 /**
@@ -174,5 +1559,99 @@ status_t task_list_init(task_list_t* tasks, size_t size) {
     assertr_malloc(tasks->data, sizeof(task_t) * size, task_t*);
     tasks->size = size;
     tasks->index = 0;
+    tasks->pending = size;
+    tasks->cancel = NULL;
+    tasks->deadline = 0;
+    tasks->cancelled = 0;
+    tasks->futures = NULL;
     return ST_OK;
+}
+
+/**
+ * Initializes a task list with a future for every task
+ * 
+ * The futures are allocated in one block with the tasks
+ * and are freed together with the task list.
+ * 
+ * @param[in] tasks The task list
+ * @param[in] size  Tasks count
+ * 
+ * @return ST_ALLOC_FAIL if an allocation fails, otherwise ST_OK
+ */
+status_t task_list_init_futures(task_list_t* tasks, size_t size) {
+    tasks->status = CTOOL_TASK_LIST_RUNNING;
+    assertr_malloc(tasks->data, (sizeof(task_t) + sizeof(task_future_t)) * size, task_t*);
+    tasks->size = size;
+    tasks->index = 0;
+    tasks->pending = size;
+    tasks->cancel = NULL;
+    tasks->deadline = 0;
+    tasks->cancelled = 0;
+    tasks->futures = (task_future_t*) &tasks->data[size];
+    iterate_array(i, size) {
+        atomic_init(&tasks->futures[i].ready, false);
+        atomic_init(&tasks->futures[i].subscribed, CTOOL_TASK_FUTURE_FREE);
+        tasks->futures[i].output = task_output_default;
+    }
+    return ST_OK;
+}
+
+/**
+ * Checks if the task of a future has returned
+ * 
+ * @param[in] future The future
+ */
+static bool task_future_is_done(void* future) {
+    return task_future_is_ready(future);
+}
+
+/**
+ * Subscribes a callback to be executed once 
+ * the task of a future returns
+ * 
+ * The callback is executed by the thread completing
+ * the future, so it should only schedule work, for
+ * example resume a fiber. A future has at most one 
+ * callback at a time.
+ * 
+ * @param[in] future   The future
+ * @param[in] callback The callback task
+ * 
+ * @return false if the future is already ready or has
+ *         another callback, the callback is not 
+ *         executed then, otherwise true
+ */
+bool task_future_subscribe(task_future_t* future, task_t callback) {
+    int expected = CTOOL_TASK_FUTURE_FREE;
+    if (!atomic_compare_exchange_strong(&future->subscribed, &expected, CTOOL_TASK_FUTURE_REGISTERING)) {
+        return false;
+    }
+    future->callback = callback;
+    atomic_store(&future->subscribed, CTOOL_TASK_FUTURE_SUBSCRIBED);
+    if (atomic_load(&future->ready)) {
+        /* the task may have returned before the callback was stored */
+        expected = CTOOL_TASK_FUTURE_SUBSCRIBED;
+        return !atomic_compare_exchange_strong(&future->subscribed, &expected, CTOOL_TASK_FUTURE_FREE);
+    }
+    return true;
+}
+
+/**
+ * Waits for the task of a future to return
+ * 
+ * Queued tasks and tasks of the current list are
+ * executed by the calling thread while the future
+ * is not ready, so a task can wait for other tasks 
+ * without blocking its worker. To wait for all 
+ * futures of a list at once, use task_manager_await() 
+ * or task_manager_await_helping() instead.
+ * 
+ * @param[in] manager The task manager running the task
+ * @param[in] future  The future
+ * 
+ * @return Output of the task
+ */
+task_output_t task_future_await(task_manager_t* manager, task_future_t* future) {
+    task_manager_help_until(manager, task_future_is_done, future);
+    return future->output;
 }
\ No newline at end of file
@@ -0,0 +1,245 @@
+/**
+ * @file affinity.c
+ * @author andersonarc (e.andersonarc@gmail.com)
+ * @version 0.1
+ * @date 2021-06-05
+ * 
+ *  CPU and NUMA topology for worker placement
+ * 
+ *  The NUMA nodes and their CPUs are read from
+ *  /sys/devices/system/node, limited to the CPUs
+ *  the process is allowed to run on. Without NUMA
+ *  information, all allowed CPUs form a single node.
+ */
+    /* feature test macros */
+#define _GNU_SOURCE /* sched_setaffinity(), cpu_set_t */
+
+    /* includes */
+#include "ctool/thread/affinity.h" /* this */
+#include <stdio.h> /* file reading */
+#include <stdlib.h> /* memory allocation, strtol() */
+#include <string.h> /* memcpy() */
+#include <unistd.h> /* sysconf() */
+#ifdef __linux__
+    #include <sched.h> /* cpu affinity */
+#endif
+#include "ctool/assert/runtime.h" /* runtime assertions */
+#include "ctool/iteration.h" /* range iteration */
+
+    /* defines */
+/**
+ * Directory with NUMA node information
+ */
+#define TASK_TOPOLOGY_PATH "/sys/devices/system/node"
+
+/**
+ * Maximal length of a CPU list
+ */
+#define TASK_TOPOLOGY_LINE 4096
+
+    /* functions */
+#ifdef __linux__
+/**
+ * Reads a list of ids, like "0-3,8,10-11",
+ * from a file
+ * 
+ * @param[in]  path     Path to the file
+ * @param[out] ids      The ids
+ * @param[in]  capacity Capacity of the ids
+ * @param[in]  allowed  If not NULL, ids missing from 
+ *                      this set are skipped
+ * 
+ * @return Number of ids read, 0 if the file can't be read
+ */
+static size_t task_topology_read_list(const char* path, int* ids, size_t capacity, cpu_set_t* allowed) {
+    char line[TASK_TOPOLOGY_LINE];
+    FILE* file = fopen(path, "r");
+    if (file == NULL) {
+        return 0;
+    }
+    char* position = fgets(line, sizeof(line), file);
+    fclose(file);
+    if (position == NULL) {
+        return 0;
+    }
+
+    size_t count = 0;
+    while (*position >= '0' && *position <= '9') {
+        long first = strtol(position, &position, 10);
+        long last = first;
+        if (*position == '-') {
+            last = strtol(position + 1, &position, 10);
+        }
+        for (long id = first; id <= last && id < CPU_SETSIZE && count < capacity; id++) {
+            if (allowed == NULL || CPU_ISSET(id, allowed)) {
+                ids[count++] = (int) id;
+            }
+        }
+        if (*position == ',') {
+            position++;
+        }
+    }
+    return count;
+}
+
+/**
+ * Appends a node to a topology
+ * 
+ * @param[in] topology The topology
+ * @param[in] id       Id of the node
+ * @param[in] cpus     CPUs of the node
+ * @param[in] size     CPUs count
+ * 
+ * @return ST_ALLOC_FAIL if an allocation fails, otherwise ST_OK
+ */
+static status_t task_topology_add(task_topology_t* topology, int id, int* cpus, size_t size) {
+    task_topology_node_t* node = &topology->nodes[topology->size];
+    assertr_malloc(node->cpus, sizeof(int) * size, int*)
+    memcpy(node->cpus, cpus, sizeof(int) * size);
+    node->id = id;
+    node->size = size;
+    topology->size++;
+    return ST_OK;
+}
+#endif
+
+/**
+ * Reads the CPU topology of the system
+ * 
+ * @param[in] topology The topology
+ * 
+ * @return ST_ALLOC_FAIL if an allocation fails,
+ *         ST_FAIL if the allowed CPUs can't be read,
+ *          otherwise ST_OK
+ */
+status_t task_topology_init(task_topology_t* topology) {
+    topology->size = 0;
+    topology->nodes = NULL;
+#ifdef __linux__
+    int ids[CPU_SETSIZE];
+    int cpus[CPU_SETSIZE];
+    cpu_set_t allowed;
+    assertrc_zero(sched_getaffinity(0, sizeof(allowed), &allowed), ST_FAIL, "failed to read allowed cpus")
+
+    size_t count = task_topology_read_list(TASK_TOPOLOGY_PATH "/online", ids, CPU_SETSIZE, NULL);
+    assertr_malloc(topology->nodes, sizeof(task_topology_node_t) * (count > 0 ? count : 1), task_topology_node_t*)
+    iterate_array(i, count) {
+        char path[sizeof(TASK_TOPOLOGY_PATH) + 32];
+        snprintf(path, sizeof(path), TASK_TOPOLOGY_PATH "/node%d/cpulist", ids[i]);
+        size_t size = task_topology_read_list(path, cpus, CPU_SETSIZE, &allowed);
+        if (size > 0 && task_topology_add(topology, ids[i], cpus, size) != ST_OK) {
+            task_topology_free(topology);
+            return ST_ALLOC_FAIL;
+        }
+    }
+
+    if (topology->size == 0) {
+        /* no NUMA information, use a single node */
+        size_t size = 0;
+        iterate_array(cpu, CPU_SETSIZE) {
+            if (CPU_ISSET(cpu, &allowed)) {
+                cpus[size++] = (int) cpu;
+            }
+        }
+        if (task_topology_add(topology, 0, cpus, size) != ST_OK) {
+            task_topology_free(topology);
+            return ST_ALLOC_FAIL;
+        }
+    }
+    return ST_OK;
+#else
+    assertrc_fail(ST_FAIL, "cpu topology is only available on linux")
+#endif
+}
+
+/**
+ * Frees memory allocated for a topology
+ * 
+ * @param[in] topology The topology
+ */
+void task_topology_free(task_topology_t* topology) {
+    iterate_array(i, topology->size) {
+        free(topology->nodes[i].cpus);
+    }
+    free(topology->nodes);
+    topology->nodes = NULL;
+    topology->size = 0;
+}
+
+/**
+ * Selects a CPU and a node for a worker
+ * 
+ * Workers beyond the number of CPUs wrap around.
+ * 
+ * @param[in]  topology The topology
+ * @param[in]  affinity Placement mode
+ * @param[in]  index    Index of the worker
+ * @param[out] cpu      The CPU, -1 if not pinned
+ * @param[out] node     The node, -1 if not pinned
+ */
+void task_topology_place(task_topology_t* topology, task_affinity_t affinity, size_t index, int* cpu, int* node) {
+    *cpu = -1;
+    *node = -1;
+    if (affinity == CTOOL_TASK_AFFINITY_NONE || topology->size == 0) {
+        return;
+    }
+
+    task_topology_node_t* selected = topology->nodes;
+    size_t slot;
+    if (affinity == CTOOL_TASK_AFFINITY_SPREAD) {
+        /* one worker per node in turn */
+        selected = &topology->nodes[index % topology->size];
+        slot = index / topology->size;
+    } else {
+        /* fill the nodes one after another */
+        size_t total = 0;
+        iterate_array(i, topology->size) {
+            total += topology->nodes[i].size;
+        }
+        slot = index % total;
+        while (slot >= selected->size) {
+            slot -= selected->size;
+            selected++;
+        }
+    }
+    *cpu = selected->cpus[slot % selected->size];
+    *node = selected->id;
+}
+
+/**
+ * Pins the calling thread to a CPU
+ * 
+ * @param[in] cpu The CPU
+ * 
+ * @return ST_FAIL if the thread can't be pinned, otherwise ST_OK
+ */
+status_t task_affinity_pin(int cpu) {
+#ifdef __linux__
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    CPU_SET(cpu, &set);
+    assertrc_zero(sched_setaffinity(0, sizeof(set), &set), ST_FAIL, "failed to pin a thread to cpu %d", cpu)
+    return ST_OK;
+#else
+    assertrc_fail(ST_FAIL, "cpu affinity is only available on linux")
+#endif
+}
+
+/**
+ * Counts the CPUs the calling thread is allowed to run on
+ * 
+ * Falls back to the number of online CPUs
+ * if the affinity mask can't be read.
+ * 
+ * @return The number of CPUs, at least 1
+ */
+size_t task_affinity_cpus() {
+#ifdef __linux__
+    cpu_set_t allowed;
+    if (sched_getaffinity(0, sizeof(allowed), &allowed) == 0 && CPU_COUNT(&allowed) > 0) {
+        return (size_t) CPU_COUNT(&allowed);
+    }
+#endif
+    long cpus = sysconf(_SC_NPROCESSORS_ONLN);
+    return cpus > 0 ? (size_t) cpus : 1;
+}
\ No newline at end of file
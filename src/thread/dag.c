@@ -0,0 +1,332 @@
+/**
+ * @file dag.c
+ * @author andersonarc (e.andersonarc@gmail.com)
+ * @version 0.1
+ * @date 2021-06-07
+ * 
+ *  Task dependency graph execution
+ * 
+ *  Every node of a graph holds a task and an atomic
+ *  counter of its unfinished predecessors. When a task
+ *  returns, the counters of its successors are decremented,
+ *  and the successors that reach zero become runnable
+ *  immediately, without a barrier between stages.
+ */
+    /* includes */
+#include "ctool/thread/dag.h" /* this */
+#include <stdlib.h> /* memory allocation */
+#include "ctool/assert/runtime.h" /* runtime assertions */
+#include "ctool/iteration.h" /* range iteration */
+
+    /* defines */
+/**
+ * Initial capacity of the node and successor arrays
+ */
+#define TASK_DAG_DEFAULT_SIZE 2
+
+    /* functions */
+static task_output_t task_dag_main(task_dag_node_t* node);
+
+/**
+ * Marks a task graph as finished 
+ * and wakes up the waiting threads
+ * 
+ * @param[in] dag The graph
+ */
+static void task_dag_finish(task_dag_t* dag) {
+    _ctool_mutex_lock(&dag->lock);
+    dag->running = false;
+    _ctool_cond_broadcast(&dag->finished);
+    _ctool_mutex_unlock(&dag->lock);
+}
+
+/**
+ * Enqueues a runnable node to the task manager,
+ * or pushes it to a local stack of the calling 
+ * thread if the queue is full
+ * 
+ * @param[in] node  The node
+ * @param[in] local The local stack
+ */
+static void task_dag_schedule(task_dag_node_t* node, task_dag_node_t** local) {
+    task_t task = { .function = (task_function_t) &task_dag_main, .input = node };
+    node->next = NULL;
+    if (task_manager_enqueue(node->dag->manager, task) != ST_OK) {
+        node->next = *local;
+        *local = node;
+    }
+}
+
+/**
+ * Executes the nodes of a local stack and 
+ * the successors they release
+ * 
+ * The first released successor of every node
+ * is pushed to the local stack, so a chain of
+ * dependent nodes runs on a single worker.
+ * 
+ * @param[in] local The local stack
+ */
+static void task_dag_execute(task_dag_node_t* local) {
+    while (local != NULL) {
+        task_dag_node_t* node = local;
+        task_dag_t* dag = node->dag;
+        local = node->next;
+        node->task.function(node->task.input);
+
+        /* release the successors */
+        bool kept = false;
+        iterate_array(i, node->size) {
+            task_dag_node_t* successor = &dag->nodes[node->successors[i]];
+            if (atomic_fetch_sub(&successor->pending, 1) == 1) {
+                if (kept) {
+                    task_dag_schedule(successor, &local);
+                } else {
+                    successor->next = local;
+                    local = successor;
+                    kept = true;
+                }
+            }
+        }
+        if (atomic_fetch_sub(&dag->remaining, 1) == 1) {
+            task_dag_finish(dag);
+        }
+    }
+}
+
+/**
+ * Executes an enqueued node of a task graph
+ * 
+ * @param[in] node The node
+ * 
+ * @return Default task output
+ */
+static task_output_t task_dag_main(task_dag_node_t* node) {
+    task_dag_execute(node);
+    return task_output_default;
+}
+
+/**
+ * Initializes an empty task graph
+ * 
+ * @param[in] dag      The graph
+ * @param[in] capacity Number of nodes to preallocate
+ * 
+ * @return ST_ALLOC_FAIL if an allocation fails,
+ *         ST_FAIL if synchronization primitives
+ *          can't be initialized, otherwise ST_OK
+ */
+status_t task_dag_init(task_dag_t* dag, size_t capacity) {
+    dag->size = 0;
+    dag->capacity = capacity;
+    dag->nodes = NULL;
+    if (capacity > 0) {
+        assertr_malloc(dag->nodes, sizeof(task_dag_node_t) * capacity, task_dag_node_t*)
+    }
+    dag->manager = NULL;
+    dag->running = false;
+    atomic_init(&dag->remaining, 0);
+    assertr_zero(_ctool_mutex_init(&dag->lock), ST_FAIL);
+    assertr_zero(_ctool_cond_init(&dag->finished), ST_FAIL);
+    return ST_OK;
+}
+
+/**
+ * Frees memory allocated for a task graph
+ * 
+ * @param[in] dag The graph
+ */
+void task_dag_free(task_dag_t* dag) {
+    iterate_array(i, dag->size) {
+        free(dag->nodes[i].successors);
+    }
+    free(dag->nodes);
+    dag->nodes = NULL;
+    dag->size = 0;
+    dag->capacity = 0;
+    _ctool_cond_destroy(&dag->finished);
+    _ctool_mutex_destroy(&dag->lock);
+}
+
+/**
+ * Checks if a task graph is running
+ * 
+ * @param[in] dag The graph
+ */
+static bool task_dag_is_running(task_dag_t* dag) {
+    _ctool_mutex_lock(&dag->lock);
+    bool running = dag->running;
+    _ctool_mutex_unlock(&dag->lock);
+    return running;
+}
+
+/**
+ * Appends a task to a task graph
+ * 
+ * @param[in]  dag  The graph
+ * @param[in]  task The task
+ * @param[out] node Index of the new node, may be NULL
+ * 
+ * @return ST_FAIL if the graph is running,
+ *         ST_ALLOC_FAIL if an allocation fails,
+ *          otherwise ST_OK
+ */
+status_t task_dag_add(task_dag_t* dag, task_t task, size_t* node) {
+    assertrc_false(task_dag_is_running(dag), ST_FAIL, "can't modify a running task graph")
+    if (dag->size == dag->capacity) {
+        size_t capacity = dag->capacity > 0 ? dag->capacity * 2 : TASK_DAG_DEFAULT_SIZE;
+        task_dag_node_t* nodes = realloc(dag->nodes, sizeof(task_dag_node_t) * capacity);
+        assertrc_not_null(nodes, ST_ALLOC_FAIL, "failed to grow a task graph to %zu nodes", capacity)
+        dag->nodes = nodes;
+        dag->capacity = capacity;
+    }
+
+    task_dag_node_t* added = &dag->nodes[dag->size];
+    added->task = task;
+    atomic_init(&added->pending, 0);
+    added->degree = 0;
+    added->size = 0;
+    added->capacity = 0;
+    added->successors = NULL;
+    added->dag = dag;
+    added->next = NULL;
+    if (node != NULL) {
+        *node = dag->size;
+    }
+    dag->size++;
+    return ST_OK;
+}
+
+/**
+ * Makes a node of a task graph depend on another one,
+ * so that it is executed after the predecessor returns
+ * 
+ * @param[in] dag         The graph
+ * @param[in] node        Index of the dependent node
+ * @param[in] predecessor Index of the predecessor
+ * 
+ * @return ST_BAD_ARG if an index is out of bounds
+ *          or both indices are equal,
+ *         ST_FAIL if the graph is running,
+ *         ST_ALLOC_FAIL if an allocation fails,
+ *          otherwise ST_OK
+ */
+status_t task_dag_depend(task_dag_t* dag, size_t node, size_t predecessor) {
+    assertrc_false(node >= dag->size || predecessor >= dag->size || node == predecessor, ST_BAD_ARG,
+        "invalid dependency of node %zu on node %zu in a task graph of %zu nodes", node, predecessor, dag->size)
+    assertrc_false(task_dag_is_running(dag), ST_FAIL, "can't modify a running task graph")
+
+    task_dag_node_t* source = &dag->nodes[predecessor];
+    if (source->size == source->capacity) {
+        size_t capacity = source->capacity > 0 ? source->capacity * 2 : TASK_DAG_DEFAULT_SIZE;
+        size_t* successors = realloc(source->successors, sizeof(size_t) * capacity);
+        assertrc_not_null(successors, ST_ALLOC_FAIL, "failed to grow successors of a task graph node to %zu", capacity)
+        source->successors = successors;
+        source->capacity = capacity;
+    }
+    source->successors[source->size++] = node;
+    dag->nodes[node].degree++;
+    return ST_OK;
+}
+
+/**
+ * Checks if a task graph has no cycles, 
+ * by removing the nodes without predecessors
+ * until none are left
+ * 
+ * @note Uses the `pending` counters and `next` links,
+ *       the graph must not be running
+ * 
+ * @param[in] dag The graph
+ * 
+ * @return true if every node can be reached 
+ *          from a node without predecessors
+ */
+static bool task_dag_is_acyclic(task_dag_t* dag) {
+    task_dag_node_t* ready = NULL;
+    size_t visited = 0;
+    iterate_array(i, dag->size) {
+        task_dag_node_t* node = &dag->nodes[i];
+        atomic_store_explicit(&node->pending, node->degree, memory_order_relaxed);
+        if (node->degree == 0) {
+            node->next = ready;
+            ready = node;
+        }
+    }
+    while (ready != NULL) {
+        task_dag_node_t* node = ready;
+        ready = node->next;
+        visited++;
+        iterate_array(i, node->size) {
+            task_dag_node_t* successor = &dag->nodes[node->successors[i]];
+            if (atomic_fetch_sub_explicit(&successor->pending, 1, memory_order_relaxed) == 1) {
+                successor->next = ready;
+                ready = successor;
+            }
+        }
+    }
+    return visited == dag->size;
+}
+
+/**
+ * Starts the execution of a task graph on a task manager
+ * 
+ * The nodes without predecessors are enqueued immediately,
+ * and every other node is enqueued by the last of its
+ * predecessors. One of the successors is executed
+ * by the same worker without enqueueing it. If the queue
+ * of the manager is full, the calling thread executes
+ * the remaining nodes itself.
+ * 
+ * @param[in] manager The task manager
+ * @param[in] dag     The graph
+ * 
+ * @return ST_BAD_ARG if the graph has a cycle,
+ *         ST_FAIL if the graph is already running,
+ *          otherwise ST_OK
+ */
+status_t task_dag_run(task_manager_t* manager, task_dag_t* dag) {
+    assertrc_false(task_dag_is_running(dag), ST_FAIL, "task graph is already running")
+    assertrc_true(task_dag_is_acyclic(dag), ST_BAD_ARG, "task graph of %zu nodes has a cycle", dag->size)
+    if (dag->size == 0) {
+        return ST_OK;
+    }
+
+    /* reset the counters */
+    iterate_array(i, dag->size) {
+        task_dag_node_t* node = &dag->nodes[i];
+        node->dag = dag;
+        atomic_store(&node->pending, node->degree);
+    }
+    dag->manager = manager;
+    atomic_store(&dag->remaining, dag->size);
+    _ctool_mutex_lock(&dag->lock);
+    dag->running = true;
+    _ctool_mutex_unlock(&dag->lock);
+
+    /* start from the nodes without predecessors */
+    task_dag_node_t* local = NULL;
+    iterate_array(i, dag->size) {
+        if (dag->nodes[i].degree == 0) {
+            task_dag_schedule(&dag->nodes[i], &local);
+        }
+    }
+    task_dag_execute(local);
+    return ST_OK;
+}
+
+/**
+ * Waits for every node of a running task graph to return
+ * 
+ * Once it returns, the graph can be modified 
+ * and run again.
+ * 
+ * @param[in] dag The graph
+ */
+void task_dag_await(task_dag_t* dag) {
+    _ctool_mutex_lock(&dag->lock);
+    while (dag->running) {
+        _ctool_cond_wait(&dag->finished, &dag->lock);
+    }
+    _ctool_mutex_unlock(&dag->lock);
+}
\ No newline at end of file
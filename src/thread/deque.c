@@ -0,0 +1,163 @@
+/**
+ * @file deque.c
+ * @author andersonarc (e.andersonarc@gmail.com)
+ * @version 0.1
+ * @date 2021-05-17
+ * 
+ *  Chase-Lev work-stealing deque of tasks
+ * 
+ *  The owner thread pushes and pops tasks at the bottom
+ *  of the deque without contention, while other threads
+ *  steal tasks from the top.
+ */
+    /* includes */
+#include "ctool/thread/deque.h" /* this */
+#include <stdlib.h> /* memory allocation */
+#include "ctool/assert/runtime.h" /* runtime assertions */
+
+    /* functions */
+/**
+ * Allocates a circular array for a deque
+ * 
+ * @param[in] size The capacity, a power of two
+ * 
+ * @return The array or NULL if an allocation fails
+ */
+static task_deque_array_t* task_deque_array_create(size_t size) {
+    task_deque_array_t* array = malloc(sizeof(task_deque_array_t) + size * sizeof(array->data[0]));
+    if (array != NULL) {
+        array->size = size;
+        array->previous = NULL;
+    }
+    return array;
+}
+
+/**
+ * Initializes an empty deque
+ * 
+ * @param[in] deque The deque
+ * @param[in] size  Initial capacity, a power of two
+ * 
+ * @return ST_ALLOC_FAIL if an allocation fails, otherwise ST_OK
+ */
+status_t task_deque_init(task_deque_t* deque, size_t size) {
+    task_deque_array_t* array = task_deque_array_create(size);
+    assertr_not_null(array, ST_ALLOC_FAIL);
+    atomic_init(&deque->top, 0);
+    atomic_init(&deque->bottom, 0);
+    atomic_init(&deque->array, array);
+    return ST_OK;
+}
+
+/**
+ * Frees memory allocated for a deque
+ * 
+ * @param[in] deque The deque
+ */
+void task_deque_free(task_deque_t* deque) {
+    task_deque_array_t* array = atomic_load(&deque->array);
+    while (array != NULL) {
+        task_deque_array_t* previous = array->previous;
+        free(array);
+        array = previous;
+    }
+    atomic_store(&deque->array, NULL);
+}
+
+/**
+ * Pushes a task to the bottom of a deque,
+ * growing it if required
+ * 
+ * @note Only the owner of the deque may call this function
+ * 
+ * @param[in] deque The deque
+ * @param[in] task  The task
+ * 
+ * @return ST_ALLOC_FAIL if an allocation fails, otherwise ST_OK
+ */
+status_t task_deque_push(task_deque_t* deque, task_t* task) {
+    ptrdiff_t bottom = atomic_load_explicit(&deque->bottom, memory_order_relaxed);
+    ptrdiff_t top = atomic_load_explicit(&deque->top, memory_order_acquire);
+    task_deque_array_t* array = atomic_load_explicit(&deque->array, memory_order_relaxed);
+
+    if (bottom - top > (ptrdiff_t) array->size - 1) {
+        /* the deque is full, copy it into a twice bigger array */
+        task_deque_array_t* grown = task_deque_array_create(array->size * 2);
+        assertr_not_null(grown, ST_ALLOC_FAIL);
+        for (ptrdiff_t i = top; i < bottom; i++) {
+            atomic_store_explicit(&grown->data[i & (grown->size - 1)],
+                atomic_load_explicit(&array->data[i & (array->size - 1)], memory_order_relaxed),
+                memory_order_relaxed);
+        }
+        grown->previous = array;
+        atomic_store_explicit(&deque->array, grown, memory_order_release);
+        array = grown;
+    }
+
+    atomic_store_explicit(&array->data[bottom & (array->size - 1)], task, memory_order_relaxed);
+    atomic_thread_fence(memory_order_release);
+    atomic_store_explicit(&deque->bottom, bottom + 1, memory_order_relaxed);
+    return ST_OK;
+}
+
+/**
+ * Pops a task from the bottom of a deque
+ * 
+ * @note Only the owner of the deque may call this function
+ * 
+ * @param[in] deque The deque
+ * 
+ * @return The task or NULL if the deque is empty
+ */
+task_t* task_deque_pop(task_deque_t* deque) {
+    ptrdiff_t bottom = atomic_load_explicit(&deque->bottom, memory_order_relaxed) - 1;
+    task_deque_array_t* array = atomic_load_explicit(&deque->array, memory_order_relaxed);
+    atomic_store_explicit(&deque->bottom, bottom, memory_order_relaxed);
+    atomic_thread_fence(memory_order_seq_cst);
+    ptrdiff_t top = atomic_load_explicit(&deque->top, memory_order_relaxed);
+
+    if (top > bottom) {
+        /* the deque is empty, restore it */
+        atomic_store_explicit(&deque->bottom, bottom + 1, memory_order_relaxed);
+        return NULL;
+    }
+
+    task_t* task = atomic_load_explicit(&array->data[bottom & (array->size - 1)], memory_order_relaxed);
+    if (top == bottom) {
+        /* the last task, race against the thieves for it */
+        if (!atomic_compare_exchange_strong_explicit(&deque->top, &top, top + 1,
+                memory_order_seq_cst, memory_order_relaxed)) {
+            task = NULL;
+        }
+        atomic_store_explicit(&deque->bottom, bottom + 1, memory_order_relaxed);
+    }
+    return task;
+}
+
+/**
+ * Steals a task from the top of a deque
+ * 
+ * Can be called by any thread. If another thread
+ * takes the same task first, stealing is retried.
+ * 
+ * @param[in] deque The deque
+ * 
+ * @return The task or NULL if the deque is empty
+ */
+task_t* task_deque_steal(task_deque_t* deque) {
+    while (true) {
+        ptrdiff_t top = atomic_load_explicit(&deque->top, memory_order_acquire);
+        atomic_thread_fence(memory_order_seq_cst);
+        ptrdiff_t bottom = atomic_load_explicit(&deque->bottom, memory_order_acquire);
+        if (top >= bottom) {
+            return NULL;
+        }
+
+        task_deque_array_t* array = atomic_load_explicit(&deque->array, memory_order_acquire);
+        task_t* task = atomic_load_explicit(&array->data[top & (array->size - 1)], memory_order_relaxed);
+        if (atomic_compare_exchange_strong_explicit(&deque->top, &top, top + 1,
+                memory_order_seq_cst, memory_order_relaxed)) {
+            return task;
+        }
+    }
+}
\ No newline at end of file
@@ -0,0 +1,605 @@
+/**
+ * @file fiber.c
+ * @author andersonarc (e.andersonarc@gmail.com)
+ * @version 0.1
+ * @date 2021-06-10
+ * 
+ *  Stackful fibers on top of a task manager
+ * 
+ *  A fiber runs a task on its own small stack, and can
+ *  suspend itself to wait for a file descriptor or for
+ *  another task without blocking the worker thread, which
+ *  executes other tasks meanwhile. Suspended fibers are
+ *  resumed by enqueueing them to the task manager again,
+ *  so thousands of fibers are multiplexed over the few
+ *  threads of the pool. Fibers and their stacks are
+ *  reused after they finish.
+ */
+    /* includes */
+#include "ctool/thread/fiber.h" /* this */
+#include <errno.h> /* errno */
+#include <poll.h> /* poll() */
+#include <sched.h> /* sched_yield() */
+#include <stdint.h> /* uintptr_t */
+#include <stdlib.h> /* memory allocation */
+#include <sys/mman.h> /* stack mapping */
+#include <unistd.h> /* sysconf(), close() */
+#ifdef __linux__
+    #include <sys/epoll.h> /* epoll */
+    #include <sys/eventfd.h> /* eventfd */
+#endif
+#include "ctool/assert/runtime.h" /* runtime assertions */
+
+    /* defines */
+/**
+ * Initializes a thread instance and
+ * runs the poller of a fiber pool on it
+ * 
+ * @param[in] thread Pointer to the thread
+ * @param[in] pool   The fiber pool
+ * 
+ * @return 0 if everything is OK
+ */
+#ifdef CTOOL_THREAD_USE_POSIX
+    #define thread_initialize(thread, pool) pthread_create(thread, NULL, (task_function_t) &task_fiber_poller_main, pool)
+#else
+    #define thread_initialize(thread, pool) thrd_create(thread, (task_function_t) &task_fiber_poller_main, pool)
+#endif
+
+/**
+ * Waits for a thread to exit
+ * 
+ * @param[in] thread The thread
+ * 
+ * @return 0 if everything is OK
+ */
+#ifdef CTOOL_THREAD_USE_POSIX
+    #define thread_join(thread) pthread_join(thread, NULL)
+#else
+    #define thread_join(thread) thrd_join(thread, NULL)
+#endif
+
+/**
+ * Maximal number of events handled by the poller at once
+ */
+#define TASK_FIBER_POLL_EVENTS 64
+
+    /* variables */
+/**
+ * Fiber running on the current thread
+ */
+static _Thread_local task_fiber_t* task_fiber_self = NULL;
+
+    /* functions */
+static task_output_t task_fiber_run(task_fiber_t* fiber);
+
+/**
+ * Executes the tasks of a fiber, forever
+ * 
+ * The fiber pointer is split in two halves,
+ * because makecontext() only passes int arguments.
+ * A finished fiber switches back to the worker, and
+ * continues from here when it is reused.
+ * 
+ * @param[in] high Upper half of the fiber pointer
+ * @param[in] low  Lower half of the fiber pointer
+ */
+static void task_fiber_entry(unsigned int high, unsigned int low) {
+    task_fiber_t* fiber = (task_fiber_t*) (((uintptr_t) high << 16 << 16) | (uintptr_t) low);
+    while (true) {
+        fiber->task.function(fiber->task.input);
+        fiber->state = CTOOL_TASK_FIBER_FINISHED;
+        swapcontext(&fiber->context, fiber->scheduler);
+    }
+}
+
+/**
+ * Leaves the stack of the current fiber and 
+ * switches back to the worker that resumed it
+ * 
+ * @param[in] fiber The fiber
+ * @param[in] state Reason of leaving
+ */
+static void task_fiber_suspend(task_fiber_t* fiber, task_fiber_state_t state) {
+    fiber->state = state;
+    swapcontext(&fiber->context, fiber->scheduler);
+}
+
+/**
+ * Enqueues a fiber to be resumed by a worker
+ * 
+ * @param[in] fiber The fiber
+ * 
+ * @return ST_BUSY if the queue is full, otherwise ST_OK
+ */
+static inline status_t task_fiber_schedule(task_fiber_t* fiber) {
+    task_t task = { .function = (task_function_t) &task_fiber_run, .input = fiber };
+    return task_manager_enqueue(fiber->pool->manager, task);
+}
+
+/**
+ * Returns a finished fiber to its pool
+ * 
+ * @param[in] fiber The fiber
+ */
+static void task_fiber_release(task_fiber_t* fiber) {
+    task_fiber_pool_t* pool = fiber->pool;
+    _ctool_mutex_lock(&pool->lock);
+    fiber->next = pool->free;
+    pool->free = fiber;
+    pool->active--;
+    if (pool->active == 0) {
+        _ctool_cond_broadcast(&pool->finished);
+    }
+    _ctool_mutex_unlock(&pool->lock);
+}
+
+/**
+ * Registers a suspended fiber to be resumed
+ * when its file descriptor is ready
+ * 
+ * The descriptor is watched for the events 
+ * of every fiber waiting for it.
+ * 
+ * @param[in] fiber The fiber
+ * 
+ * @return ST_ALLOC_FAIL if the waiters can't be stored,
+ *         ST_FAIL if the descriptor can't be watched, 
+ *          otherwise ST_OK
+ */
+static status_t task_fiber_watch(task_fiber_t* fiber) {
+#ifdef __linux__
+    task_fiber_pool_t* pool = fiber->pool;
+    size_t fd = (size_t) fiber->fd;
+    _ctool_mutex_lock(&pool->lock);
+    if (fd >= pool->waiters_size) {
+        size_t size = pool->waiters_size != 0 ? pool->waiters_size : TASK_FIBER_POLL_EVENTS;
+        while (size <= fd) {
+            size *= 2;
+        }
+        task_fiber_t** waiters = realloc(pool->waiters, size * sizeof(task_fiber_t*));
+        if (waiters == NULL) {
+            _ctool_mutex_unlock(&pool->lock);
+            assertrc_fail(ST_ALLOC_FAIL, "failed to store the waiters of descriptor %d", fiber->fd)
+        }
+        for (size_t i = pool->waiters_size; i < size; i++) {
+            waiters[i] = NULL;
+        }
+        pool->waiters = waiters;
+        pool->waiters_size = size;
+    }
+
+    uint32_t events = fiber->events;
+    for (task_fiber_t* waiter = pool->waiters[fd]; waiter != NULL; waiter = waiter->next) {
+        events |= waiter->events;
+    }
+    struct epoll_event event = { .events = events | EPOLLONESHOT, .data.fd = fiber->fd };
+    /* the descriptor stays registered after the first wait */
+    if (epoll_ctl(pool->epoll, EPOLL_CTL_MOD, fiber->fd, &event) != 0
+            && epoll_ctl(pool->epoll, EPOLL_CTL_ADD, fiber->fd, &event) != 0) {
+        _ctool_mutex_unlock(&pool->lock);
+        assertrc_fail(ST_FAIL, "failed to watch descriptor %d for a fiber", fiber->fd)
+    }
+    fiber->next = pool->waiters[fd];
+    pool->waiters[fd] = fiber;
+    _ctool_mutex_unlock(&pool->lock);
+    return ST_OK;
+#else
+    assertrc_fail(ST_FAIL, "fibers can only wait for descriptors on linux")
+#endif
+}
+
+#ifdef __linux__
+/**
+ * Removes the fibers waiting for the ready events
+ * of a file descriptor from its waiters, and watches
+ * the descriptor again for the remaining fibers
+ * 
+ * The remaining fibers are removed as well,
+ * with ST_FAIL status, if the descriptor 
+ * can't be watched anymore.
+ * 
+ * @param[in] pool   The fiber pool
+ * @param[in] fd     The file descriptor
+ * @param[in] events The ready events
+ * 
+ * @return List of the fibers to resume
+ */
+static task_fiber_t* task_fiber_take_ready(task_fiber_pool_t* pool, int fd, uint32_t events) {
+    task_fiber_t* ready = NULL;
+    uint32_t remaining = 0;
+    _ctool_mutex_lock(&pool->lock);
+    task_fiber_t** link = &pool->waiters[fd];
+    while (*link != NULL) {
+        task_fiber_t* fiber = *link;
+        if (((fiber->events | EPOLLERR | EPOLLHUP) & events) != 0) {
+            *link = fiber->next;
+            fiber->next = ready;
+            ready = fiber;
+        } else {
+            remaining |= fiber->events;
+            link = &fiber->next;
+        }
+    }
+
+    struct epoll_event event = { .events = remaining | EPOLLONESHOT, .data.fd = fd };
+    if (remaining != 0 && epoll_ctl(pool->epoll, EPOLL_CTL_MOD, fd, &event) != 0) {
+        logw("failed to watch descriptor %d for the remaining fibers", fd);
+        while (pool->waiters[fd] != NULL) {
+            task_fiber_t* fiber = pool->waiters[fd];
+            pool->waiters[fd] = fiber->next;
+            fiber->status = ST_FAIL;
+            fiber->next = ready;
+            ready = fiber;
+        }
+    }
+    _ctool_mutex_unlock(&pool->lock);
+    return ready;
+}
+#endif
+
+/**
+ * Resumes a fiber whose future is ready
+ * 
+ * Executed by the thread completing the future.
+ * The fiber is resumed at once if it can't be enqueued.
+ * 
+ * @param[in] fiber The fiber
+ * 
+ * @return Default task output
+ */
+static task_output_t task_fiber_resume(task_fiber_t* fiber) {
+    if (task_fiber_schedule(fiber) != ST_OK) {
+        task_fiber_run(fiber);
+    }
+    return task_output_default;
+}
+
+/**
+ * Resumes a fiber on the current worker
+ * 
+ * Once the fiber leaves its stack, it is enqueued
+ * again, registered for its file descriptor, or
+ * returned to the pool. The fiber is resumed at once
+ * if it can't be enqueued or watched.
+ * 
+ * @param[in] fiber The fiber
+ * 
+ * @return Default task output
+ */
+static task_output_t task_fiber_run(task_fiber_t* fiber) {
+    ucontext_t scheduler;
+    /* a fiber may be resumed from the stack of another one */
+    task_fiber_t* outer = task_fiber_self;
+    while (true) {
+        fiber->scheduler = &scheduler;
+        fiber->state = CTOOL_TASK_FIBER_RUNNING;
+        task_fiber_self = fiber;
+        swapcontext(&scheduler, &fiber->context);
+        task_fiber_self = outer;
+
+        /* the fiber is off its stack, another worker may resume it now */
+        switch (fiber->state) {
+            case CTOOL_TASK_FIBER_YIELDED:
+                if (task_fiber_schedule(fiber) == ST_OK) {
+                    return task_output_default;
+                }
+                break;
+            case CTOOL_TASK_FIBER_WAITING: {
+                fiber->status = ST_OK;
+                status_t status = task_fiber_watch(fiber);
+                if (status == ST_OK) {
+                    return task_output_default;
+                }
+                fiber->status = status;
+                break;
+            }
+            case CTOOL_TASK_FIBER_AWAITING: {
+                task_t callback = { .function = (task_function_t) &task_fiber_resume, .input = fiber };
+                if (task_future_subscribe(fiber->future, callback)) {
+                    return task_output_default;
+                }
+                /* another fiber is subscribed to the future */
+                if (!task_future_is_ready(fiber->future) && task_fiber_schedule(fiber) == ST_OK) {
+                    return task_output_default;
+                }
+                break;
+            }
+            default:
+                task_fiber_release(fiber);
+                return task_output_default;
+        }
+    }
+}
+
+/**
+ * Resumes the fibers whose file descriptors are ready
+ * until the pool is deleted
+ * 
+ * @param[in] pool The fiber pool
+ * 
+ * @return Default task output
+ */
+static task_output_t task_fiber_poller_main(task_fiber_pool_t* pool) {
+#ifdef __linux__
+    struct epoll_event events[TASK_FIBER_POLL_EVENTS];
+    while (true) {
+        int count = epoll_wait(pool->epoll, events, TASK_FIBER_POLL_EVENTS, -1);
+        if (count < 0 && errno != EINTR) {
+            loge("failed to wait for fiber descriptors");
+            break;
+        }
+        for (int i = 0; i < count; i++) {
+            if (events[i].data.fd == pool->wakeup) {
+                /* the pool is deleted */
+                return task_output_default;
+            }
+            task_fiber_t* fiber = task_fiber_take_ready(pool, events[i].data.fd, events[i].events);
+            while (fiber != NULL) {
+                /* the fiber may run as soon as it is enqueued */
+                task_fiber_t* next = fiber->next;
+                status_t status;
+                while ((status = task_fiber_schedule(fiber)) == ST_BUSY) {
+                    sched_yield();
+                }
+                if (status != ST_OK) {
+                    /* the task manager is shut down, finish the fiber here */
+                    task_fiber_run(fiber);
+                }
+                fiber = next;
+            }
+        }
+    }
+#endif
+    return task_output_default;
+}
+
+/**
+ * Allocates a fiber and its stack, 
+ * guarded by an inaccessible page
+ * 
+ * @param[in] pool The fiber pool
+ * 
+ * @return The fiber or NULL if an allocation fails
+ */
+static task_fiber_t* task_fiber_create(task_fiber_pool_t* pool) {
+    size_t page = (size_t) sysconf(_SC_PAGESIZE);
+    task_fiber_t* fiber = malloc(sizeof(task_fiber_t));
+    if (fiber == NULL) {
+        return NULL;
+    }
+    fiber->stack = mmap(NULL, pool->stack_size + page, PROT_READ | PROT_WRITE, 
+        MAP_PRIVATE | MAP_ANONYMOUS | MAP_STACK, -1, 0);
+    if (fiber->stack == MAP_FAILED) {
+        free(fiber);
+        return NULL;
+    }
+    /* the stack grows down into the guard page */
+    mprotect(fiber->stack, page, PROT_NONE);
+
+    fiber->pool = pool;
+    getcontext(&fiber->context);
+    fiber->context.uc_stack.ss_sp = (char*) fiber->stack + page;
+    fiber->context.uc_stack.ss_size = pool->stack_size;
+    fiber->context.uc_link = NULL;
+    uintptr_t pointer = (uintptr_t) fiber;
+    makecontext(&fiber->context, (void(*)()) &task_fiber_entry, 2, 
+        (unsigned int) (pointer >> 16 >> 16), (unsigned int) pointer);
+    return fiber;
+}
+
+/**
+ * Frees a fiber and its stack
+ * 
+ * @param[in] pool  The fiber pool
+ * @param[in] fiber The fiber
+ */
+static void task_fiber_destroy(task_fiber_pool_t* pool, task_fiber_t* fiber) {
+    munmap(fiber->stack, pool->stack_size + (size_t) sysconf(_SC_PAGESIZE));
+    free(fiber);
+}
+
+/**
+ * Creates a fiber pool on a task manager
+ * and starts its poller thread
+ * 
+ * @param[in] pool       The fiber pool
+ * @param[in] manager    The task manager
+ * @param[in] stack_size Stack size of a fiber in bytes,
+ *                       0 selects the default
+ * 
+ * @return ST_FAIL if the poller can't be started,
+ *          otherwise ST_OK
+ */
+status_t task_fiber_pool_create(task_fiber_pool_t* pool, task_manager_t* manager, size_t stack_size) {
+#ifdef __linux__
+    size_t page = (size_t) sysconf(_SC_PAGESIZE);
+    stack_size = stack_size != 0 ? stack_size : TASK_FIBER_DEFAULT_STACK;
+    pool->manager = manager;
+    pool->stack_size = (stack_size + page - 1) / page * page;
+    pool->free = NULL;
+    pool->active = 0;
+    pool->waiters = NULL;
+    pool->waiters_size = 0;
+    assertr_zero(_ctool_mutex_init(&pool->lock), ST_FAIL);
+    assertr_zero(_ctool_cond_init(&pool->finished), ST_FAIL);
+
+    pool->epoll = epoll_create1(EPOLL_CLOEXEC);
+    assertrc_false(pool->epoll < 0, ST_FAIL, "failed to create an epoll instance for fibers")
+    pool->wakeup = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    assertrc_false(pool->wakeup < 0, ST_FAIL, "failed to create an eventfd for fibers")
+    struct epoll_event event = { .events = EPOLLIN, .data.fd = pool->wakeup };
+    assertr_zero(epoll_ctl(pool->epoll, EPOLL_CTL_ADD, pool->wakeup, &event), ST_FAIL);
+    assertr_zero(thread_initialize(&pool->poller, pool), ST_FAIL);
+    return ST_OK;
+#else
+    assertrc_fail(ST_FAIL, "fibers are only available on linux")
+#endif
+}
+
+/**
+ * Deletes a fiber pool
+ * 
+ * The fibers must have finished, 
+ * see task_fiber_pool_await().
+ * 
+ * @param[in] pool The fiber pool
+ */
+void task_fiber_pool_delete(task_fiber_pool_t* pool) {
+    uint64_t value = 1;
+    if (write(pool->wakeup, &value, sizeof(value)) != sizeof(value)) {
+        logw("failed to stop the poller of a fiber pool");
+    }
+    thread_join(pool->poller);
+    close(pool->wakeup);
+    close(pool->epoll);
+
+    while (pool->free != NULL) {
+        task_fiber_t* next = pool->free->next;
+        task_fiber_destroy(pool, pool->free);
+        pool->free = next;
+    }
+    free(pool->waiters);
+    _ctool_cond_destroy(&pool->finished);
+    _ctool_mutex_destroy(&pool->lock);
+}
+
+/**
+ * Waits for every fiber of a pool to finish
+ * 
+ * Unlike task_manager_await(), also waits for 
+ * the fibers suspended on file descriptors.
+ * 
+ * @param[in] pool The fiber pool
+ */
+void task_fiber_pool_await(task_fiber_pool_t* pool) {
+    _ctool_mutex_lock(&pool->lock);
+    while (pool->active > 0) {
+        _ctool_cond_wait(&pool->finished, &pool->lock);
+    }
+    _ctool_mutex_unlock(&pool->lock);
+}
+
+/**
+ * Runs a task in a new fiber
+ * 
+ * @param[in] pool The fiber pool
+ * @param[in] task The task
+ * 
+ * @return ST_ALLOC_FAIL if a fiber can't be allocated,
+ *         ST_FAIL if the task manager is shut down,
+ *         ST_BUSY if the queue of the task manager is full,
+ *          otherwise ST_OK
+ */
+status_t task_fiber_spawn(task_fiber_pool_t* pool, task_t task) {
+    _ctool_mutex_lock(&pool->lock);
+    task_fiber_t* fiber = pool->free;
+    if (fiber != NULL) {
+        pool->free = fiber->next;
+    }
+    pool->active++;
+    _ctool_mutex_unlock(&pool->lock);
+
+    if (fiber == NULL) {
+        fiber = task_fiber_create(pool);
+        if (fiber == NULL) {
+            _ctool_mutex_lock(&pool->lock);
+            pool->active--;
+            if (pool->active == 0) {
+                _ctool_cond_broadcast(&pool->finished);
+            }
+            _ctool_mutex_unlock(&pool->lock);
+            assertrc_fail(ST_ALLOC_FAIL, "failed to allocate a fiber with %zu bytes of stack", pool->stack_size)
+        }
+    }
+
+    fiber->task = task;
+    fiber->state = CTOOL_TASK_FIBER_RUNNING;
+    status_t status = task_fiber_schedule(fiber);
+    if (status != ST_OK) {
+        task_fiber_release(fiber);
+    }
+    return status;
+}
+
+/**
+ * Returns the fiber running the calling code
+ * 
+ * @return The fiber, or NULL outside of a fiber
+ */
+task_fiber_t* task_fiber_current() {
+    return task_fiber_self;
+}
+
+/**
+ * Suspends the current fiber and enqueues it again, 
+ * so other tasks can run
+ * 
+ * Does nothing outside of a fiber.
+ */
+void task_fiber_yield() {
+    task_fiber_t* fiber = task_fiber_self;
+    if (fiber != NULL) {
+        task_fiber_suspend(fiber, CTOOL_TASK_FIBER_YIELDED);
+    }
+}
+
+/**
+ * Suspends the current fiber until a file descriptor
+ * is ready, for example before stream_read() 
+ * 
+ * Several fibers can wait for the same descriptor,
+ * each of them is resumed once one of its events
+ * is ready. Outside of a fiber, blocks the thread instead.
+ * 
+ * @param[in] fd     The file descriptor
+ * @param[in] events Epoll events to wait for,
+ *                   such as EPOLLIN or EPOLLOUT
+ * 
+ * @return ST_ALLOC_FAIL if the waiters can't be stored,
+ *         ST_FAIL if the descriptor can't be watched,
+ *          otherwise ST_OK
+ */
+status_t task_fiber_await_fd(int fd, uint32_t events) {
+    task_fiber_t* fiber = task_fiber_self;
+    if (fiber == NULL) {
+        struct pollfd descriptor = { .fd = fd, .events = (short) events };
+        assertrc_false(poll(&descriptor, 1, -1) < 0, ST_FAIL, "failed to wait for descriptor %d", fd)
+        return ST_OK;
+    }
+
+    /* the worker registers the descriptor after the fiber leaves its stack */
+    fiber->fd = fd;
+    fiber->events = events;
+    task_fiber_suspend(fiber, CTOOL_TASK_FIBER_WAITING);
+    return fiber->status;
+}
+
+/**
+ * Waits for the task of a future to return, suspending
+ * the current fiber until it is ready
+ * 
+ * The fiber is subscribed to the future and resumed
+ * by the thread that completes it. If another fiber
+ * is already subscribed, the fiber yields until the
+ * future is ready instead.
+ * Outside of a fiber, calls task_future_await().
+ * 
+ * @param[in] manager The task manager running the task
+ * @param[in] future  The future
+ * 
+ * @return Output of the task
+ */
+task_output_t task_fiber_await_future(task_manager_t* manager, task_future_t* future) {
+    /* read the thread-local fiber once, the fiber may move to another thread */
+    task_fiber_t* fiber = task_fiber_self;
+    if (fiber == NULL) {
+        return task_future_await(manager, future);
+    }
+    /* the worker subscribes the fiber after it leaves its stack */
+    while (!task_future_is_ready(future)) {
+        fiber->future = future;
+        task_fiber_suspend(fiber, CTOOL_TASK_FIBER_AWAITING);
+    }
+    return future->output;
+}
\ No newline at end of file
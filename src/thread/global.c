@@ -0,0 +1,91 @@
+/**
+ * @file global.c
+ * @author andersonarc (e.andersonarc@gmail.com)
+ * @version 0.1
+ * @date 2021-06-15
+ *
+ *  Process-wide shared task manager
+ *
+ *  Modules that need a thread pool can share a single
+ *  task manager instead of creating their own, so the
+ *  process keeps one worker per allowed CPU.
+ */
+    /* includes */
+#include "ctool/thread/global.h" /* this */
+#include <stdlib.h> /* atexit() */
+#include "ctool/log.h" /* logging */
+#include "ctool/thread/affinity.h" /* cpu count */
+
+    /* variables */
+/**
+ * The process-wide task manager
+ */
+static task_manager_t task_manager_global_instance;
+
+/**
+ * Pointer to the process-wide task manager,
+ * NULL until it is created successfully
+ */
+static task_manager_t* task_manager_global_pointer = NULL;
+
+/**
+ * Flag of the process-wide task manager creation
+ */
+static thread_once_t task_manager_global_once = CTOOL_THREAD_ONCE_INIT;
+
+    /* functions */
+/**
+ * Finishes the tasks of the process-wide task
+ * manager and deletes it, registered with atexit()
+ */
+static void task_manager_global_exit() {
+    task_worker_t* worker = task_worker_current();
+    if (worker != NULL && worker->manager == task_manager_global_pointer) {
+        /* a worker can't join itself, the threads end with the process */
+        return;
+    }
+    task_manager_shutdown(task_manager_global_pointer);
+    task_manager_delete(task_manager_global_pointer);
+}
+
+/**
+ * Creates the process-wide task manager,
+ * called once by task_manager_global()
+ */
+static void task_manager_global_init() {
+    task_manager_t* manager = &task_manager_global_instance;
+    if (task_manager_create(manager, task_affinity_cpus()) != ST_OK) {
+        loge("failed to create the global task manager");
+        return;
+    }
+    if (atexit(task_manager_global_exit) != 0) {
+        logw("the global task manager won't be deleted at exit");
+    }
+    task_manager_global_pointer = manager;
+}
+
+/**
+ * Returns the process-wide task manager,
+ * creating it on the first call
+ * 
+ * The task manager has one worker per CPU the
+ * first caller is allowed to run on. Any thread can 
+ * call it, concurrent first calls create a single
+ * task manager. At exit, the task manager finishes
+ * its tasks and is deleted, unless exit is called
+ * from one of its workers. It must not be deleted
+ * by its users.
+ * 
+ * Only one task list can run at a time, so modules
+ * sharing the task manager should enqueue tasks or
+ * use task_manager_parallel_for() and the parallel
+ * operations, which run on the queues and complete
+ * on their own. task_manager_await() waits for the
+ * queued tasks of every module.
+ * 
+ * @return The task manager, or NULL if it can't be created
+ */
+task_manager_t* task_manager_global() {
+    _ctool_call_once(&task_manager_global_once, task_manager_global_init);
+    return task_manager_global_pointer;
+}
\ No newline at end of file
@@ -0,0 +1,324 @@
+/**
+ * @file pipeline.c
+ * @author andersonarc (e.andersonarc@gmail.com)
+ * @version 0.1
+ * @date 2021-06-13
+ *
+ *  Bounded multi-stage pipeline on a task manager
+ *
+ *  Every pushed item gets a position, and keeps it through
+ *  all stages. Each stage takes the items of its input ring
+ *  strictly in the order of their positions, and stores
+ *  its output at the same position of the next ring, so
+ *  a serial stage sees the items in order even after
+ *  a parallel stage has finished them out of order.
+ */
+    /* includes */
+#include "ctool/thread/pipeline.h" /* this */
+#include <stdint.h> /* intptr_t */
+#include <stdlib.h> /* memory allocation */
+#include "ctool/assert/runtime.h" /* runtime assertions */
+#include "ctool/iteration.h" /* range iteration */
+
+    /* functions */
+static task_output_t task_pipeline_main(task_pipeline_stage_t* stage);
+
+/**
+ * Checks if a stage can take its next item,
+ * which has to be stored in its input ring and
+ * have room in the input ring of the next stage
+ *
+ * @param[in] stage The stage
+ */
+static bool task_pipeline_is_ready(task_pipeline_stage_t* stage) {
+    task_pipeline_t* pipeline = stage->pipeline;
+    size_t position = atomic_load(&stage->head);
+    size_t cell = position & (pipeline->size - 1);
+    if (atomic_load(&stage->input[cell].sequence) != position + 1) {
+        return false;
+    }
+    if (stage->index + 1 < pipeline->count) {
+        task_pipeline_stage_t* next = &pipeline->stages[stage->index + 1];
+        return atomic_load(&next->input[cell].sequence) == position;
+    }
+    return true;
+}
+
+/**
+ * Starts a task for a stage if it has an item
+ * to take and fewer tasks than its parallelism
+ *
+ * If the queue of the task manager is full,
+ * the calling thread executes the stage itself.
+ *
+ * @param[in] stage The stage
+ */
+static void task_pipeline_start(task_pipeline_stage_t* stage) {
+    size_t active = atomic_load(&stage->active);
+    do {
+        if (active >= stage->parallelism || !task_pipeline_is_ready(stage)) {
+            return;
+        }
+    } while (!atomic_compare_exchange_weak(&stage->active, &active, active + 1));
+
+    task_pipeline_t* pipeline = stage->pipeline;
+    atomic_fetch_add(&pipeline->running, 1);
+    task_t task = { .function = (task_function_t) &task_pipeline_main, .input = stage };
+    if (task_manager_enqueue(pipeline->manager, task) != ST_OK) {
+        task_pipeline_main(stage);
+    }
+}
+
+/**
+ * Takes the next item of a stage, if it is ready
+ *
+ * @param[in]  stage    The stage
+ * @param[out] position Position of the item
+ * @param[out] item     The item
+ *
+ * @return false if the stage has no item to take, otherwise true
+ */
+static bool task_pipeline_take(task_pipeline_stage_t* stage, size_t* position, task_input_t* item) {
+    task_pipeline_t* pipeline = stage->pipeline;
+    size_t head = atomic_load(&stage->head);
+    do {
+        size_t cell = head & (pipeline->size - 1);
+        if (atomic_load(&stage->input[cell].sequence) != head + 1) {
+            return false;
+        }
+        if (stage->index + 1 < pipeline->count
+                && atomic_load(&pipeline->stages[stage->index + 1].input[cell].sequence) != head) {
+            /* the next stage is behind */
+            return false;
+        }
+    } while (!atomic_compare_exchange_weak(&stage->head, &head, head + 1));
+
+    /* release the cell for the item one lap later */
+    task_pipeline_cell_t* cell = &stage->input[head & (pipeline->size - 1)];
+    *item = cell->item;
+    *position = head;
+    atomic_store(&cell->sequence, head + pipeline->size);
+    return true;
+}
+
+/**
+ * Passes an item from a stage to the next one,
+ * or completes it after the last stage
+ *
+ * @param[in] stage    The stage
+ * @param[in] position Position of the item
+ * @param[in] item     The output item
+ */
+static void task_pipeline_pass(task_pipeline_stage_t* stage, size_t position, task_input_t item) {
+    task_pipeline_t* pipeline = stage->pipeline;
+    if (stage->index + 1 < pipeline->count) {
+        task_pipeline_stage_t* next = &pipeline->stages[stage->index + 1];
+        task_pipeline_cell_t* cell = &next->input[position & (pipeline->size - 1)];
+        cell->item = item;
+        atomic_store(&cell->sequence, position + 1);
+        task_pipeline_start(next);
+        return;
+    }
+
+    atomic_fetch_add(&pipeline->completed, 1);
+    if (atomic_load(&pipeline->waiters) > 0) {
+        _ctool_mutex_lock(&pipeline->lock);
+        _ctool_cond_broadcast(&pipeline->finished);
+        _ctool_mutex_unlock(&pipeline->lock);
+    }
+}
+
+/**
+ * Processes the items of a stage until
+ * it has no item ready to take
+ *
+ * Before returning, the stage is checked again
+ * for items stored after it has left, so that
+ * no item is left without a task.
+ *
+ * @param[in] stage The stage
+ *
+ * @return Default task output
+ */
+static task_output_t task_pipeline_main(task_pipeline_stage_t* stage) {
+    task_pipeline_t* pipeline = stage->pipeline;
+    size_t position;
+    task_input_t item;
+    while (true) {
+        while (task_pipeline_take(stage, &position, &item)) {
+            if (stage->index > 0) {
+                /* the previous stage may be waiting for room */
+                task_pipeline_start(&pipeline->stages[stage->index - 1]);
+            }
+            if (item != NULL) {
+                item = (task_input_t) (intptr_t) stage->function(item);
+            }
+            task_pipeline_pass(stage, position, item);
+        }
+
+        /* leave the stage, then enter it again if an item has arrived */
+        size_t active = atomic_fetch_sub(&stage->active, 1) - 1;
+        do {
+            if (active >= stage->parallelism || !task_pipeline_is_ready(stage)) {
+                goto finish;
+            }
+        } while (!atomic_compare_exchange_weak(&stage->active, &active, active + 1));
+    }
+
+finish:
+    /* the pipeline can be freed as soon as the lock is released */
+    _ctool_mutex_lock(&pipeline->lock);
+    atomic_fetch_sub(&pipeline->running, 1);
+    _ctool_cond_broadcast(&pipeline->finished);
+    _ctool_mutex_unlock(&pipeline->lock);
+    return task_output_default;
+}
+
+/**
+ * Initializes an empty pipeline on a task manager
+ *
+ * @param[in] pipeline The pipeline
+ * @param[in] manager  The task manager
+ * @param[in] capacity Maximal number of stages
+ * @param[in] size     Capacity of every ring, a power of two,
+ *                      or 0 for TASK_PIPELINE_DEFAULT_SIZE
+ *
+ * @return ST_BAD_ARG if the ring capacity is not a power of two,
+ *         ST_ALLOC_FAIL if an allocation fails,
+ *         ST_FAIL if synchronization primitives
+ *          can't be initialized, otherwise ST_OK
+ */
+status_t task_pipeline_init(task_pipeline_t* pipeline, task_manager_t* manager, size_t capacity, size_t size) {
+    if (size == 0) {
+        size = TASK_PIPELINE_DEFAULT_SIZE;
+    }
+    assertrc_true(size >= 2 && (size & (size - 1)) == 0, ST_BAD_ARG,
+        "pipeline ring capacity %zu is not a power of two", size)
+    pipeline->size = size;
+    pipeline->count = 0;
+    pipeline->capacity = capacity;
+    pipeline->manager = manager;
+    assertr_malloc(pipeline->stages, sizeof(task_pipeline_stage_t) * capacity, task_pipeline_stage_t*)
+    atomic_init(&pipeline->tail, 0);
+    atomic_init(&pipeline->completed, 0);
+    atomic_init(&pipeline->running, 0);
+    atomic_init(&pipeline->waiters, 0);
+    assertr_zero(_ctool_mutex_init(&pipeline->lock), ST_FAIL);
+    assertr_zero(_ctool_cond_init(&pipeline->finished), ST_FAIL);
+    return ST_OK;
+}
+
+/**
+ * Frees memory allocated for a pipeline
+ *
+ * Every pushed item must have completed,
+ * see task_pipeline_await().
+ *
+ * @param[in] pipeline The pipeline
+ */
+void task_pipeline_free(task_pipeline_t* pipeline) {
+    iterate_array(i, pipeline->count) {
+        free(pipeline->stages[i].input);
+    }
+    free(pipeline->stages);
+    pipeline->stages = NULL;
+    pipeline->count = 0;
+    pipeline->capacity = 0;
+    _ctool_cond_destroy(&pipeline->finished);
+    _ctool_mutex_destroy(&pipeline->lock);
+}
+
+/**
+ * Appends a stage to a pipeline
+ *
+ * A stage with parallelism 1 is serial, it receives
+ * the items in the order they were pushed, even if
+ * the stages before it are parallel. If the function
+ * returns NULL, the item is dropped and the next
+ * stages skip it. The output of the last stage
+ * is discarded.
+ *
+ * @param[in] pipeline    The pipeline
+ * @param[in] function    The stage function
+ * @param[in] parallelism Maximal number of items processed
+ *                         at once, or 0 for every worker
+ *
+ * @return ST_FAIL if the pipeline is full
+ *          or items have been pushed already,
+ *         ST_ALLOC_FAIL if an allocation fails,
+ *          otherwise ST_OK
+ */
+status_t task_pipeline_add(task_pipeline_t* pipeline, task_function_t function, size_t parallelism) {
+    assertrc_true(pipeline->count < pipeline->capacity, ST_FAIL,
+        "pipeline is full with %zu stages", pipeline->capacity)
+    assertrc_zero(atomic_load(&pipeline->tail), ST_FAIL, "can't add a stage after items are pushed")
+
+    task_pipeline_stage_t* stage = &pipeline->stages[pipeline->count];
+    assertr_malloc(stage->input, sizeof(task_pipeline_cell_t) * pipeline->size, task_pipeline_cell_t*)
+    iterate_array(i, pipeline->size) {
+        atomic_init(&stage->input[i].sequence, i);
+        stage->input[i].item = NULL;
+    }
+    atomic_init(&stage->head, 0);
+    atomic_init(&stage->active, 0);
+    stage->parallelism = parallelism != 0 ? parallelism : pipeline->manager->pool.capacity;
+    stage->index = pipeline->count;
+    stage->function = function;
+    stage->pipeline = pipeline;
+    pipeline->count++;
+    return ST_OK;
+}
+
+/**
+ * Pushes an item into the first stage of a pipeline
+ *
+ * Can be called from any thread at any time.
+ *
+ * @param[in] pipeline The pipeline
+ * @param[in] item     The item
+ *
+ * @return ST_FAIL if the pipeline has no stages,
+ *         ST_BUSY if the first ring is full, otherwise ST_OK
+ */
+status_t task_pipeline_push(task_pipeline_t* pipeline, task_input_t item) {
+    assertrc_true(pipeline->count > 0, ST_FAIL, "can't push an item into a pipeline without stages")
+    task_pipeline_stage_t* first = &pipeline->stages[0];
+    size_t tail = atomic_load(&pipeline->tail);
+    task_pipeline_cell_t* cell;
+    while (true) {
+        cell = &first->input[tail & (pipeline->size - 1)];
+        size_t sequence = atomic_load(&cell->sequence);
+        if (sequence == tail) {
+            if (atomic_compare_exchange_weak(&pipeline->tail, &tail, tail + 1)) {
+                break;
+            }
+        } else if (sequence < tail) {
+            /* the first stage is behind */
+            return ST_BUSY;
+        } else {
+            tail = atomic_load(&pipeline->tail);
+        }
+    }
+
+    cell->item = item;
+    atomic_store(&cell->sequence, tail + 1);
+    task_pipeline_start(first);
+    return ST_OK;
+}
+
+/**
+ * Waits for every pushed item to leave
+ * the last stage of a pipeline
+ *
+ * @param[in] pipeline The pipeline
+ */
+void task_pipeline_await(task_pipeline_t* pipeline) {
+    atomic_fetch_add(&pipeline->waiters, 1);
+    _ctool_mutex_lock(&pipeline->lock);
+    while (atomic_load(&pipeline->completed) < atomic_load(&pipeline->tail)
+            || atomic_load(&pipeline->running) > 0) {
+        _ctool_cond_wait(&pipeline->finished, &pipeline->lock);
+    }
+    _ctool_mutex_unlock(&pipeline->lock);
+    atomic_fetch_sub(&pipeline->waiters, 1);
+}
\ No newline at end of file
@@ -0,0 +1,116 @@
+/**
+ * @file queue.c
+ * @author andersonarc (e.andersonarc@gmail.com)
+ * @version 0.1
+ * @date 2021-05-17
+ * 
+ *  Bounded lock-free multi-producer/multi-consumer task queue
+ * 
+ *  A cell is free for the producer of position `p`
+ *  when its sequence equals `p`, and is ready for 
+ *  the consumer of position `p` when its sequence 
+ *  equals `p + 1`.
+ */
+    /* includes */
+#include "ctool/thread/queue.h" /* this */
+#include <stdlib.h> /* memory allocation */
+#include "ctool/assert/runtime.h" /* runtime assertions */
+#include "ctool/iteration.h" /* range iteration */
+
+    /* functions */
+/**
+ * Initializes an empty queue
+ * 
+ * @param[in] queue The queue
+ * @param[in] size  Capacity, a power of two
+ * 
+ * @return ST_BAD_ARG if the capacity is not a power of two,
+ *         ST_ALLOC_FAIL if an allocation fails,
+ *          otherwise ST_OK
+ */
+status_t task_queue_init(task_queue_t* queue, size_t size) {
+    assertrc_true(size >= 2 && (size & (size - 1)) == 0, ST_BAD_ARG, 
+        "task queue size %zu is not a power of two", size)
+    assertr_malloc(queue->data, sizeof(task_queue_cell_t) * size, task_queue_cell_t*);
+    queue->size = size;
+    iterate_array(i, size) {
+        atomic_init(&queue->data[i].sequence, i);
+    }
+    atomic_init(&queue->tail, 0);
+    atomic_init(&queue->head, 0);
+    return ST_OK;
+}
+
+/**
+ * Frees memory allocated for a queue
+ * 
+ * @param[in] queue The queue
+ */
+void task_queue_free(task_queue_t* queue) {
+    free(queue->data);
+    queue->data = NULL;
+}
+
+/**
+ * Appends a task to the tail of a queue
+ * 
+ * @param[in] queue The queue
+ * @param[in] task  The task
+ * 
+ * @return false if the queue is full, otherwise true
+ */
+bool task_queue_push(task_queue_t* queue, task_t task) {
+    size_t position = atomic_load_explicit(&queue->tail, memory_order_relaxed);
+    while (true) {
+        task_queue_cell_t* cell = &queue->data[position & (queue->size - 1)];
+        size_t sequence = atomic_load_explicit(&cell->sequence, memory_order_acquire);
+        ptrdiff_t difference = (ptrdiff_t) sequence - (ptrdiff_t) position;
+        if (difference == 0) {
+            /* the cell is free, claim it */
+            if (atomic_compare_exchange_weak_explicit(&queue->tail, &position, position + 1,
+                    memory_order_relaxed, memory_order_relaxed)) {
+                cell->task = task;
+                atomic_store_explicit(&cell->sequence, position + 1, memory_order_release);
+                return true;
+            }
+        } else if (difference < 0) {
+            /* the cell still holds a task from the previous lap */
+            return false;
+        } else {
+            /* another producer took the position */
+            position = atomic_load_explicit(&queue->tail, memory_order_relaxed);
+        }
+    }
+}
+
+/**
+ * Removes a task from the head of a queue
+ * 
+ * @param[in]  queue The queue
+ * @param[out] task  The task
+ * 
+ * @return false if the queue is empty, otherwise true
+ */
+bool task_queue_pop(task_queue_t* queue, task_t* task) {
+    size_t position = atomic_load_explicit(&queue->head, memory_order_relaxed);
+    while (true) {
+        task_queue_cell_t* cell = &queue->data[position & (queue->size - 1)];
+        size_t sequence = atomic_load_explicit(&cell->sequence, memory_order_acquire);
+        ptrdiff_t difference = (ptrdiff_t) sequence - (ptrdiff_t) (position + 1);
+        if (difference == 0) {
+            /* the cell is ready, claim it */
+            if (atomic_compare_exchange_weak_explicit(&queue->head, &position, position + 1,
+                    memory_order_relaxed, memory_order_relaxed)) {
+                *task = cell->task;
+                atomic_store_explicit(&cell->sequence, position + queue->size, memory_order_release);
+                return true;
+            }
+        } else if (difference < 0) {
+            /* the cell has not been filled yet */
+            return false;
+        } else {
+            /* another consumer took the position */
+            position = atomic_load_explicit(&queue->head, memory_order_relaxed);
+        }
+    }
+}
\ No newline at end of file
@@ -0,0 +1,405 @@
+/**
+ * @file timer.c
+ * @author andersonarc (e.andersonarc@gmail.com)
+ * @version 0.1
+ * @date 2021-06-08
+ * 
+ *  Delayed and periodic tasks on a hierarchical timer wheel
+ * 
+ *  Timers are kept in TASK_TIMER_LEVELS wheels of 
+ *  TASK_TIMER_SLOTS slots, each level covering 
+ *  TASK_TIMER_SLOTS times longer span than the previous 
+ *  one. Starting and cancelling a timer is O(1), and
+ *  a single timer thread moves the timers down the levels
+ *  and enqueues the expired tasks to a task manager.
+ */
+    /* includes */
+#include "ctool/thread/timer.h" /* this */
+#include <stdint.h> /* UINT64_MAX */
+#include "ctool/assert/runtime.h" /* runtime assertions */
+#include "ctool/iteration.h" /* range iteration */
+
+    /* defines */
+/**
+ * Initializes a thread instance and
+ * runs a timer wheel on it
+ * 
+ * @param[in] thread Pointer to the thread
+ * @param[in] wheel  The timer wheel
+ * 
+ * @return 0 if everything is OK
+ */
+#ifdef CTOOL_THREAD_USE_POSIX
+    #define thread_initialize(thread, wheel) pthread_create(thread, NULL, (task_function_t) &task_timer_main, wheel)
+#else
+    #define thread_initialize(thread, wheel) thrd_create(thread, (task_function_t) &task_timer_main, wheel)
+#endif
+
+/**
+ * Waits for a thread to exit
+ * 
+ * @param[in] thread The thread
+ * 
+ * @return 0 if everything is OK
+ */
+#ifdef CTOOL_THREAD_USE_POSIX
+    #define thread_join(thread) pthread_join(thread, NULL)
+#else
+    #define thread_join(thread) thrd_join(thread, NULL)
+#endif
+
+/**
+ * Mask of a slot index on a level
+ */
+#define TASK_TIMER_MASK (TASK_TIMER_SLOTS - 1)
+
+/**
+ * Number of ticks covered by the whole wheel
+ */
+#define TASK_TIMER_SPAN ((uint64_t) 1 << (TASK_TIMER_SLOT_BITS * TASK_TIMER_LEVELS))
+
+    /* functions */
+/**
+ * Links a timer into the slot of its expiration tick
+ * 
+ * Timers expiring beyond the span of the wheel are placed
+ * into the farthest slot and moved again when it is reached.
+ * 
+ * @note Must be called with the wheel locked
+ * 
+ * @param[in] wheel The timer wheel
+ * @param[in] timer The timer
+ */
+static void task_timer_link(task_timer_wheel_t* wheel, task_timer_t* timer) {
+    uint64_t expires = timer->expires > wheel->current ? timer->expires : wheel->current;
+    if (expires - wheel->current >= TASK_TIMER_SPAN) {
+        expires = wheel->current + TASK_TIMER_SPAN - 1;
+    }
+
+    /* select the lowest level that covers the delay */
+    uint64_t delta = expires - wheel->current;
+    size_t level = 0;
+    while (delta >> (TASK_TIMER_SLOT_BITS * (level + 1)) != 0) {
+        level++;
+    }
+    task_timer_t** slot = &wheel->slots[level][(expires >> (TASK_TIMER_SLOT_BITS * level)) & TASK_TIMER_MASK];
+
+    timer->next = *slot;
+    if (timer->next != NULL) {
+        timer->next->link = &timer->next;
+    }
+    timer->link = slot;
+    *slot = timer;
+}
+
+/**
+ * Unlinks a timer from its slot
+ * 
+ * @note Must be called with the wheel locked
+ * 
+ * @param[in] timer The timer
+ */
+static void task_timer_unlink(task_timer_t* timer) {
+    *timer->link = timer->next;
+    if (timer->next != NULL) {
+        timer->next->link = timer->link;
+    }
+}
+
+/**
+ * Takes all timers out of a slot
+ * 
+ * @note Must be called with the wheel locked
+ * 
+ * @param[in] slot The slot
+ * 
+ * @return The first timer of the slot
+ */
+static inline task_timer_t* task_timer_take(task_timer_t** slot) {
+    task_timer_t* timers = *slot;
+    *slot = NULL;
+    return timers;
+}
+
+/**
+ * Enqueues the task of an expired timer and
+ * links the timer again if it is periodic
+ * 
+ * @note Must be called with the wheel locked
+ * 
+ * @param[in] wheel The timer wheel
+ * @param[in] timer The timer
+ */
+static void task_timer_fire(task_timer_wheel_t* wheel, task_timer_t* timer) {
+    if (task_manager_enqueue(wheel->manager, timer->task) != ST_OK) {
+        /* the queue is full, retry on the next tick */
+        timer->expires = wheel->current + 1;
+    } else if (timer->interval != 0) {
+        /* keep a fixed rate, skipping the missed periods */
+        timer->expires += timer->interval;
+        if (timer->expires <= wheel->current) {
+            timer->expires = wheel->current + 1;
+        }
+    } else {
+        timer->active = false;
+        wheel->count--;
+        return;
+    }
+    task_timer_link(wheel, timer);
+}
+
+/**
+ * Finds the next tick of a timer wheel on which 
+ * a timer expires or is moved down a level
+ * 
+ * The slot of a higher level is moved down on the first
+ * tick that starts it, so the ticks in between can be skipped.
+ * 
+ * @note Must be called with the wheel locked
+ * 
+ * @param[in] wheel The timer wheel
+ * 
+ * @return The tick, or UINT64_MAX if all slots are empty
+ */
+static uint64_t task_timer_next(task_timer_wheel_t* wheel) {
+    uint64_t next = UINT64_MAX;
+    iterate_array(i, TASK_TIMER_SLOTS) {
+        if (wheel->slots[0][(wheel->current + i) & TASK_TIMER_MASK] != NULL) {
+            next = wheel->current + i;
+            break;
+        }
+    }
+    iterate_range_single(level, 1, TASK_TIMER_LEVELS) {
+        size_t shift = TASK_TIMER_SLOT_BITS * level;
+        /* the first slot of the level starting at the current tick or later */
+        uint64_t first = (wheel->current + ((uint64_t) 1 << shift) - 1) >> shift;
+        iterate_array(index, TASK_TIMER_SLOTS) {
+            if (wheel->slots[level][index] != NULL) {
+                uint64_t tick = (first + ((index - first) & TASK_TIMER_MASK)) << shift;
+                next = tick < next ? tick : next;
+            }
+        }
+    }
+    return next;
+}
+
+/**
+ * Processes the ticks of a timer wheel 
+ * up to a specified one, inclusive
+ * 
+ * When the slot index of a level wraps around,
+ * the timers of the current slot of the next level
+ * are moved down before the tick is processed.
+ * Ticks on which nothing happens are skipped.
+ * 
+ * @note Must be called with the wheel locked
+ * 
+ * @param[in] wheel The timer wheel
+ * @param[in] tick  The last tick to process
+ */
+static void task_timer_advance(task_timer_wheel_t* wheel, uint64_t tick) {
+    while (wheel->count > 0) {
+        uint64_t upcoming = task_timer_next(wheel);
+        if (upcoming > tick) {
+            break;
+        }
+        wheel->current = upcoming;
+
+        /* cascade from the higher levels */
+        iterate_range_single(level, 1, TASK_TIMER_LEVELS) {
+            if (((wheel->current >> (TASK_TIMER_SLOT_BITS * (level - 1))) & TASK_TIMER_MASK) != 0) {
+                break;
+            }
+            size_t index = (wheel->current >> (TASK_TIMER_SLOT_BITS * level)) & TASK_TIMER_MASK;
+            task_timer_t* timer = task_timer_take(&wheel->slots[level][index]);
+            while (timer != NULL) {
+                task_timer_t* next = timer->next;
+                task_timer_link(wheel, timer);
+                timer = next;
+            }
+        }
+
+        /* fire the expired timers */
+        task_timer_t* timer = task_timer_take(&wheel->slots[0][wheel->current & TASK_TIMER_MASK]);
+        wheel->current++;
+        while (timer != NULL) {
+            task_timer_t* next = timer->next;
+            task_timer_fire(wheel, timer);
+            timer = next;
+        }
+    }
+    if (wheel->current <= tick) {
+        /* nothing left to process, skip the idle ticks */
+        wheel->current = tick + 1;
+    }
+}
+
+/**
+ * Returns the current tick of a timer wheel
+ * 
+ * @param[in] wheel The timer wheel
+ */
+static inline uint64_t task_timer_now(task_timer_wheel_t* wheel) {
+    return (_ctool_thread_time() - wheel->origin) / wheel->resolution;
+}
+
+/**
+ * Processes the ticks of a timer wheel as they pass
+ * 
+ * The thread sleeps until the next tick on which
+ * a timer expires or is moved down a level while there
+ * are active timers, and is parked otherwise. Starting
+ * a timer that expires earlier wakes it up.
+ * 
+ * @param[in] wheel The timer wheel
+ * 
+ * @return Default task output
+ */
+static task_output_t task_timer_main(task_timer_wheel_t* wheel) {
+    _ctool_mutex_lock(&wheel->lock);
+    while (!wheel->stopped) {
+        if (wheel->count == 0) {
+            wheel->next = UINT64_MAX;
+            _ctool_cond_wait(&wheel->wakeup, &wheel->lock);
+            continue;
+        }
+
+        /* sleep until the start of the next tick with work */
+        wheel->next = task_timer_next(wheel);
+        uint64_t deadline = wheel->origin + wheel->next * wheel->resolution;
+        uint64_t now = _ctool_thread_time();
+        if (deadline > now) {
+            struct timespec timeout;
+            _ctool_thread_deadline(&timeout, deadline - now);
+            _ctool_cond_timedwait(&wheel->wakeup, &wheel->lock, &timeout);
+        }
+        task_timer_advance(wheel, task_timer_now(wheel));
+    }
+    _ctool_mutex_unlock(&wheel->lock);
+    return task_output_default;
+}
+
+/**
+ * Creates a timer wheel and starts its timer thread
+ * 
+ * @param[in] wheel      The timer wheel
+ * @param[in] manager    Task manager to execute the tasks
+ * @param[in] resolution Duration of a tick in nanoseconds,
+ *                       0 selects the default
+ * 
+ * @return ST_FAIL if the timer thread can't be started,
+ *          otherwise ST_OK
+ */
+status_t task_timer_wheel_create(task_timer_wheel_t* wheel, task_manager_t* manager, uint64_t resolution) {
+    wheel->manager = manager;
+    wheel->resolution = resolution != 0 ? resolution : TASK_TIMER_DEFAULT_RESOLUTION;
+    wheel->origin = _ctool_thread_time();
+    wheel->current = 0;
+    wheel->next = UINT64_MAX;
+    wheel->count = 0;
+    wheel->stopped = false;
+    iterate_array(level, TASK_TIMER_LEVELS) {
+        iterate_array(slot, TASK_TIMER_SLOTS) {
+            wheel->slots[level][slot] = NULL;
+        }
+    }
+    assertr_zero(_ctool_mutex_init(&wheel->lock), ST_FAIL);
+    assertr_zero(_ctool_cond_init(&wheel->wakeup), ST_FAIL);
+    assertr_zero(thread_initialize(&wheel->thread, wheel), ST_FAIL);
+    return ST_OK;
+}
+
+/**
+ * Stops the timer thread of a timer wheel
+ * 
+ * Active timers are dropped, the tasks that 
+ * have already been enqueued are still executed.
+ * 
+ * @param[in] wheel The timer wheel
+ */
+void task_timer_wheel_delete(task_timer_wheel_t* wheel) {
+    _ctool_mutex_lock(&wheel->lock);
+    wheel->stopped = true;
+    _ctool_cond_signal(&wheel->wakeup);
+    _ctool_mutex_unlock(&wheel->lock);
+    thread_join(wheel->thread);
+
+    iterate_array(level, TASK_TIMER_LEVELS) {
+        iterate_array(slot, TASK_TIMER_SLOTS) {
+            task_timer_t* timer = wheel->slots[level][slot];
+            while (timer != NULL) {
+                timer->active = false;
+                timer = timer->next;
+            }
+        }
+    }
+    _ctool_cond_destroy(&wheel->wakeup);
+    _ctool_mutex_destroy(&wheel->lock);
+}
+
+/**
+ * Starts a timer, which enqueues a task after a delay
+ * and then, if `interval` is not 0, repeatedly
+ * with a fixed rate
+ * 
+ * Restarts the timer if it is already active.
+ * Expirations are rounded up to the next tick, and
+ * missed periods are skipped. If the queue of the task
+ * manager is full, the task is enqueued on the next tick.
+ * 
+ * @param[in] wheel    The timer wheel
+ * @param[in] timer    The timer
+ * @param[in] task     The task
+ * @param[in] delay    Delay in nanoseconds
+ * @param[in] interval Period in nanoseconds, or 0
+ */
+void task_timer_start(task_timer_wheel_t* wheel, task_timer_t* timer, task_t task, uint64_t delay, uint64_t interval) {
+    uint64_t expires = _ctool_thread_time() - wheel->origin + delay;
+
+    _ctool_mutex_lock(&wheel->lock);
+    if (wheel->count == 0) {
+        /* the wheel is empty, skip the idle ticks */
+        uint64_t now = task_timer_now(wheel);
+        if (now > wheel->current) {
+            wheel->current = now;
+        }
+    }
+    if (timer->active) {
+        task_timer_unlink(timer);
+    } else {
+        timer->active = true;
+        wheel->count++;
+    }
+    timer->task = task;
+    timer->expires = (expires + wheel->resolution - 1) / wheel->resolution;
+    timer->interval = interval != 0 ? (interval + wheel->resolution - 1) / wheel->resolution : 0;
+    task_timer_link(wheel, timer);
+    if (timer->expires < wheel->next) {
+        /* the timer thread might be parked or sleep past the expiration */
+        _ctool_cond_signal(&wheel->wakeup);
+    }
+    _ctool_mutex_unlock(&wheel->lock);
+}
+
+/**
+ * Cancels a timer
+ * 
+ * After it returns, the timer is not used by the wheel
+ * anymore, but a task enqueued before might still run.
+ * 
+ * @param[in] wheel The timer wheel
+ * @param[in] timer The timer
+ * 
+ * @return false if the timer was not active, otherwise true
+ */
+bool task_timer_cancel(task_timer_wheel_t* wheel, task_timer_t* timer) {
+    _ctool_mutex_lock(&wheel->lock);
+    bool active = timer->active;
+    if (active) {
+        task_timer_unlink(timer);
+        timer->active = false;
+        wheel->count--;
+    }
+    _ctool_mutex_unlock(&wheel->lock);
+    return active;
+}
\ No newline at end of file
@@ -0,0 +1,108 @@
+/**
+ * @file affinity.c
+ * @author andersonarc (e.andersonarc@gmail.com)
+ * @version 0.1
+ * @date 2021-06-05
+ * 
+ *  Tests for worker placement and pinning
+ */
+    /* feature test macros */
+#define _GNU_SOURCE /* sched_getcpu() */
+
+    /* includes */
+#include <sched.h> /* sched_getcpu() */
+#include "ctool/assert.h" /* assertions */
+#include "ctool/thread.h" /* task manager */
+
+    /* constant presets */
+#define CTOOL_TASK_THREADS 4
+#define CTOOL_TASKS 64
+
+    /* task execution counters */
+atomic_size_t misplaced = 0;
+
+    /* sample tasks */
+task_output_t check_placement(task_input_t input) {
+    task_worker_t* worker = task_worker_current();
+    if (worker == NULL || worker->cpu < 0 || worker->node < 0 || sched_getcpu() != worker->cpu) {
+        misplaced++;
+    }
+    return task_output_default;
+}
+
+    /* functions */
+/**
+ * Tests compact and spread placement
+ * on a topology of two nodes
+ * 
+ * @return ST_FAIL if an assertion fails,
+ *          otherwise ST_OK
+ */
+status_t test_affinity_place() {
+    int first[] = { 0, 1 }, second[] = { 2, 3 };
+    task_topology_node_t nodes[] = { { 0, 2, first }, { 1, 2, second } };
+    task_topology_t topology = { 2, nodes };
+    int compact[] = { 0, 1, 2, 3, 0 }, spread[] = { 0, 2, 1, 3, 0 };
+    int cpu, node;
+
+    for (size_t i = 0; i < 5; i++) {
+        task_topology_place(&topology, CTOOL_TASK_AFFINITY_COMPACT, i, &cpu, &node);
+        assertr_equals(cpu, compact[i], ST_FAIL);
+        assertr_equals(node, compact[i] / 2, ST_FAIL);
+        task_topology_place(&topology, CTOOL_TASK_AFFINITY_SPREAD, i, &cpu, &node);
+        assertr_equals(cpu, spread[i], ST_FAIL);
+        assertr_equals(node, spread[i] / 2, ST_FAIL);
+    }
+    task_topology_place(&topology, CTOOL_TASK_AFFINITY_NONE, 0, &cpu, &node);
+    assertr_equals(cpu, -1, ST_FAIL);
+    assertr_equals(node, -1, ST_FAIL);
+    return ST_OK;
+}
+
+/**
+ * Tests if the system topology can be read
+ * and tasks run on the CPUs of their workers
+ * 
+ * @return ST_FAIL if an assertion fails,
+ *          otherwise ST_OK
+ */
+status_t test_affinity_pinned() {
+    task_topology_t topology;
+    assertr_status(task_topology_init(&topology), ST_FAIL);
+    assertr_true(topology.size > 0, ST_FAIL);
+    for (size_t i = 0; i < topology.size; i++) {
+        assertr_true(topology.nodes[i].size > 0, ST_FAIL);
+    }
+    task_topology_free(&topology);
+    assertr_true(task_worker_current() == NULL, ST_FAIL);
+
+    task_manager_t manager;
+    task_list_t tasks;
+    task_manager_options_t options = { 
+        .threads = CTOOL_TASK_THREADS, .scheduler = CTOOL_TASK_SCHEDULER_STEALING,
+        .affinity = CTOOL_TASK_AFFINITY_SPREAD
+    };
+    assertr_status(task_manager_create_custom(&manager, options), ST_FAIL);
+    assertr_status(task_list_init(&tasks, CTOOL_TASKS), ST_FAIL);
+    for (size_t i = 0; i < CTOOL_TASKS; i++) {
+        tasks.data[i].function = check_placement;
+        tasks.data[i].input = task_input_default;
+    }
+    assertr_status(task_manager_submit(&manager, tasks), ST_FAIL);
+    task_manager_await(&manager);
+    assertr_zero(misplaced, ST_FAIL);
+
+    task_manager_delete(&manager);
+    return ST_OK;
+}
+
+    /* main function */
+int main() {
+    if (test_affinity_place() != ST_OK) {
+        return EXIT_FAILURE;
+    }
+    if (test_affinity_pinned() != ST_OK) {
+        return EXIT_FAILURE;
+    }
+    return EXIT_SUCCESS;
+}
\ No newline at end of file
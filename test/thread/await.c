@@ -0,0 +1,118 @@
+/**
+ * @file await.c
+ * @author andersonarc (e.andersonarc@gmail.com)
+ * @version 0.1
+ * @date 2021-06-02
+ * 
+ *  Tests for task list completion tracking
+ */
+    /* includes */
+#include <poll.h> /* poll() */
+#include <stdint.h> /* uint64_t */
+#include <time.h> /* sleep */
+#include <unistd.h> /* read() */
+#include "ctool/assert.h" /* assertions */
+#include "ctool/thread.h" /* task manager */
+
+    /* constant presets */
+#define CTOOL_TASK_THREADS 16
+#define CTOOL_TASK_COUNT 64
+#define CTOOL_TASK_LISTS 20
+
+    /* time presets */
+struct timespec ms1 = { 0, 1000 * 1000 };
+
+    /* task execution counters */
+atomic_size_t executed = 0;
+
+    /* sample tasks */
+task_output_t slow_count(task_input_t input) {
+    /* every worker still runs a task when the index is exhausted */
+    nanosleep(&ms1, NULL);
+    executed++;
+    return task_output_default;
+}
+
+    /* functions */
+/**
+ * Creates a task list of slow tasks
+ * 
+ * @param[out] tasks The task list
+ * 
+ * @return ST_FAIL if the list can't be created,
+ *          otherwise ST_OK
+ */
+status_t create_tasks(task_list_t* tasks) {
+    assertr_status(task_list_init(tasks, CTOOL_TASK_COUNT), ST_FAIL);
+    for (size_t i = 0; i < CTOOL_TASK_COUNT; i++) {
+        tasks->data[i].function = slow_count;
+        tasks->data[i].input = task_input_default;
+    }
+    return ST_OK;
+}
+
+/**
+ * Tests if awaiting returns only after 
+ * the last task of a list has returned
+ * 
+ * @return ST_FAIL if an assertion fails,
+ *          otherwise ST_OK
+ */
+status_t test_await_completion() {
+    task_manager_t manager;
+    assertr_status(task_manager_create(&manager, CTOOL_TASK_THREADS), ST_FAIL);
+
+    for (size_t n = 0; n < CTOOL_TASK_LISTS; n++) {
+        task_list_t tasks;
+        executed = 0;
+        assertr_status(create_tasks(&tasks), ST_FAIL);
+        assertr_status(task_manager_submit(&manager, tasks), ST_FAIL);
+        task_manager_await(&manager);
+        assertr_equals(executed, CTOOL_TASK_COUNT, ST_FAIL);
+    }
+
+    task_manager_delete(&manager);
+    return ST_OK;
+}
+
+/**
+ * Tests if the eventfd of a task manager
+ * becomes readable when a list completes
+ * 
+ * @return ST_FAIL if an assertion fails,
+ *          otherwise ST_OK
+ */
+status_t test_await_eventfd() {
+    task_manager_t manager;
+    task_list_t tasks;
+    int fd;
+    assertr_status(task_manager_create(&manager, CTOOL_TASK_THREADS), ST_FAIL);
+    assertr_status(task_manager_eventfd(&manager, &fd), ST_FAIL);
+
+    executed = 0;
+    assertr_status(create_tasks(&tasks), ST_FAIL);
+    assertr_status(task_manager_submit(&manager, tasks), ST_FAIL);
+
+    /* wait for the descriptor instead of the manager */
+    struct pollfd event = { .fd = fd, .events = POLLIN };
+    assertr_equals(poll(&event, 1, 10000), 1, ST_FAIL);
+    assertr_equals(executed, CTOOL_TASK_COUNT, ST_FAIL);
+
+    uint64_t completed = 0;
+    assertr_equals(read(fd, &completed, sizeof(completed)), sizeof(completed), ST_FAIL);
+    assertr_equals(completed, 1, ST_FAIL);
+
+    task_manager_delete(&manager);
+    return ST_OK;
+}
+
+    /* main function */
+int main() {
+    if (test_await_completion() != ST_OK) {
+        return EXIT_FAILURE;
+    }
+    if (test_await_eventfd() != ST_OK) {
+        return EXIT_FAILURE;
+    }
+    return EXIT_SUCCESS;
+}
\ No newline at end of file
@@ -0,0 +1,165 @@
+/**
+ * @file cancel.c
+ * @author andersonarc (e.andersonarc@gmail.com)
+ * @version 0.1
+ * @date 2021-06-11
+ *
+ *  Tests for task list cancellation and deadlines
+ */
+    /* includes */
+#include <time.h> /* nanosleep() */
+#include "ctool/assert.h" /* assertions */
+#include "ctool/thread.h" /* task manager */
+
+    /* constant presets */
+#define CTOOL_TASK_THREADS 2
+#define CTOOL_TASK_LIST_SIZE 1000
+#define CTOOL_TASK_DEADLINE (5 * 1000 * 1000)
+
+    /* time presets */
+struct timespec us100 = { 0, 1000 * 100 };
+struct timespec ms5 = { 0, 1000 * 1000 * 5 };
+
+    /* task execution counter */
+atomic_size_t executed = 0;
+
+    /* sample tasks */
+task_output_t slow(task_input_t input) {
+    nanosleep(&us100, NULL);
+    executed++;
+    return (task_output_t) 1;
+}
+
+    /* functions */
+/**
+ * Creates a list of slow tasks with futures
+ *
+ * @param[out] tasks The task list
+ *
+ * @return ST_FAIL if an assertion fails,
+ *          otherwise ST_OK
+ */
+status_t create_list(task_list_t* tasks) {
+    executed = 0;
+    assertr_status(task_list_init_futures(tasks, CTOOL_TASK_LIST_SIZE), ST_FAIL);
+    for (size_t i = 0; i < CTOOL_TASK_LIST_SIZE; i++) {
+        tasks->data[i].function = slow;
+        tasks->data[i].input = task_input_default;
+    }
+    return ST_OK;
+}
+
+/**
+ * Checks that every task of the current list was either
+ * executed or cancelled, and that every future is ready
+ *
+ * @param[in] manager The task manager
+ *
+ * @return ST_FAIL if an assertion fails,
+ *          otherwise ST_OK
+ */
+status_t check_list(task_manager_t* manager) {
+    size_t cancelled = task_manager_cancelled(manager);
+    size_t skipped = 0;
+    assertr_equals(executed + cancelled, CTOOL_TASK_LIST_SIZE, ST_FAIL);
+    for (size_t i = 0; i < CTOOL_TASK_LIST_SIZE; i++) {
+        assertr_true(task_future_is_ready(&manager->tasks.futures[i]), ST_FAIL);
+        if (manager->tasks.futures[i].output == task_output_default) {
+            skipped++;
+        }
+    }
+    assertr_equals(skipped, cancelled, ST_FAIL);
+    return ST_OK;
+}
+
+/**
+ * Tests if a list is skipped entirely when
+ * its token is cancelled before submission,
+ * and partially when it is cancelled while running
+ *
+ * @param[in] manager The task manager
+ *
+ * @return ST_FAIL if an assertion fails,
+ *          otherwise ST_OK
+ */
+status_t test_cancel_token(task_manager_t* manager) {
+    task_cancel_t cancel;
+    task_list_t tasks;
+
+    task_cancel_init(&cancel);
+    task_cancel_request(&cancel);
+    assertr_status(create_list(&tasks), ST_FAIL);
+    tasks.cancel = &cancel;
+    assertr_status(task_manager_submit(manager, tasks), ST_FAIL);
+    task_manager_await(manager);
+    assertr_equals(task_manager_cancelled(manager), CTOOL_TASK_LIST_SIZE, ST_FAIL);
+    assertr_status(check_list(manager), ST_FAIL);
+
+    task_cancel_init(&cancel);
+    assertr_status(create_list(&tasks), ST_FAIL);
+    tasks.cancel = &cancel;
+    assertr_status(task_manager_submit(manager, tasks), ST_FAIL);
+    nanosleep(&ms5, NULL);
+    task_cancel_request(&cancel);
+    task_manager_await(manager);
+    assertr_true(task_manager_cancelled(manager) > 0, ST_FAIL);
+    assertr_true(executed > 0, ST_FAIL);
+    assertr_status(check_list(manager), ST_FAIL);
+    return ST_OK;
+}
+
+/**
+ * Tests if the tasks of a list are skipped
+ * after its deadline
+ *
+ * @param[in] manager The task manager
+ *
+ * @return ST_FAIL if an assertion fails,
+ *          otherwise ST_OK
+ */
+status_t test_cancel_deadline(task_manager_t* manager) {
+    task_list_t tasks;
+    assertr_status(create_list(&tasks), ST_FAIL);
+    tasks.deadline = task_deadline_after(CTOOL_TASK_DEADLINE);
+    assertr_status(task_manager_submit(manager, tasks), ST_FAIL);
+    task_manager_await(manager);
+    assertr_true(task_manager_cancelled(manager) > 0, ST_FAIL);
+    assertr_status(check_list(manager), ST_FAIL);
+
+    /* a new list starts with no cancelled tasks */
+    assertr_status(create_list(&tasks), ST_FAIL);
+    assertr_status(task_manager_submit(manager, tasks), ST_FAIL);
+    task_manager_await(manager);
+    assertr_equals(task_manager_cancelled(manager), 0, ST_FAIL);
+    assertr_equals(executed, CTOOL_TASK_LIST_SIZE, ST_FAIL);
+    return ST_OK;
+}
+
+/**
+ * Runs the cancellation tests with a scheduler
+ *
+ * @param[in] scheduler The task scheduler
+ *
+ * @return ST_FAIL if an assertion fails,
+ *          otherwise ST_OK
+ */
+status_t test_cancel(task_scheduler_t scheduler) {
+    task_manager_t manager;
+    task_manager_options_t options = { .threads = CTOOL_TASK_THREADS, .scheduler = scheduler };
+    assertr_status(task_manager_create_custom(&manager, options), ST_FAIL);
+    assertr_status(test_cancel_token(&manager), ST_FAIL);
+    assertr_status(test_cancel_deadline(&manager), ST_FAIL);
+    task_manager_delete(&manager);
+    return ST_OK;
+}
+
+    /* main function */
+int main() {
+    if (test_cancel(CTOOL_TASK_SCHEDULER_SHARED) != ST_OK) {
+        return EXIT_FAILURE;
+    }
+    if (test_cancel(CTOOL_TASK_SCHEDULER_STEALING) != ST_OK) {
+        return EXIT_FAILURE;
+    }
+    return EXIT_SUCCESS;
+}
\ No newline at end of file
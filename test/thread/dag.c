@@ -0,0 +1,124 @@
+/**
+ * @file dag.c
+ * @author andersonarc (e.andersonarc@gmail.com)
+ * @version 0.1
+ * @date 2021-06-07
+ * 
+ *  Tests for task dependency graphs
+ */
+    /* includes */
+#include <stdint.h> /* intptr_t */
+#include "ctool/assert.h" /* assertions */
+#include "ctool/thread.h" /* task manager */
+#include "ctool/thread/dag.h" /* task graph */
+
+    /* constant presets */
+#define CTOOL_TASK_THREADS 4
+#define CTOOL_DAG_NODES 2000
+#define CTOOL_DAG_EDGES 4
+
+    /* execution order */
+atomic_size_t ticks = 0;
+size_t stamps[CTOOL_DAG_NODES];
+atomic_size_t executed = 0;
+
+    /* sample tasks */
+task_output_t stamp(task_input_t input) {
+    stamps[(intptr_t) input] = ++ticks;
+    executed++;
+    return task_output_default;
+}
+
+    /* functions */
+/**
+ * Builds a random graph, runs it twice and checks
+ * if every node runs once after its predecessors
+ * 
+ * @param[in] options Options of the task manager
+ * 
+ * @return ST_FAIL if an assertion fails,
+ *          otherwise ST_OK
+ */
+status_t test_dag_order(task_manager_options_t options) {
+    task_manager_t manager;
+    task_dag_t dag;
+    static size_t predecessors[CTOOL_DAG_NODES][CTOOL_DAG_EDGES];
+    assertr_status(task_manager_create_custom(&manager, options), ST_FAIL);
+    assertr_status(task_dag_init(&dag, 0), ST_FAIL);
+
+    srand(1);
+    for (size_t i = 0; i < CTOOL_DAG_NODES; i++) {
+        size_t node;
+        assertr_status(task_dag_add(&dag, (task_t) { stamp, (task_input_t) (intptr_t) i }, &node), ST_FAIL);
+        assertr_equals(node, i, ST_FAIL);
+        for (size_t j = 0; j < CTOOL_DAG_EDGES; j++) {
+            /* every tenth node is a root */
+            predecessors[i][j] = (i % 10 == 0) ? i : (size_t) rand() % i;
+            if (predecessors[i][j] != i) {
+                assertr_status(task_dag_depend(&dag, i, predecessors[i][j]), ST_FAIL);
+            }
+        }
+    }
+
+    for (size_t run = 0; run < 2; run++) {
+        executed = 0;
+        assertr_status(task_dag_run(&manager, &dag), ST_FAIL);
+        task_dag_await(&dag);
+        assertr_equals(executed, CTOOL_DAG_NODES, ST_FAIL);
+        for (size_t i = 0; i < CTOOL_DAG_NODES; i++) {
+            for (size_t j = 0; j < CTOOL_DAG_EDGES; j++) {
+                if (predecessors[i][j] != i) {
+                    assertr_true(stamps[predecessors[i][j]] < stamps[i], ST_FAIL);
+                }
+            }
+        }
+    }
+
+    task_dag_free(&dag);
+    task_manager_delete(&manager);
+    return ST_OK;
+}
+
+/**
+ * Tests if invalid dependencies and cycles are rejected
+ * 
+ * @return ST_FAIL if an assertion fails,
+ *          otherwise ST_OK
+ */
+status_t test_dag_cycle() {
+    task_manager_t manager;
+    task_dag_t dag;
+    assertr_status(task_manager_create(&manager, 1), ST_FAIL);
+    assertr_status(task_dag_init(&dag, 4), ST_FAIL);
+    assertr_status(task_dag_run(&manager, &dag), ST_FAIL);
+    task_dag_await(&dag);
+
+    for (size_t i = 0; i < 3; i++) {
+        assertr_status(task_dag_add(&dag, (task_t) { stamp, (task_input_t) (intptr_t) i }, NULL), ST_FAIL);
+    }
+    assertr_equals(task_dag_depend(&dag, 0, 0), ST_BAD_ARG, ST_FAIL);
+    assertr_equals(task_dag_depend(&dag, 3, 0), ST_BAD_ARG, ST_FAIL);
+    assertr_status(task_dag_depend(&dag, 1, 0), ST_FAIL);
+    assertr_status(task_dag_depend(&dag, 2, 1), ST_FAIL);
+    assertr_status(task_dag_depend(&dag, 0, 2), ST_FAIL);
+    assertr_equals(task_dag_run(&manager, &dag), ST_BAD_ARG, ST_FAIL);
+
+    task_dag_free(&dag);
+    task_manager_delete(&manager);
+    return ST_OK;
+}
+
+    /* main function */
+int main() {
+    if (test_dag_order((task_manager_options_t) { .threads = CTOOL_TASK_THREADS }) != ST_OK) {
+        return EXIT_FAILURE;
+    }
+    /* a tiny queue, most nodes are executed by the releasing thread */
+    if (test_dag_order((task_manager_options_t) { .threads = CTOOL_TASK_THREADS, .queue_size = 2 }) != ST_OK) {
+        return EXIT_FAILURE;
+    }
+    if (test_dag_cycle() != ST_OK) {
+        return EXIT_FAILURE;
+    }
+    return EXIT_SUCCESS;
+}
\ No newline at end of file
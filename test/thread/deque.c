@@ -0,0 +1,136 @@
+/**
+ * @file deque.c
+ * @author andersonarc (e.andersonarc@gmail.com)
+ * @version 0.1
+ * @date 2021-06-02
+ * 
+ *  Tests for the work-stealing deque
+ *  and the stealing task scheduler
+ */
+    /* includes */
+#include "ctool/assert.h" /* assertions */
+#include "ctool/thread.h" /* task manager */
+
+    /* constant presets */
+#define CTOOL_TASK_THREADS 8
+#define CTOOL_TASK_COUNT 100000
+
+    /* task execution counters */
+atomic_size_t executed = 0;
+atomic_size_t checksum = 0;
+
+    /* sample tasks */
+task_output_t count(task_input_t input) {
+    checksum += (size_t) input;
+    executed++;
+    return task_output_default;
+}
+
+    /* functions */
+/**
+ * Tests if the owner pops tasks in LIFO order,
+ * thieves steal them in FIFO order and
+ * the deque grows past its initial capacity
+ * 
+ * @return ST_FAIL if an assertion fails,
+ *          otherwise ST_OK
+ */
+status_t test_deque_order() {
+    task_deque_t deque;
+    task_t tasks[10];
+    assertr_status(task_deque_init(&deque, 2), ST_FAIL);
+    assertr_true(task_deque_is_empty(&deque), ST_FAIL);
+
+    /* push more tasks than the initial capacity */
+    for (size_t i = 0; i < 10; i++) {
+        assertr_status(task_deque_push(&deque, &tasks[i]), ST_FAIL);
+    }
+    assertr_false(task_deque_is_empty(&deque), ST_FAIL);
+
+    /* steal from the top, pop from the bottom */
+    assertr_equals(task_deque_steal(&deque), &tasks[0], ST_FAIL);
+    assertr_equals(task_deque_steal(&deque), &tasks[1], ST_FAIL);
+    assertr_equals(task_deque_pop(&deque), &tasks[9], ST_FAIL);
+    for (size_t i = 8; i >= 2; i--) {
+        assertr_equals(task_deque_pop(&deque), &tasks[i], ST_FAIL);
+    }
+    assertr_true(task_deque_pop(&deque) == NULL, ST_FAIL);
+    assertr_true(task_deque_steal(&deque) == NULL, ST_FAIL);
+    assertr_true(task_deque_is_empty(&deque), ST_FAIL);
+
+    task_deque_free(&deque);
+    return ST_OK;
+}
+
+/**
+ * Tests if the stealing scheduler executes
+ * every task of several lists exactly once
+ * 
+ * @return ST_FAIL if an assertion fails,
+ *          otherwise ST_OK
+ */
+status_t test_stealing_scheduler() {
+    task_manager_t manager;
+    task_manager_options_t options = { .threads = CTOOL_TASK_THREADS, .scheduler = CTOOL_TASK_SCHEDULER_STEALING };
+    assertr_status(task_manager_create_custom(&manager, options), ST_FAIL);
+
+    /* odd sizes leave some workers without a block */
+    size_t sizes[] = { CTOOL_TASK_COUNT, 3, 0, CTOOL_TASK_COUNT + 7 };
+    for (size_t n = 0; n < sizeof(sizes) / sizeof(sizes[0]); n++) {
+        task_list_t tasks;
+        executed = 0;
+        checksum = 0;
+        assertr_status(task_list_init(&tasks, sizes[n]), ST_FAIL);
+        for (size_t i = 0; i < sizes[n]; i++) {
+            tasks.data[i].function = count;
+            tasks.data[i].input = (task_input_t) i;
+        }
+
+        assertr_status(task_manager_submit(&manager, tasks), ST_FAIL);
+        task_manager_await(&manager);
+        assertr_equals(executed, sizes[n], ST_FAIL);
+        assertr_equals(checksum, sizes[n] * (sizes[n] - 1) / 2, ST_FAIL);
+    }
+
+    task_manager_delete(&manager);
+    return ST_OK;
+}
+
+/**
+ * Tests if a task manager created with an empty
+ * task list can be awaited and then used
+ * 
+ * @return ST_FAIL if an assertion fails,
+ *          otherwise ST_OK
+ */
+status_t test_create_run_empty() {
+    task_manager_t manager;
+    task_list_t tasks;
+    executed = 0;
+    assertr_status(task_list_init(&tasks, 0), ST_FAIL);
+    assertr_status(task_manager_create_run(&manager, tasks, CTOOL_TASK_THREADS), ST_FAIL);
+    task_manager_await(&manager);
+
+    assertr_status(task_list_init(&tasks, 1), ST_FAIL);
+    tasks.data[0].function = count;
+    tasks.data[0].input = task_input_default;
+    assertr_status(task_manager_submit(&manager, tasks), ST_FAIL);
+    task_manager_await(&manager);
+    assertr_equals(executed, 1, ST_FAIL);
+    task_manager_delete(&manager);
+    return ST_OK;
+}
+
+    /* main function */
+int main() {
+    if (test_deque_order() != ST_OK) {
+        return EXIT_FAILURE;
+    }
+    if (test_stealing_scheduler() != ST_OK) {
+        return EXIT_FAILURE;
+    }
+    if (test_create_run_empty() != ST_OK) {
+        return EXIT_FAILURE;
+    }
+    return EXIT_SUCCESS;
+}
\ No newline at end of file
@@ -0,0 +1,157 @@
+/**
+ * @file elastic.c
+ * @author andersonarc (e.andersonarc@gmail.com)
+ * @version 0.1
+ * @date 2021-06-09
+ *
+ *  Tests for elastic thread pool sizing
+ */
+    /* includes */
+#include <time.h> /* nanosleep() */
+#include "ctool/assert.h" /* assertions */
+#include "ctool/thread.h" /* task manager */
+
+    /* constant presets */
+#define CTOOL_TASK_MIN_THREADS 1
+#define CTOOL_TASK_MAX_THREADS 4
+#define CTOOL_TASK_BLOCKED 16
+#define CTOOL_TASK_LIST_SIZE 1000
+#define CTOOL_TASK_IDLE_TIMEOUT (50 * 1000 * 1000)
+
+    /* time presets */
+struct timespec ms1 = { 0, 1000 * 1000 };
+
+    /* shared state */
+atomic_int released = false;
+atomic_size_t executed = 0;
+
+    /* sample tasks */
+task_output_t block(task_input_t input) {
+    while (!released) {
+        nanosleep(&ms1, NULL);
+    }
+    executed++;
+    return task_output_default;
+}
+
+task_output_t count(task_input_t input) {
+    executed++;
+    return task_output_default;
+}
+
+    /* functions */
+/**
+ * Enqueues blocking tasks one by one,
+ * so that the pool grows to its maximum size,
+ * then releases them
+ *
+ * @param[in] manager The task manager
+ *
+ * @return ST_FAIL if an assertion fails,
+ *          otherwise ST_OK
+ */
+status_t run_blocked(task_manager_t* manager) {
+    released = false;
+    executed = 0;
+    for (size_t i = 0; i < CTOOL_TASK_BLOCKED; i++) {
+        assertr_status(task_manager_enqueue(manager, (task_t) { block, task_input_default }), ST_FAIL);
+        nanosleep(&ms1, NULL);
+    }
+    assertr_equals(task_manager_size(manager), CTOOL_TASK_MAX_THREADS, ST_FAIL);
+    released = true;
+    task_manager_await(manager);
+    assertr_equals(executed, CTOOL_TASK_BLOCKED, ST_FAIL);
+    return ST_OK;
+}
+
+/**
+ * Waits for the idle workers of a pool
+ * to retire down to the minimum size
+ *
+ * @param[in] manager The task manager
+ *
+ * @return ST_FAIL if an assertion fails,
+ *          otherwise ST_OK
+ */
+status_t run_idle(task_manager_t* manager) {
+    /* every worker times out in turn, from the last one */
+    for (size_t i = 0; i < 1000 && task_manager_size(manager) > CTOOL_TASK_MIN_THREADS; i++) {
+        nanosleep(&ms1, NULL);
+    }
+    assertr_equals(task_manager_size(manager), CTOOL_TASK_MIN_THREADS, ST_FAIL);
+    return ST_OK;
+}
+
+/**
+ * Tests if invalid pool bounds are rejected
+ *
+ * @return ST_FAIL if an assertion fails,
+ *          otherwise ST_OK
+ */
+status_t test_elastic_bounds() {
+    task_manager_t manager;
+    task_manager_options_t options = { .threads = 2, .min_threads = 3 };
+    assertr_equals(task_manager_create_custom(&manager, options), ST_BAD_ARG, ST_FAIL);
+    options = (task_manager_options_t) { .threads = 2, .max_threads = 1 };
+    assertr_equals(task_manager_create_custom(&manager, options), ST_BAD_ARG, ST_FAIL);
+
+    /* a fixed pool keeps its size */
+    assertr_status(task_manager_create(&manager, 2), ST_FAIL);
+    assertr_equals(task_manager_size(&manager), 2, ST_FAIL);
+    task_manager_delete(&manager);
+    return ST_OK;
+}
+
+/**
+ * Tests if a pool grows when enqueued tasks wait,
+ * shrinks when its workers are idle, and grows
+ * again by reusing the retired slots
+ *
+ * @param[in] scheduler The task scheduler
+ *
+ * @return ST_FAIL if an assertion fails,
+ *          otherwise ST_OK
+ */
+status_t test_elastic_resize(task_scheduler_t scheduler) {
+    task_manager_t manager;
+    task_manager_options_t options = {
+        .threads = CTOOL_TASK_MIN_THREADS, .scheduler = scheduler,
+        .max_threads = CTOOL_TASK_MAX_THREADS, .idle_timeout = CTOOL_TASK_IDLE_TIMEOUT
+    };
+    assertr_status(task_manager_create_custom(&manager, options), ST_FAIL);
+    assertr_equals(task_manager_size(&manager), CTOOL_TASK_MIN_THREADS, ST_FAIL);
+
+    assertr_status(run_blocked(&manager), ST_FAIL);
+    assertr_status(run_idle(&manager), ST_FAIL);
+    assertr_status(run_blocked(&manager), ST_FAIL);
+
+    /* task lists run on every worker there is */
+    task_list_t tasks;
+    executed = 0;
+    assertr_status(task_list_init(&tasks, CTOOL_TASK_LIST_SIZE), ST_FAIL);
+    for (size_t i = 0; i < CTOOL_TASK_LIST_SIZE; i++) {
+        tasks.data[i].function = count;
+        tasks.data[i].input = task_input_default;
+    }
+    assertr_status(task_manager_submit(&manager, tasks), ST_FAIL);
+    task_manager_await(&manager);
+    assertr_equals(executed, CTOOL_TASK_LIST_SIZE, ST_FAIL);
+
+    assertr_status(run_idle(&manager), ST_FAIL);
+    task_manager_delete(&manager);
+    return ST_OK;
+}
+
+    /* main function */
+int main() {
+    if (test_elastic_bounds() != ST_OK) {
+        return EXIT_FAILURE;
+    }
+    if (test_elastic_resize(CTOOL_TASK_SCHEDULER_SHARED) != ST_OK) {
+        return EXIT_FAILURE;
+    }
+    if (test_elastic_resize(CTOOL_TASK_SCHEDULER_STEALING) != ST_OK) {
+        return EXIT_FAILURE;
+    }
+    return EXIT_SUCCESS;
+}
\ No newline at end of file
@@ -0,0 +1,279 @@
+/**
+ * @file fiber.c
+ * @author andersonarc (e.andersonarc@gmail.com)
+ * @version 0.1
+ * @date 2021-06-10
+ * 
+ *  Tests for fibers waiting on descriptors and tasks
+ */
+    /* includes */
+#include <stdint.h> /* intptr_t */
+#include <sched.h> /* sched_yield() */
+#include <time.h> /* nanosleep(), clock() */
+#include <unistd.h> /* pipe() */
+#include <sys/epoll.h> /* EPOLLIN */
+#include "ctool/assert.h" /* assertions */
+#include "ctool/thread.h" /* task manager */
+#include "ctool/thread/fiber.h" /* fibers */
+#include "ctool/io/stream.h" /* streams */
+
+    /* constant presets */
+#define CTOOL_TASK_THREADS 2
+#define CTOOL_FIBER_PIPES 200
+#define CTOOL_FIBERS 1000
+#define CTOOL_FIBER_YIELDS 10
+#define CTOOL_TASKS 1000
+#define CTOOL_FIBER_READERS 8
+
+    /* time presets */
+struct timespec ms20 = { 0, 1000 * 1000 * 20 };
+struct timespec ms50 = { 0, 1000 * 1000 * 50 };
+struct timespec ms1 = { 0, 1000 * 1000 };
+
+    /* shared state */
+task_manager_t manager;
+int pipes[CTOOL_FIBER_PIPES][2];
+int shared[2];
+task_list_t slow;
+
+    /* task execution counters */
+atomic_size_t executed = 0;
+atomic_size_t received = 0;
+atomic_size_t yielded = 0;
+atomic_size_t failed = 0;
+
+    /* sample tasks */
+task_output_t count(task_input_t input) {
+    executed++;
+    return task_output_default;
+}
+
+task_output_t receive(task_input_t input) {
+    char byte;
+    int fd = pipes[(intptr_t) input][0];
+    if (task_fiber_await_fd(fd, EPOLLIN) != ST_OK || stream_read(fd, &byte, 1) != ST_OK) {
+        failed++;
+    }
+    received++;
+    return task_output_default;
+}
+
+task_output_t receive_shared(task_input_t input) {
+    char byte;
+    if (task_fiber_await_fd(shared[0], EPOLLIN) != ST_OK || stream_read(shared[0], &byte, 1) != ST_OK) {
+        failed++;
+    }
+    received++;
+    return task_output_default;
+}
+
+task_output_t spin(task_input_t input) {
+    for (size_t i = 0; i < CTOOL_FIBER_YIELDS; i++) {
+        yielded++;
+        task_fiber_yield();
+    }
+    return task_output_default;
+}
+
+task_output_t sleep_ms20(task_input_t input) {
+    nanosleep(&ms20, NULL);
+    return (task_output_t) (intptr_t) 42;
+}
+
+task_output_t sleep_ms50(task_input_t input) {
+    nanosleep(&ms50, NULL);
+    return (task_output_t) (intptr_t) 42;
+}
+
+task_output_t await_slow(task_input_t input) {
+    if ((intptr_t) task_fiber_await_future(&manager, &slow.futures[0]) != 42) {
+        failed++;
+    }
+    return task_output_default;
+}
+
+    /* functions */
+/**
+ * Tests if fibers waiting for descriptors 
+ * don't block the workers
+ * 
+ * @param[in] pool The fiber pool
+ * 
+ * @return ST_FAIL if an assertion fails,
+ *          otherwise ST_OK
+ */
+status_t test_fiber_descriptors(task_fiber_pool_t* pool) {
+    for (size_t i = 0; i < CTOOL_FIBER_PIPES; i++) {
+        assertr_zero(pipe(pipes[i]), ST_FAIL);
+        assertr_status(task_fiber_spawn(pool, (task_t) { receive, (task_input_t) (intptr_t) i }), ST_FAIL);
+    }
+
+    /* the workers are free while the fibers wait */
+    nanosleep(&ms50, NULL);
+    for (size_t i = 0; i < CTOOL_TASKS; i++) {
+        assertr_status(task_manager_enqueue(&manager, (task_t) { count, task_input_default }), ST_FAIL);
+    }
+    task_manager_await(&manager);
+    assertr_equals(executed, CTOOL_TASKS, ST_FAIL);
+    assertr_zero(received, ST_FAIL);
+
+    for (size_t i = 0; i < CTOOL_FIBER_PIPES; i++) {
+        assertr_status(stream_write(pipes[i][1], "x", 1), ST_FAIL);
+    }
+    task_fiber_pool_await(pool);
+    assertr_equals(received, CTOOL_FIBER_PIPES, ST_FAIL);
+    assertr_zero(failed, ST_FAIL);
+    for (size_t i = 0; i < CTOOL_FIBER_PIPES; i++) {
+        close(pipes[i][0]);
+        close(pipes[i][1]);
+    }
+    return ST_OK;
+}
+
+/**
+ * Tests if several fibers waiting for the
+ * same descriptor are all resumed
+ * 
+ * @param[in] pool The fiber pool
+ * 
+ * @return ST_FAIL if an assertion fails,
+ *          otherwise ST_OK
+ */
+status_t test_fiber_shared_descriptor(task_fiber_pool_t* pool) {
+    received = 0;
+    assertr_zero(pipe(shared), ST_FAIL);
+    for (size_t i = 0; i < CTOOL_FIBER_READERS; i++) {
+        assertr_status(task_fiber_spawn(pool, (task_t) { receive_shared, task_input_default }), ST_FAIL);
+    }
+    nanosleep(&ms50, NULL);
+    assertr_zero(received, ST_FAIL);
+    for (size_t i = 0; i < CTOOL_FIBER_READERS; i++) {
+        assertr_status(stream_write(shared[1], "x", 1), ST_FAIL);
+    }
+
+    /* a fiber that is never resumed would hang the pool */
+    for (size_t i = 0; i < 1000 && received < CTOOL_FIBER_READERS; i++) {
+        nanosleep(&ms1, NULL);
+    }
+    assertr_equals(received, CTOOL_FIBER_READERS, ST_FAIL);
+    task_fiber_pool_await(pool);
+    assertr_zero(failed, ST_FAIL);
+    close(shared[0]);
+    close(shared[1]);
+    return ST_OK;
+}
+
+/**
+ * Tests if many yielding fibers are multiplexed
+ * over the workers and their stacks are reused
+ * 
+ * @param[in] pool The fiber pool
+ * 
+ * @return ST_FAIL if an assertion fails,
+ *          otherwise ST_OK
+ */
+status_t test_fiber_yield(task_fiber_pool_t* pool) {
+    for (size_t round = 1; round <= 2; round++) {
+        for (size_t i = 0; i < CTOOL_FIBERS; i++) {
+            status_t status;
+            while ((status = task_fiber_spawn(pool, (task_t) { spin, task_input_default })) == ST_BUSY) {
+                /* the yielding fibers fill the queue */
+                sched_yield();
+            }
+            assertr_status(status, ST_FAIL);
+        }
+        task_fiber_pool_await(pool);
+        assertr_equals(yielded, round * CTOOL_FIBERS * CTOOL_FIBER_YIELDS, ST_FAIL);
+    }
+
+    /* the second round reused the fibers of the first one */
+    size_t pooled = 0;
+    for (task_fiber_t* fiber = pool->free; fiber != NULL; fiber = fiber->next) {
+        pooled++;
+    }
+    assertr_true(pooled <= CTOOL_FIBERS + CTOOL_FIBER_PIPES, ST_FAIL);
+    return ST_OK;
+}
+
+/**
+ * Tests if a fiber can wait for a future
+ * without blocking its worker
+ * 
+ * @param[in] pool The fiber pool
+ * 
+ * @return ST_FAIL if an assertion fails,
+ *          otherwise ST_OK
+ */
+status_t test_fiber_future(task_fiber_pool_t* pool) {
+    assertr_status(task_list_init_futures(&slow, 1), ST_FAIL);
+    slow.data[0] = (task_t) { sleep_ms20, task_input_default };
+    assertr_status(task_fiber_spawn(pool, (task_t) { await_slow, task_input_default }), ST_FAIL);
+    assertr_status(task_manager_submit(&manager, slow), ST_FAIL);
+    task_fiber_pool_await(pool);
+    task_manager_await(&manager);
+    assertr_zero(failed, ST_FAIL);
+    return ST_OK;
+}
+
+/**
+ * Tests if fibers waiting for a future are suspended
+ * instead of being resumed until it is ready
+ * 
+ * @param[in] pool The fiber pool
+ * 
+ * @return ST_FAIL if an assertion fails,
+ *          otherwise ST_OK
+ */
+status_t test_fiber_future_parked(task_fiber_pool_t* pool) {
+    assertr_status(task_list_init_futures(&slow, 1), ST_FAIL);
+    slow.data[0] = (task_t) { sleep_ms50, task_input_default };
+    /* only the first fiber is subscribed, the second one yields */
+    assertr_status(task_fiber_spawn(pool, (task_t) { await_slow, task_input_default }), ST_FAIL);
+    nanosleep(&ms20, NULL);
+    clock_t start = clock();
+    assertr_status(task_manager_submit(&manager, slow), ST_FAIL);
+    task_manager_await(&manager);
+    clock_t spent = clock() - start;
+    task_fiber_pool_await(pool);
+    assertr_zero(failed, ST_FAIL);
+    /* a resumed fiber would keep a worker busy for the whole sleep */
+    assertr_true(spent < CLOCKS_PER_SEC / 40, ST_FAIL);
+
+    assertr_status(task_list_init_futures(&slow, 1), ST_FAIL);
+    slow.data[0] = (task_t) { sleep_ms20, task_input_default };
+    for (size_t i = 0; i < CTOOL_FIBER_READERS; i++) {
+        assertr_status(task_fiber_spawn(pool, (task_t) { await_slow, task_input_default }), ST_FAIL);
+    }
+    assertr_status(task_manager_submit(&manager, slow), ST_FAIL);
+    task_fiber_pool_await(pool);
+    task_manager_await(&manager);
+    assertr_zero(failed, ST_FAIL);
+    return ST_OK;
+}
+
+    /* main function */
+int main() {
+    task_fiber_pool_t pool;
+    if (task_manager_create(&manager, CTOOL_TASK_THREADS) != ST_OK
+            || task_fiber_pool_create(&pool, &manager, 0) != ST_OK) {
+        return EXIT_FAILURE;
+    }
+    if (test_fiber_descriptors(&pool) != ST_OK) {
+        return EXIT_FAILURE;
+    }
+    if (test_fiber_shared_descriptor(&pool) != ST_OK) {
+        return EXIT_FAILURE;
+    }
+    if (test_fiber_yield(&pool) != ST_OK) {
+        return EXIT_FAILURE;
+    }
+    if (test_fiber_future(&pool) != ST_OK) {
+        return EXIT_FAILURE;
+    }
+    if (test_fiber_future_parked(&pool) != ST_OK) {
+        return EXIT_FAILURE;
+    }
+    task_fiber_pool_delete(&pool);
+    task_manager_delete(&manager);
+    return EXIT_SUCCESS;
+}
\ No newline at end of file
@@ -0,0 +1,111 @@
+/**
+ * @file future.c
+ * @author andersonarc (e.andersonarc@gmail.com)
+ * @version 0.1
+ * @date 2021-06-02
+ * 
+ *  Tests for task futures
+ */
+    /* includes */
+#include <stdint.h> /* intptr_t */
+#include <time.h> /* sleep */
+#include "ctool/assert.h" /* assertions */
+#include "ctool/thread.h" /* task manager */
+
+    /* constant presets */
+#define CTOOL_TASK_THREADS 4
+#define CTOOL_TASK_COUNT 1000
+
+    /* time presets */
+struct timespec mcs10 = { 0, 1000 * 10 };
+
+    /* sample tasks */
+task_output_t square(task_input_t input) {
+    intptr_t value = (intptr_t) input;
+    nanosleep(&mcs10, NULL);
+    return (task_output_t) (value * value);
+}
+
+    /* functions */
+/**
+ * Creates a task list of squaring tasks with futures
+ * 
+ * @param[out] tasks The task list
+ * 
+ * @return ST_FAIL if the list can't be created,
+ *          otherwise ST_OK
+ */
+status_t create_tasks(task_list_t* tasks) {
+    assertr_status(task_list_init_futures(tasks, CTOOL_TASK_COUNT), ST_FAIL);
+    for (size_t i = 0; i < CTOOL_TASK_COUNT; i++) {
+        tasks->data[i].function = square;
+        tasks->data[i].input = (task_input_t) (intptr_t) i;
+        assertr_false(task_future_is_ready(&tasks->futures[i]), ST_FAIL);
+    }
+    return ST_OK;
+}
+
+/**
+ * Tests if futures can be awaited one by one
+ * while the task list is still running
+ * 
+ * @param[in] scheduler The task scheduler to test
+ * 
+ * @return ST_FAIL if an assertion fails,
+ *          otherwise ST_OK
+ */
+status_t test_future_await(task_scheduler_t scheduler) {
+    task_manager_t manager;
+    task_list_t tasks;
+    task_manager_options_t options = { .threads = CTOOL_TASK_THREADS, .scheduler = scheduler };
+    assertr_status(task_manager_create_custom(&manager, options), ST_FAIL);
+    assertr_status(create_tasks(&tasks), ST_FAIL);
+    assertr_status(task_manager_submit(&manager, tasks), ST_FAIL);
+
+    /* the last tasks are the last to be executed */
+    for (size_t i = CTOOL_TASK_COUNT; i > 0; i--) {
+        task_output_t output = task_future_await(&manager, &tasks.futures[i - 1]);
+        assertr_equals((intptr_t) output, (intptr_t) ((i - 1) * (i - 1)), ST_FAIL);
+    }
+
+    task_manager_delete(&manager);
+    return ST_OK;
+}
+
+/**
+ * Tests if all futures are ready 
+ * after the task list is awaited
+ * 
+ * @return ST_FAIL if an assertion fails,
+ *          otherwise ST_OK
+ */
+status_t test_future_collect() {
+    task_manager_t manager;
+    task_list_t tasks;
+    assertr_status(task_manager_create(&manager, CTOOL_TASK_THREADS), ST_FAIL);
+    assertr_status(create_tasks(&tasks), ST_FAIL);
+    assertr_status(task_manager_submit(&manager, tasks), ST_FAIL);
+    task_manager_await(&manager);
+
+    for (size_t i = 0; i < CTOOL_TASK_COUNT; i++) {
+        assertr_true(task_future_is_ready(&tasks.futures[i]), ST_FAIL);
+        assertr_equals((intptr_t) tasks.futures[i].output, (intptr_t) (i * i), ST_FAIL);
+    }
+
+    task_manager_delete(&manager);
+    return ST_OK;
+}
+
+    /* main function */
+int main() {
+    if (test_future_await(CTOOL_TASK_SCHEDULER_SHARED) != ST_OK) {
+        return EXIT_FAILURE;
+    }
+    if (test_future_await(CTOOL_TASK_SCHEDULER_STEALING) != ST_OK) {
+        return EXIT_FAILURE;
+    }
+    if (test_future_collect() != ST_OK) {
+        return EXIT_FAILURE;
+    }
+    return EXIT_SUCCESS;
+}
\ No newline at end of file
@@ -0,0 +1,154 @@
+/**
+ * @file global.c
+ * @author andersonarc (e.andersonarc@gmail.com)
+ * @version 0.1
+ * @date 2021-06-15
+ *
+ *  Tests for the process-wide task manager
+ */
+    /* includes */
+#include <time.h> /* nanosleep() */
+#include <unistd.h> /* _exit() */
+#include "ctool/assert.h" /* assertions */
+#include "ctool/thread/affinity.h" /* cpu count */
+#include "ctool/thread/global.h" /* global task manager */
+
+    /* constant presets */
+#define CTOOL_TASK_THREADS 4
+#define CTOOL_TASK_LIST_SIZE 100
+#define CTOOL_TASKS_QUEUED 100
+#define CTOOL_LOOP_SIZE 100000
+#define CTOOL_LOOPS 8
+
+    /* time presets */
+struct timespec us100 = { 0, 1000 * 100 };
+
+    /* task results */
+task_manager_t* managers[CTOOL_TASK_LIST_SIZE];
+atomic_size_t executed = 0;
+atomic_size_t sums[CTOOL_LOOPS + 1];
+atomic_size_t failed = 0;
+
+    /* sample tasks */
+task_output_t lookup(task_input_t input) {
+    managers[(size_t) input] = task_manager_global();
+    return task_output_default;
+}
+
+task_output_t slow(task_input_t input) {
+    nanosleep(&us100, NULL);
+    executed++;
+    return task_output_default;
+}
+
+void add(size_t begin, size_t end, task_input_t context) {
+    atomic_fetch_add((atomic_size_t*) context, end - begin);
+}
+
+task_output_t loop(task_input_t input) {
+    if (task_manager_parallel_for(task_manager_global(), 0, CTOOL_LOOP_SIZE, 1, add, &sums[(size_t) input]) != ST_OK) {
+        failed++;
+    }
+    return task_output_default;
+}
+
+    /* functions */
+/**
+ * Checks that the tasks left at exit were finished
+ * before the global task manager was deleted
+ */
+void check_exit() {
+    if (executed != 2 * CTOOL_TASKS_QUEUED) {
+        _exit(EXIT_FAILURE);
+    }
+}
+
+/**
+ * Tests if concurrent first calls from several
+ * threads return the same task manager
+ *
+ * @return ST_FAIL if an assertion fails,
+ *          otherwise ST_OK
+ */
+status_t test_global_once() {
+    task_manager_t manager;
+    task_list_t tasks;
+    assertr_status(task_manager_create(&manager, CTOOL_TASK_THREADS), ST_FAIL);
+    assertr_status(task_list_init(&tasks, CTOOL_TASK_LIST_SIZE), ST_FAIL);
+    for (size_t i = 0; i < CTOOL_TASK_LIST_SIZE; i++) {
+        tasks.data[i].function = lookup;
+        tasks.data[i].input = (task_input_t) i;
+    }
+    assertr_status(task_manager_submit(&manager, tasks), ST_FAIL);
+    task_manager_await(&manager);
+    task_manager_delete(&manager);
+
+    task_manager_t* global = task_manager_global();
+    assertr_true(global != NULL, ST_FAIL);
+    for (size_t i = 0; i < CTOOL_TASK_LIST_SIZE; i++) {
+        assertr_true(managers[i] == global, ST_FAIL);
+    }
+    assertr_equals(task_manager_size(global), task_affinity_cpus(), ST_FAIL);
+    return ST_OK;
+}
+
+/**
+ * Tests if parallel loops of several users
+ * run on the global task manager at once
+ *
+ * @return ST_FAIL if an assertion fails,
+ *          otherwise ST_OK
+ */
+status_t test_global_shared() {
+    task_manager_t* global = task_manager_global();
+    for (size_t i = 0; i < CTOOL_LOOPS; i++) {
+        assertr_status(task_manager_enqueue(global, (task_t) { loop, (task_input_t) i }), ST_FAIL);
+    }
+    loop((task_input_t) CTOOL_LOOPS);
+    assertr_status(task_manager_await(global), ST_FAIL);
+    assertr_zero(failed, ST_FAIL);
+    for (size_t i = 0; i <= CTOOL_LOOPS; i++) {
+        assertr_equals(sums[i], CTOOL_LOOP_SIZE, ST_FAIL);
+    }
+    return ST_OK;
+}
+
+/**
+ * Tests if the global task manager executes
+ * tasks and finishes them at exit
+ *
+ * @return ST_FAIL if an assertion fails,
+ *          otherwise ST_OK
+ */
+status_t test_global_exit() {
+    task_manager_t* global = task_manager_global();
+    for (size_t i = 0; i < CTOOL_TASKS_QUEUED; i++) {
+        assertr_status(task_manager_enqueue(global, (task_t) { slow, task_input_default }), ST_FAIL);
+    }
+    task_manager_await(global);
+    assertr_equals(executed, CTOOL_TASKS_QUEUED, ST_FAIL);
+
+    /* these are finished by the exit handler */
+    for (size_t i = 0; i < CTOOL_TASKS_QUEUED; i++) {
+        assertr_status(task_manager_enqueue(global, (task_t) { slow, task_input_default }), ST_FAIL);
+    }
+    return ST_OK;
+}
+
+    /* main function */
+int main() {
+    /* exit handlers run in reverse order, so this one runs last */
+    if (atexit(check_exit) != 0) {
+        return EXIT_FAILURE;
+    }
+    if (test_global_once() != ST_OK) {
+        return EXIT_FAILURE;
+    }
+    if (test_global_shared() != ST_OK) {
+        return EXIT_FAILURE;
+    }
+    if (test_global_exit() != ST_OK) {
+        return EXIT_FAILURE;
+    }
+    return EXIT_SUCCESS;
+}
\ No newline at end of file
@@ -0,0 +1,213 @@
+/**
+ * @file help.c
+ * @author andersonarc (e.andersonarc@gmail.com)
+ * @version 0.1
+ * @date 2021-06-14
+ *
+ *  Tests for task execution by awaiting threads
+ */
+    /* includes */
+#include <stdint.h> /* intptr_t */
+#include <time.h> /* nanosleep() */
+#include "ctool/assert.h" /* assertions */
+#include "ctool/thread.h" /* task manager */
+
+    /* constant presets */
+#define CTOOL_TASK_THREADS 2
+#define CTOOL_TASK_LIST_SIZE 1000
+#define CTOOL_TASK_NESTED_SIZE 8
+
+    /* time presets */
+struct timespec us100 = { 0, 1000 * 100 };
+
+    /* task manager and counters */
+task_manager_t manager;
+atomic_size_t executed = 0;
+atomic_size_t helped = 0;
+atomic_bool child_done = false;
+atomic_size_t rejected = 0;
+
+    /* sample tasks */
+task_output_t slow(task_input_t input) {
+    nanosleep(&us100, NULL);
+    if (task_worker_current() == NULL) {
+        helped++;
+    }
+    executed++;
+    return (task_output_t) 1;
+}
+
+task_output_t nested(task_input_t input) {
+    intptr_t index = (intptr_t) input;
+    if (index < CTOOL_TASK_NESTED_SIZE / 2) {
+        /* every worker waits for a task that no worker has taken yet */
+        task_future_t* future = &manager.tasks.futures[index + CTOOL_TASK_NESTED_SIZE / 2];
+        return (task_output_t) ((intptr_t) task_future_await(&manager, future) + 1);
+    }
+    nanosleep(&us100, NULL);
+    return (task_output_t) index;
+}
+
+task_output_t child(task_input_t input) {
+    child_done = true;
+    return task_output_default;
+}
+
+task_output_t parent(task_input_t input) {
+    task_manager_enqueue(&manager, (task_t) { child, task_input_default });
+    while (!child_done) {
+        task_manager_help(&manager);
+    }
+    executed++;
+    return task_output_default;
+}
+
+task_output_t submitter(task_input_t input) {
+    task_list_t tasks;
+    if (task_list_init(&tasks, 1) == ST_OK) {
+        tasks.data[0] = (task_t) { child, task_input_default };
+        /* the list of this task is still running */
+        if (task_manager_submit(&manager, tasks) == ST_FAIL) {
+            rejected++;
+        }
+        task_list_free(&tasks);
+    }
+    return task_output_default;
+}
+
+task_output_t awaiter(task_input_t input) {
+    /* waiting for the queued tasks would include this one */
+    if (task_manager_await(&manager) == ST_FAIL && task_manager_await_helping(&manager) == ST_FAIL) {
+        rejected++;
+    }
+    return task_output_default;
+}
+
+    /* functions */
+/**
+ * Tests if the awaiting thread executes tasks
+ * of the list along with the workers
+ *
+ * @return ST_FAIL if an assertion fails,
+ *          otherwise ST_OK
+ */
+status_t test_help_await() {
+    task_list_t tasks;
+    executed = 0;
+    helped = 0;
+    assertr_status(task_list_init(&tasks, CTOOL_TASK_LIST_SIZE), ST_FAIL);
+    for (size_t i = 0; i < CTOOL_TASK_LIST_SIZE; i++) {
+        tasks.data[i].function = slow;
+        tasks.data[i].input = task_input_default;
+    }
+    assertr_status(task_manager_submit(&manager, tasks), ST_FAIL);
+    task_manager_await_helping(&manager);
+    assertr_equals(executed, CTOOL_TASK_LIST_SIZE, ST_FAIL);
+    assertr_true(helped > 0, ST_FAIL);
+
+    /* an idle task manager has nothing to help with */
+    assertr_false(task_manager_help(&manager), ST_FAIL);
+    task_manager_await_helping(&manager);
+    return ST_OK;
+}
+
+/**
+ * Tests if tasks awaiting futures of the same list
+ * complete when every worker is waiting
+ *
+ * @return ST_FAIL if an assertion fails,
+ *          otherwise ST_OK
+ */
+status_t test_help_nested() {
+    task_list_t tasks;
+    assertr_status(task_list_init_futures(&tasks, CTOOL_TASK_NESTED_SIZE), ST_FAIL);
+    for (intptr_t i = 0; i < CTOOL_TASK_NESTED_SIZE; i++) {
+        tasks.data[i].function = nested;
+        tasks.data[i].input = (task_input_t) i;
+    }
+    assertr_status(task_manager_submit(&manager, tasks), ST_FAIL);
+    task_manager_await(&manager);
+    for (intptr_t i = 0; i < CTOOL_TASK_NESTED_SIZE / 2; i++) {
+        assertr_equals((intptr_t) manager.tasks.futures[i].output, i + CTOOL_TASK_NESTED_SIZE / 2 + 1, ST_FAIL);
+    }
+    return ST_OK;
+}
+
+/**
+ * Tests if a queued task waiting for a task it has
+ * enqueued completes on a single worker
+ *
+ * @return ST_FAIL if an assertion fails,
+ *          otherwise ST_OK
+ */
+status_t test_help_queued() {
+    executed = 0;
+    child_done = false;
+    assertr_status(task_manager_enqueue(&manager, (task_t) { parent, task_input_default }), ST_FAIL);
+    task_manager_await(&manager);
+    assertr_true(child_done, ST_FAIL);
+    assertr_equals(executed, 1, ST_FAIL);
+    return ST_OK;
+}
+
+/**
+ * Tests if a task submitting a task list or
+ * awaiting its task manager fails instead of
+ * waiting for itself
+ *
+ * @return ST_FAIL if an assertion fails,
+ *          otherwise ST_OK
+ */
+status_t test_help_rejected() {
+    task_list_t tasks;
+    rejected = 0;
+    assertr_status(task_list_init(&tasks, CTOOL_TASK_NESTED_SIZE), ST_FAIL);
+    for (size_t i = 0; i < CTOOL_TASK_NESTED_SIZE; i++) {
+        tasks.data[i] = (task_t) { submitter, task_input_default };
+    }
+    assertr_status(task_manager_submit(&manager, tasks), ST_FAIL);
+    assertr_status(task_manager_await(&manager), ST_FAIL);
+    assertr_equals(rejected, CTOOL_TASK_NESTED_SIZE, ST_FAIL);
+
+    rejected = 0;
+    for (size_t i = 0; i < CTOOL_TASK_NESTED_SIZE; i++) {
+        assertr_status(task_manager_enqueue(&manager, (task_t) { awaiter, task_input_default }), ST_FAIL);
+    }
+    assertr_status(task_manager_await(&manager), ST_FAIL);
+    assertr_equals(rejected, CTOOL_TASK_NESTED_SIZE, ST_FAIL);
+    return ST_OK;
+}
+
+/**
+ * Runs the tests with a scheduler
+ *
+ * @param[in] scheduler The task scheduler
+ * @param[in] threads   Number of threads
+ *
+ * @return ST_FAIL if an assertion fails,
+ *          otherwise ST_OK
+ */
+status_t test_help(task_scheduler_t scheduler, size_t threads) {
+    task_manager_options_t options = { .threads = threads, .scheduler = scheduler };
+    assertr_status(task_manager_create_custom(&manager, options), ST_FAIL);
+    assertr_status(test_help_await(), ST_FAIL);
+    assertr_status(test_help_nested(), ST_FAIL);
+    assertr_status(test_help_queued(), ST_FAIL);
+    assertr_status(test_help_rejected(), ST_FAIL);
+    task_manager_delete(&manager);
+    return ST_OK;
+}
+
+    /* main function */
+int main() {
+    if (test_help(CTOOL_TASK_SCHEDULER_SHARED, CTOOL_TASK_THREADS) != ST_OK) {
+        return EXIT_FAILURE;
+    }
+    if (test_help(CTOOL_TASK_SCHEDULER_STEALING, CTOOL_TASK_THREADS) != ST_OK) {
+        return EXIT_FAILURE;
+    }
+    if (test_help(CTOOL_TASK_SCHEDULER_SHARED, 1) != ST_OK) {
+        return EXIT_FAILURE;
+    }
+    return EXIT_SUCCESS;
+}
\ No newline at end of file
@@ -0,0 +1,150 @@
+/**
+ * @file parallel.c
+ * @author andersonarc (e.andersonarc@gmail.com)
+ * @version 0.1
+ * @date 2021-06-09
+ * 
+ *  Tests for parallel reduction and prefix scan
+ */
+    /* includes */
+#include <stdint.h> /* uint64_t */
+#include <time.h> /* nanosleep() */
+#include "ctool/assert.h" /* assertions */
+#include "ctool/thread.h" /* task manager */
+#include "ctool/thread/parallel.h" /* parallel operations */
+#include "ctool/type/list.h" /* lists */
+
+    /* constant presets */
+#define CTOOL_TASK_THREADS 4
+#define CTOOL_ELEMENTS 4000003
+#define CTOOL_NESTED_ELEMENTS (PARALLEL_MIN_BLOCK * 8)
+#define CTOOL_TASK_LIST_SIZE 200
+
+    /* time presets */
+struct timespec us100 = { 0, 1000 * 100 };
+
+    /* operators */
+#define add(a, b) ((a) + (b))
+#define max(a, b) ((a) > (b) ? (a) : (b))
+
+    /* parallel operations */
+list_declare(uint64_t)
+parallel_declare(sum, uint64_t)
+parallel_define(sum, uint64_t, add, 0)
+parallel_declare(maximum, uint64_t)
+parallel_define(maximum, uint64_t, max, 0)
+
+    /* nested operation state */
+uint64_t nested_data[CTOOL_NESTED_ELEMENTS];
+atomic_size_t nested_failed = 0;
+
+    /* sample tasks */
+task_output_t slow(task_input_t input) {
+    nanosleep(&us100, NULL);
+    return task_output_default;
+}
+
+task_output_t nested_sum(task_input_t input) {
+    uint64_t result;
+    if (parallel_reduce(sum)(input, nested_data, CTOOL_NESTED_ELEMENTS, &result) != ST_OK
+            || result != CTOOL_NESTED_ELEMENTS) {
+        nested_failed++;
+    }
+    return task_output_default;
+}
+
+    /* functions */
+/**
+ * Tests reduction and both scans of 
+ * arrays of several sizes against a sequential loop
+ * 
+ * @return ST_FAIL if an assertion fails,
+ *          otherwise ST_OK
+ */
+status_t test_parallel_sum() {
+    task_manager_t manager;
+    static uint64_t data[CTOOL_ELEMENTS], output[CTOOL_ELEMENTS];
+    size_t sizes[] = { 0, 1, 10, PARALLEL_MIN_BLOCK * 2 + 1, CTOOL_ELEMENTS };
+    assertr_status(task_manager_create(&manager, CTOOL_TASK_THREADS), ST_FAIL);
+
+    for (size_t s = 0; s < sizeof(sizes) / sizeof(sizes[0]); s++) {
+        list(uint64_t) list = { .size = sizes[s], .data = data };
+        for (size_t i = 0; i < list.size; i++) {
+            data[i] = i * 7 % 13;
+        }
+
+        uint64_t result = 1;
+        assertr_status(parallel_reduce_list(sum, &manager, &list, &result), ST_FAIL);
+        uint64_t expected = 0, largest = 0;
+        for (size_t i = 0; i < list.size; i++) {
+            expected += data[i];
+            largest = max(largest, data[i]);
+        }
+        assertr_equals(result, expected, ST_FAIL);
+        assertr_status(parallel_reduce_list(maximum, &manager, &list, &result), ST_FAIL);
+        assertr_equals(result, largest, ST_FAIL);
+
+        assertr_status(parallel_scan_inclusive_list(sum, &manager, &list, output), ST_FAIL);
+        expected = 0;
+        for (size_t i = 0; i < list.size; i++) {
+            expected += data[i];
+            assertr_equals(output[i], expected, ST_FAIL);
+        }
+
+        /* exclusive scan in place */
+        assertr_status(parallel_scan_exclusive_list(sum, &manager, &list, data), ST_FAIL);
+        expected = 0;
+        for (size_t i = 0; i < list.size; i++) {
+            assertr_equals(data[i], expected, ST_FAIL);
+            expected += i * 7 % 13;
+        }
+    }
+
+    task_manager_delete(&manager);
+    return ST_OK;
+}
+
+/**
+ * Tests if parallel operations run while a task list
+ * is running and from inside of queued tasks
+ * 
+ * @return ST_FAIL if an assertion fails,
+ *          otherwise ST_OK
+ */
+status_t test_parallel_nested() {
+    task_manager_t manager;
+    task_list_t tasks;
+    assertr_status(task_manager_create(&manager, CTOOL_TASK_THREADS), ST_FAIL);
+    for (size_t i = 0; i < CTOOL_NESTED_ELEMENTS; i++) {
+        nested_data[i] = 1;
+    }
+
+    assertr_status(task_list_init(&tasks, CTOOL_TASK_LIST_SIZE), ST_FAIL);
+    for (size_t i = 0; i < CTOOL_TASK_LIST_SIZE; i++) {
+        tasks.data[i].function = slow;
+        tasks.data[i].input = task_input_default;
+    }
+    assertr_status(task_manager_submit(&manager, tasks), ST_FAIL);
+    uint64_t result = 0;
+    assertr_status(parallel_reduce(sum)(&manager, nested_data, CTOOL_NESTED_ELEMENTS, &result), ST_FAIL);
+    assertr_equals(result, CTOOL_NESTED_ELEMENTS, ST_FAIL);
+
+    for (size_t i = 0; i < CTOOL_TASK_THREADS * 2; i++) {
+        assertr_status(task_manager_enqueue(&manager, (task_t) { nested_sum, &manager }), ST_FAIL);
+    }
+    task_manager_await(&manager);
+    assertr_equals(nested_failed, 0, ST_FAIL);
+    task_manager_delete(&manager);
+    return ST_OK;
+}
+
+    /* main function */
+int main() {
+    if (test_parallel_sum() != ST_OK) {
+        return EXIT_FAILURE;
+    }
+    if (test_parallel_nested() != ST_OK) {
+        return EXIT_FAILURE;
+    }
+    return EXIT_SUCCESS;
+}
\ No newline at end of file
@@ -0,0 +1,164 @@
+/**
+ * @file pipeline.c
+ * @author andersonarc (e.andersonarc@gmail.com)
+ * @version 0.1
+ * @date 2021-06-13
+ *
+ *  Tests for the multi-stage pipeline
+ */
+    /* includes */
+#include <stdint.h> /* intptr_t */
+#include <sched.h> /* sched_yield() */
+#include <time.h> /* nanosleep() */
+#include "ctool/assert.h" /* assertions */
+#include "ctool/thread/pipeline.h" /* pipeline */
+
+    /* constant presets */
+#define CTOOL_TASK_THREADS 4
+#define CTOOL_PIPELINE_ITEMS 10000
+#define CTOOL_PIPELINE_SMALL_ITEMS 200
+#define CTOOL_PIPELINE_DROPPED 7
+
+    /* time presets */
+struct timespec us10 = { 0, 1000 * 10 };
+struct timespec us200 = { 0, 1000 * 200 };
+
+    /* pipeline items and results */
+intptr_t items[CTOOL_PIPELINE_ITEMS];
+intptr_t written[CTOOL_PIPELINE_ITEMS];
+size_t count = 0;
+atomic_size_t serial = 0;
+atomic_size_t overlap = 0;
+
+    /* sample stages */
+task_output_t decode(task_input_t input) {
+    intptr_t* item = input;
+    if (*item % 3 == 0) {
+        /* finish some items late, so that they are reordered */
+        nanosleep(&us10, NULL);
+    }
+    *item *= 2;
+    return input;
+}
+
+task_output_t filter(task_input_t input) {
+    intptr_t* item = input;
+    return *item % CTOOL_PIPELINE_DROPPED == 0 ? task_output_default : input;
+}
+
+task_output_t write_item(task_input_t input) {
+    /* a serial stage is never entered twice at once */
+    if (serial++ != 0) {
+        overlap++;
+    }
+    written[count++] = *(intptr_t*) input;
+    serial--;
+    return task_output_default;
+}
+
+task_output_t slow_write(task_input_t input) {
+    nanosleep(&us200, NULL);
+    return write_item(input);
+}
+
+    /* functions */
+/**
+ * Pushes items into a pipeline, retrying while it is full
+ *
+ * @param[in] pipeline The pipeline
+ * @param[in] size     Number of items
+ *
+ * @return Number of times the pipeline was full
+ */
+size_t push_items(task_pipeline_t* pipeline, size_t size) {
+    size_t busy = 0;
+    for (size_t i = 0; i < size; i++) {
+        items[i] = (intptr_t) i + 1;
+        while (task_pipeline_push(pipeline, &items[i]) == ST_BUSY) {
+            busy++;
+            sched_yield();
+        }
+    }
+    return busy;
+}
+
+/**
+ * Tests if a serial stage after parallel ones receives
+ * the items in order, without the dropped ones
+ *
+ * @param[in] manager The task manager
+ *
+ * @return ST_FAIL if an assertion fails,
+ *          otherwise ST_OK
+ */
+status_t test_pipeline_order(task_manager_t* manager) {
+    task_pipeline_t pipeline;
+    count = 0;
+    overlap = 0;
+    assertr_equals(task_pipeline_init(&pipeline, manager, 3, 100), ST_BAD_ARG, ST_FAIL);
+    assertr_status(task_pipeline_init(&pipeline, manager, 3, 0), ST_FAIL);
+    assertr_equals(task_pipeline_push(&pipeline, &items[0]), ST_FAIL, ST_FAIL);
+    assertr_status(task_pipeline_add(&pipeline, decode, 0), ST_FAIL);
+    assertr_status(task_pipeline_add(&pipeline, filter, 2), ST_FAIL);
+    assertr_status(task_pipeline_add(&pipeline, write_item, 1), ST_FAIL);
+    assertr_equals(task_pipeline_add(&pipeline, write_item, 1), ST_FAIL, ST_FAIL);
+
+    push_items(&pipeline, CTOOL_PIPELINE_ITEMS);
+    task_pipeline_await(&pipeline);
+    assertr_equals(overlap, 0, ST_FAIL);
+
+    size_t expected = 0;
+    for (intptr_t i = 1; i <= CTOOL_PIPELINE_ITEMS; i++) {
+        if ((i * 2) % CTOOL_PIPELINE_DROPPED != 0) {
+            assertr_equals(written[expected], i * 2, ST_FAIL);
+            expected++;
+        }
+    }
+    assertr_equals(count, expected, ST_FAIL);
+    task_pipeline_free(&pipeline);
+    return ST_OK;
+}
+
+/**
+ * Tests if a slow last stage holds back
+ * the pipeline through small rings
+ *
+ * @param[in] manager The task manager
+ *
+ * @return ST_FAIL if an assertion fails,
+ *          otherwise ST_OK
+ */
+status_t test_pipeline_backpressure(task_manager_t* manager) {
+    task_pipeline_t pipeline;
+    count = 0;
+    overlap = 0;
+    assertr_status(task_pipeline_init(&pipeline, manager, 2, 4), ST_FAIL);
+    assertr_status(task_pipeline_add(&pipeline, decode, 0), ST_FAIL);
+    assertr_status(task_pipeline_add(&pipeline, slow_write, 1), ST_FAIL);
+
+    assertr_true(push_items(&pipeline, CTOOL_PIPELINE_SMALL_ITEMS) > 0, ST_FAIL);
+    task_pipeline_await(&pipeline);
+    assertr_equals(overlap, 0, ST_FAIL);
+    assertr_equals(count, CTOOL_PIPELINE_SMALL_ITEMS, ST_FAIL);
+    for (intptr_t i = 0; i < CTOOL_PIPELINE_SMALL_ITEMS; i++) {
+        assertr_equals(written[i], (i + 1) * 2, ST_FAIL);
+    }
+    task_pipeline_free(&pipeline);
+    return ST_OK;
+}
+
+    /* main function */
+int main() {
+    task_manager_t manager;
+    if (task_manager_create(&manager, CTOOL_TASK_THREADS) != ST_OK) {
+        return EXIT_FAILURE;
+    }
+    if (test_pipeline_order(&manager) != ST_OK) {
+        return EXIT_FAILURE;
+    }
+    if (test_pipeline_backpressure(&manager) != ST_OK) {
+        return EXIT_FAILURE;
+    }
+    task_manager_delete(&manager);
+    return EXIT_SUCCESS;
+}
\ No newline at end of file
@@ -0,0 +1,123 @@
+/**
+ * @file priority.c
+ * @author andersonarc (e.andersonarc@gmail.com)
+ * @version 0.1
+ * @date 2021-06-04
+ * 
+ *  Tests for task priority levels and aging
+ */
+    /* includes */
+#include <stdint.h> /* intptr_t */
+#include <time.h> /* nanosleep() */
+#include "ctool/assert.h" /* assertions */
+#include "ctool/thread.h" /* task manager */
+
+    /* constant presets */
+#define CTOOL_TASKS_PER_LEVEL 4
+
+    /* time presets */
+struct timespec ms10 = { 0, 1000 * 1000 * 10 };
+
+    /* execution order */
+atomic_int released = false;
+atomic_size_t position = 0;
+intptr_t order[CTOOL_TASK_PRIORITIES * CTOOL_TASKS_PER_LEVEL];
+
+    /* sample tasks */
+task_output_t block(task_input_t input) {
+    while (!released);
+    return task_output_default;
+}
+
+task_output_t record(task_input_t input) {
+    order[position++] = (intptr_t) input;
+    return task_output_default;
+}
+
+    /* functions */
+/**
+ * Enqueues the tasks of every priority level
+ * to a single worker blocked by another task,
+ * then releases it
+ * 
+ * @param[in] manager The task manager
+ * @param[in] high    Number of high priority tasks
+ * @param[in] low     Number of low priority tasks
+ * 
+ * @return ST_FAIL if an assertion fails,
+ *          otherwise ST_OK
+ */
+status_t run_blocked(task_manager_t* manager, size_t high, size_t low) {
+    released = false;
+    position = 0;
+    assertr_status(task_manager_enqueue(manager, (task_t) { block, task_input_default }), ST_FAIL);
+    nanosleep(&ms10, NULL);
+
+    /* enqueue from the lowest level, so that FIFO order would be wrong */
+    for (size_t i = 0; i < low; i++) {
+        task_t task = { record, (task_input_t) (intptr_t) CTOOL_TASK_PRIORITY_LOW };
+        assertr_status(task_manager_enqueue_priority(manager, task, CTOOL_TASK_PRIORITY_LOW), ST_FAIL);
+    }
+    for (size_t i = 0; i < high; i++) {
+        task_t task = { record, (task_input_t) (intptr_t) CTOOL_TASK_PRIORITY_HIGH };
+        assertr_status(task_manager_enqueue_priority(manager, task, CTOOL_TASK_PRIORITY_HIGH), ST_FAIL);
+    }
+    released = true;
+    task_manager_await(manager);
+    assertr_equals(position, high + low, ST_FAIL);
+    return ST_OK;
+}
+
+/**
+ * Tests if queued tasks are executed
+ * from the highest priority level
+ * 
+ * @return ST_FAIL if an assertion fails,
+ *          otherwise ST_OK
+ */
+status_t test_priority_order() {
+    task_manager_t manager;
+    assertr_status(task_manager_create(&manager, 1), ST_FAIL);
+    task_t task = { record, task_input_default };
+    assertr_equals(task_manager_enqueue_priority(&manager, task, CTOOL_TASK_PRIORITIES), ST_BAD_ARG, ST_FAIL);
+
+    assertr_status(run_blocked(&manager, CTOOL_TASKS_PER_LEVEL, CTOOL_TASKS_PER_LEVEL), ST_FAIL);
+    for (size_t i = 0; i < CTOOL_TASKS_PER_LEVEL * 2; i++) {
+        intptr_t expected = i < CTOOL_TASKS_PER_LEVEL ? CTOOL_TASK_PRIORITY_HIGH : CTOOL_TASK_PRIORITY_LOW;
+        assertr_equals(order[i], expected, ST_FAIL);
+    }
+
+    task_manager_delete(&manager);
+    return ST_OK;
+}
+
+/**
+ * Tests if aging lets a low priority task
+ * overtake a stream of high priority tasks
+ * 
+ * @return ST_FAIL if an assertion fails,
+ *          otherwise ST_OK
+ */
+status_t test_priority_aging() {
+    task_manager_t manager;
+    task_manager_options_t options = { .threads = 1, .aging = 2 };
+    assertr_status(task_manager_create_custom(&manager, options), ST_FAIL);
+
+    /* one of the first two picks is an aging one */
+    assertr_status(run_blocked(&manager, CTOOL_TASKS_PER_LEVEL, 1), ST_FAIL);
+    assertr_true(order[0] == CTOOL_TASK_PRIORITY_LOW || order[1] == CTOOL_TASK_PRIORITY_LOW, ST_FAIL);
+
+    task_manager_delete(&manager);
+    return ST_OK;
+}
+
+    /* main function */
+int main() {
+    if (test_priority_order() != ST_OK) {
+        return EXIT_FAILURE;
+    }
+    if (test_priority_aging() != ST_OK) {
+        return EXIT_FAILURE;
+    }
+    return EXIT_SUCCESS;
+}
\ No newline at end of file
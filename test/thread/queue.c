@@ -0,0 +1,135 @@
+/**
+ * @file queue.c
+ * @author andersonarc (e.andersonarc@gmail.com)
+ * @version 0.1
+ * @date 2021-06-02
+ * 
+ *  Tests for the task queue 
+ *  and continuous task submission
+ */
+    /* includes */
+#include <stdint.h> /* intptr_t */
+#include <sched.h> /* sched_yield() */
+#include "ctool/assert.h" /* assertions */
+#include "ctool/thread.h" /* task manager */
+
+    /* constant presets */
+#define CTOOL_TASK_THREADS 4
+#define CTOOL_TASK_PRODUCERS 4
+#define CTOOL_TASKS_PER_PRODUCER 100000
+
+    /* shared task managers */
+task_manager_t producers;
+task_manager_t consumers;
+
+    /* task execution counters */
+atomic_size_t executed = 0;
+atomic_size_t checksum = 0;
+atomic_size_t rejected = 0;
+
+    /* sample tasks */
+task_output_t count(task_input_t input) {
+    checksum += (size_t) input;
+    executed++;
+    return task_output_default;
+}
+
+task_output_t spawn(task_input_t input) {
+    /* enqueue a child task from inside a task */
+    task_t child = { .function = count, .input = input };
+    while (task_manager_enqueue(&consumers, child) == ST_BUSY) {
+        /* every worker may be here, drain the queue instead of waiting */
+        if (!task_manager_help(&consumers)) {
+            sched_yield();
+        }
+    }
+    return task_output_default;
+}
+
+task_output_t produce(task_input_t input) {
+    for (size_t i = 0; i < CTOOL_TASKS_PER_PRODUCER; i++) {
+        task_t task = { .function = (i % 2) ? count : spawn, .input = (task_input_t) (intptr_t) 1 };
+        while (task_manager_enqueue(&consumers, task) == ST_BUSY) {
+            /* back-pressure, the queue is full */
+            rejected++;
+            sched_yield();
+        }
+    }
+    return task_output_default;
+}
+
+    /* functions */
+/**
+ * Tests if a queue keeps FIFO order
+ * and reports being full or empty
+ * 
+ * @return ST_FAIL if an assertion fails,
+ *          otherwise ST_OK
+ */
+status_t test_queue_order() {
+    task_queue_t queue;
+    task_t task;
+    assertr_equals(task_queue_init(&queue, 3), ST_BAD_ARG, ST_FAIL);
+    assertr_status(task_queue_init(&queue, 8), ST_FAIL);
+    assertr_true(task_queue_is_empty(&queue), ST_FAIL);
+    assertr_false(task_queue_pop(&queue, &task), ST_FAIL);
+
+    /* two laps around the ring */
+    for (size_t lap = 0; lap < 2; lap++) {
+        for (size_t i = 0; i < 8; i++) {
+            task.input = (task_input_t) (intptr_t) i;
+            assertr_true(task_queue_push(&queue, task), ST_FAIL);
+        }
+        assertr_false(task_queue_push(&queue, task), ST_FAIL);
+        for (size_t i = 0; i < 8; i++) {
+            assertr_true(task_queue_pop(&queue, &task), ST_FAIL);
+            assertr_equals((intptr_t) task.input, (intptr_t) i, ST_FAIL);
+        }
+        assertr_true(task_queue_is_empty(&queue), ST_FAIL);
+    }
+
+    task_queue_free(&queue);
+    return ST_OK;
+}
+
+/**
+ * Tests if tasks enqueued concurrently by several
+ * producers and by other tasks are all executed once
+ * 
+ * @return ST_FAIL if an assertion fails,
+ *          otherwise ST_OK
+ */
+status_t test_queue_continuous() {
+    task_manager_options_t options = { .threads = CTOOL_TASK_THREADS, .queue_size = 256 };
+    task_list_t tasks;
+    assertr_status(task_manager_create_custom(&consumers, options), ST_FAIL);
+    assertr_status(task_list_init(&tasks, CTOOL_TASK_PRODUCERS), ST_FAIL);
+    for (size_t i = 0; i < CTOOL_TASK_PRODUCERS; i++) {
+        tasks.data[i].function = produce;
+        tasks.data[i].input = task_input_default;
+    }
+
+    /* producers run on their own task manager */
+    assertr_status(task_manager_create_run(&producers, tasks, CTOOL_TASK_PRODUCERS), ST_FAIL);
+    task_manager_await(&producers);
+    task_manager_await(&consumers);
+
+    size_t total = CTOOL_TASK_PRODUCERS * CTOOL_TASKS_PER_PRODUCER;
+    assertr_equals(executed, total, ST_FAIL);
+    assertr_equals(checksum, total, ST_FAIL);
+
+    task_manager_delete(&producers);
+    task_manager_delete(&consumers);
+    return ST_OK;
+}
+
+    /* main function */
+int main() {
+    if (test_queue_order() != ST_OK) {
+        return EXIT_FAILURE;
+    }
+    if (test_queue_continuous() != ST_OK) {
+        return EXIT_FAILURE;
+    }
+    return EXIT_SUCCESS;
+}
\ No newline at end of file
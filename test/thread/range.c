@@ -0,0 +1,172 @@
+/**
+ * @file range.c
+ * @author andersonarc (e.andersonarc@gmail.com)
+ * @version 0.1
+ * @date 2021-06-02
+ * 
+ *  Tests for parallel loops over index ranges
+ */
+    /* includes */
+#include <stdint.h> /* SIZE_MAX */
+#include <string.h> /* memset() */
+#include <time.h> /* nanosleep() */
+#include "ctool/assert.h" /* assertions */
+#include "ctool/thread.h" /* task manager */
+
+    /* constant presets */
+#define CTOOL_TASK_THREADS 8
+#define CTOOL_RANGE_SIZE 3000000
+#define CTOOL_NESTED_SIZE 100000
+#define CTOOL_TASK_LIST_SIZE 200
+
+    /* time presets */
+struct timespec us100 = { 0, 1000 * 100 };
+
+    /* visit counters */
+unsigned char visited[CTOOL_RANGE_SIZE];
+atomic_size_t chunks = 0;
+atomic_size_t counted = 0;
+atomic_size_t failed = 0;
+
+    /* sample range functions */
+void visit(size_t begin, size_t end, task_input_t context) {
+    for (size_t i = begin; i < end; i++) {
+        visited[i]++;
+    }
+    chunks++;
+}
+
+void count(size_t begin, size_t end, task_input_t context) {
+    counted += end - begin;
+}
+
+    /* sample tasks */
+task_output_t slow(task_input_t input) {
+    nanosleep(&us100, NULL);
+    return task_output_default;
+}
+
+task_output_t nested(task_input_t input) {
+    if (task_manager_parallel_for(input, 0, CTOOL_NESTED_SIZE, 1, count, NULL) != ST_OK) {
+        failed++;
+    }
+    return task_output_default;
+}
+
+    /* functions */
+/**
+ * Checks that every index of a range 
+ * was visited exactly once and nothing else was
+ * 
+ * @param[in] begin Range start, inclusive
+ * @param[in] end   Range end, exclusive
+ * 
+ * @return ST_FAIL if an assertion fails,
+ *          otherwise ST_OK
+ */
+status_t check_visited(size_t begin, size_t end) {
+    for (size_t i = 0; i < CTOOL_RANGE_SIZE; i++) {
+        assertrc_equals(visited[i], i >= begin && i < end, ST_FAIL, 
+            "index %zu visited %d times", i, visited[i]);
+    }
+    return ST_OK;
+}
+
+/**
+ * Tests if parallel loops visit every index 
+ * exactly once for different ranges and grains
+ * 
+ * @return ST_FAIL if an assertion fails,
+ *          otherwise ST_OK
+ */
+status_t test_parallel_for() {
+    task_manager_t manager;
+    assertr_status(task_manager_create(&manager, CTOOL_TASK_THREADS), ST_FAIL);
+
+    size_t ranges[][3] = {
+        { 0, CTOOL_RANGE_SIZE, 1 },
+        { 17, CTOOL_RANGE_SIZE - 5, 1000 },
+        { 100, 105, 64 },
+        { 0, 1000, 1 },
+        { 50, 50, 1 }
+    };
+    for (size_t n = 0; n < sizeof(ranges) / sizeof(ranges[0]); n++) {
+        memset(visited, 0, sizeof(visited));
+        assertr_status(task_manager_parallel_for(&manager, ranges[n][0], ranges[n][1], ranges[n][2], 
+            visit, NULL), ST_FAIL);
+        assertr_status(check_visited(ranges[n][0], ranges[n][1]), ST_FAIL);
+    }
+
+    /* adaptive chunking keeps the number of chunks far below the number of indices */
+    assertr_true(chunks < CTOOL_RANGE_SIZE / 16, ST_FAIL);
+
+    task_manager_delete(&manager);
+    return ST_OK;
+}
+
+/**
+ * Tests if a range ending at SIZE_MAX
+ * is visited without wrapping around
+ * 
+ * @return ST_FAIL if an assertion fails,
+ *          otherwise ST_OK
+ */
+status_t test_parallel_for_limit() {
+    task_manager_t manager;
+    assertr_status(task_manager_create(&manager, CTOOL_TASK_THREADS), ST_FAIL);
+    counted = 0;
+    assertr_status(task_manager_parallel_for(&manager, SIZE_MAX - CTOOL_NESTED_SIZE, SIZE_MAX, 1, 
+        count, NULL), ST_FAIL);
+    assertr_equals(counted, CTOOL_NESTED_SIZE, ST_FAIL);
+    task_manager_delete(&manager);
+    return ST_OK;
+}
+
+/**
+ * Tests if parallel loops run while a task list
+ * is running and from inside of queued tasks, 
+ * even when every worker runs such a task
+ * 
+ * @return ST_FAIL if an assertion fails,
+ *          otherwise ST_OK
+ */
+status_t test_parallel_for_nested() {
+    task_manager_t manager;
+    task_list_t tasks;
+    assertr_status(task_manager_create(&manager, CTOOL_TASK_THREADS), ST_FAIL);
+
+    assertr_status(task_list_init(&tasks, CTOOL_TASK_LIST_SIZE), ST_FAIL);
+    for (size_t i = 0; i < CTOOL_TASK_LIST_SIZE; i++) {
+        tasks.data[i].function = slow;
+        tasks.data[i].input = task_input_default;
+    }
+    assertr_status(task_manager_submit(&manager, tasks), ST_FAIL);
+    counted = 0;
+    assertr_status(task_manager_parallel_for(&manager, 0, CTOOL_NESTED_SIZE, 1, count, NULL), ST_FAIL);
+    assertr_equals(counted, CTOOL_NESTED_SIZE, ST_FAIL);
+
+    counted = 0;
+    failed = 0;
+    for (size_t i = 0; i < CTOOL_TASK_THREADS * 2; i++) {
+        assertr_status(task_manager_enqueue(&manager, (task_t) { nested, &manager }), ST_FAIL);
+    }
+    task_manager_await(&manager);
+    assertr_equals(failed, 0, ST_FAIL);
+    assertr_equals(counted, CTOOL_NESTED_SIZE * CTOOL_TASK_THREADS * 2, ST_FAIL);
+    task_manager_delete(&manager);
+    return ST_OK;
+}
+
+    /* main function */
+int main() {
+    if (test_parallel_for() != ST_OK) {
+        return EXIT_FAILURE;
+    }
+    if (test_parallel_for_limit() != ST_OK) {
+        return EXIT_FAILURE;
+    }
+    if (test_parallel_for_nested() != ST_OK) {
+        return EXIT_FAILURE;
+    }
+    return EXIT_SUCCESS;
+}
\ No newline at end of file
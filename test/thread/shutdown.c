@@ -0,0 +1,138 @@
+/**
+ * @file shutdown.c
+ * @author andersonarc (e.andersonarc@gmail.com)
+ * @version 0.1
+ * @date 2021-06-12
+ *
+ *  Tests for graceful shutdown and pausing
+ *  of a task manager
+ */
+    /* includes */
+#include <time.h> /* nanosleep() */
+#include "ctool/assert.h" /* assertions */
+#include "ctool/thread.h" /* task manager */
+
+    /* constant presets */
+#define CTOOL_TASK_THREADS 4
+#define CTOOL_TASK_LIST_SIZE 1000
+#define CTOOL_TASKS_QUEUED 100
+
+    /* time presets */
+struct timespec us100 = { 0, 1000 * 100 };
+struct timespec ms10 = { 0, 1000 * 1000 * 10 };
+
+    /* task execution counter */
+atomic_size_t executed = 0;
+
+    /* sample tasks */
+task_output_t slow(task_input_t input) {
+    nanosleep(&us100, NULL);
+    executed++;
+    return task_output_default;
+}
+
+    /* functions */
+/**
+ * Submits a list of slow tasks
+ *
+ * @param[in] manager The task manager
+ *
+ * @return Status of the submission
+ */
+status_t submit_list(task_manager_t* manager) {
+    task_list_t tasks;
+    assertr_status(task_list_init(&tasks, CTOOL_TASK_LIST_SIZE), ST_FAIL);
+    for (size_t i = 0; i < CTOOL_TASK_LIST_SIZE; i++) {
+        tasks.data[i].function = slow;
+        tasks.data[i].input = task_input_default;
+    }
+    status_t status = task_manager_submit(manager, tasks);
+    if (status != ST_OK) {
+        task_list_free(&tasks);
+    }
+    return status;
+}
+
+/**
+ * Tests if shutting down finishes the submitted
+ * and enqueued tasks and rejects new ones
+ *
+ * @return ST_FAIL if an assertion fails,
+ *          otherwise ST_OK
+ */
+status_t test_shutdown() {
+    task_manager_t manager;
+    executed = 0;
+    assertr_status(task_manager_create(&manager, CTOOL_TASK_THREADS), ST_FAIL);
+    assertr_status(submit_list(&manager), ST_FAIL);
+    for (size_t i = 0; i < CTOOL_TASKS_QUEUED; i++) {
+        assertr_status(task_manager_enqueue(&manager, (task_t) { slow, task_input_default }), ST_FAIL);
+    }
+
+    task_manager_shutdown(&manager);
+    assertr_equals(executed, CTOOL_TASK_LIST_SIZE + CTOOL_TASKS_QUEUED, ST_FAIL);
+    assertr_equals(task_manager_enqueue(&manager, (task_t) { slow, task_input_default }), ST_FAIL, ST_FAIL);
+    assertr_equals(submit_list(&manager), ST_FAIL, ST_FAIL);
+
+    /* awaiting a stopped task manager returns */
+    task_manager_await(&manager);
+    task_manager_delete(&manager);
+    return ST_OK;
+}
+
+/**
+ * Tests if a paused task manager executes no tasks
+ * and continues the task list once resumed
+ *
+ * @param[in] scheduler The task scheduler
+ *
+ * @return ST_FAIL if an assertion fails,
+ *          otherwise ST_OK
+ */
+status_t test_pause(task_scheduler_t scheduler) {
+    task_manager_t manager;
+    task_manager_options_t options = { .threads = CTOOL_TASK_THREADS, .scheduler = scheduler };
+    executed = 0;
+    assertr_status(task_manager_create_custom(&manager, options), ST_FAIL);
+
+    /* pausing an idle task manager returns immediately */
+    task_manager_pause(&manager);
+    task_manager_resume(&manager);
+
+    assertr_status(submit_list(&manager), ST_FAIL);
+    nanosleep(&ms10, NULL);
+    task_manager_pause(&manager);
+    size_t paused = executed;
+    assertr_true(paused < CTOOL_TASK_LIST_SIZE, ST_FAIL);
+
+    /* nothing runs while paused, even enqueued tasks */
+    assertr_status(task_manager_enqueue(&manager, (task_t) { slow, task_input_default }), ST_FAIL);
+    nanosleep(&ms10, NULL);
+    assertr_equals(executed, paused, ST_FAIL);
+
+    task_manager_resume(&manager);
+    task_manager_await(&manager);
+    assertr_equals(executed, CTOOL_TASK_LIST_SIZE + 1, ST_FAIL);
+
+    /* the same threads run the next list */
+    executed = 0;
+    assertr_status(submit_list(&manager), ST_FAIL);
+    task_manager_await(&manager);
+    assertr_equals(executed, CTOOL_TASK_LIST_SIZE, ST_FAIL);
+    task_manager_delete(&manager);
+    return ST_OK;
+}
+
+    /* main function */
+int main() {
+    if (test_shutdown() != ST_OK) {
+        return EXIT_FAILURE;
+    }
+    if (test_pause(CTOOL_TASK_SCHEDULER_SHARED) != ST_OK) {
+        return EXIT_FAILURE;
+    }
+    if (test_pause(CTOOL_TASK_SCHEDULER_STEALING) != ST_OK) {
+        return EXIT_FAILURE;
+    }
+    return EXIT_SUCCESS;
+}
\ No newline at end of file
@@ -0,0 +1,93 @@
+/**
+ * @file stats.c
+ * @author andersonarc (e.andersonarc@gmail.com)
+ * @version 0.1
+ * @date 2021-06-06
+ * 
+ *  Tests for worker statistics
+ */
+    /* includes */
+#include <time.h> /* nanosleep() */
+#include "ctool/assert.h" /* assertions */
+#include "ctool/thread.h" /* task manager */
+
+    /* constant presets */
+#define CTOOL_TASK_THREADS 4
+#define CTOOL_TASKS 1000
+
+    /* time presets */
+struct timespec ms1 = { 0, 1000 * 1000 };
+struct timespec ms10 = { 0, 1000 * 1000 * 10 };
+
+    /* sample tasks */
+task_output_t sleep_ms1(task_input_t input) {
+    nanosleep(&ms1, NULL);
+    return task_output_default;
+}
+
+task_output_t empty(task_input_t input) {
+    return task_output_default;
+}
+
+    /* functions */
+/**
+ * Tests if the statistics of a task manager
+ * account for every executed task
+ * 
+ * @param[in] scheduler The scheduler
+ * 
+ * @return ST_FAIL if an assertion fails,
+ *          otherwise ST_OK
+ */
+status_t test_stats(task_scheduler_t scheduler) {
+    task_manager_t manager;
+    task_worker_stats_t stats[CTOOL_TASK_THREADS];
+    task_manager_options_t options = { .threads = CTOOL_TASK_THREADS, .scheduler = scheduler };
+    assertr_status(task_manager_create_custom(&manager, options), ST_FAIL);
+
+#ifdef CTOOL_THREAD_STATS
+    task_list_t tasks;
+
+    /* let the workers park */
+    nanosleep(&ms10, NULL);
+    assertr_status(task_list_init(&tasks, CTOOL_TASKS), ST_FAIL);
+    for (size_t i = 0; i < CTOOL_TASKS; i++) {
+        tasks.data[i].function = i == 0 ? sleep_ms1 : empty;
+        tasks.data[i].input = task_input_default;
+    }
+    assertr_status(task_manager_submit(&manager, tasks), ST_FAIL);
+    task_manager_await(&manager);
+    assertr_status(task_manager_enqueue(&manager, (task_t) { sleep_ms1, task_input_default }), ST_FAIL);
+    task_manager_await(&manager);
+    assertr_status(task_manager_stats(&manager, stats), ST_FAIL);
+
+    uint64_t executed = 0, wakeups = 0, idle = 0, longest = 0;
+    for (size_t i = 0; i < CTOOL_TASK_THREADS; i++) {
+        assertr_true(stats[i].busy >= stats[i].longest, ST_FAIL);
+        executed += stats[i].executed;
+        wakeups += stats[i].wakeups;
+        idle += stats[i].idle;
+        longest = stats[i].longest > longest ? stats[i].longest : longest;
+    }
+    assertr_equals(executed, CTOOL_TASKS + 1, ST_FAIL);
+    assertr_true(wakeups > 0, ST_FAIL);
+    assertr_true(idle > 0, ST_FAIL);
+    assertr_true(longest >= 1000 * 1000, ST_FAIL);
+#else
+    assertr_equals(task_manager_stats(&manager, stats), ST_FAIL, ST_FAIL);
+#endif
+
+    task_manager_delete(&manager);
+    return ST_OK;
+}
+
+    /* main function */
+int main() {
+    if (test_stats(CTOOL_TASK_SCHEDULER_SHARED) != ST_OK) {
+        return EXIT_FAILURE;
+    }
+    if (test_stats(CTOOL_TASK_SCHEDULER_STEALING) != ST_OK) {
+        return EXIT_FAILURE;
+    }
+    return EXIT_SUCCESS;
+}
\ No newline at end of file
@@ -0,0 +1,138 @@
+/**
+ * @file timer.c
+ * @author andersonarc (e.andersonarc@gmail.com)
+ * @version 0.1
+ * @date 2021-06-08
+ * 
+ *  Tests for delayed and periodic tasks
+ */
+    /* includes */
+#include <stdint.h> /* intptr_t */
+#include <time.h> /* nanosleep() */
+#include "ctool/assert.h" /* assertions */
+#include "ctool/thread.h" /* task manager */
+#include "ctool/thread/timer.h" /* timer wheel */
+
+    /* constant presets */
+#define CTOOL_TASK_THREADS 4
+#define CTOOL_TIMERS 10000
+#define CTOOL_TIMER_MAX_DELAY_MS 300
+#define MS 1000000
+
+    /* time presets */
+struct timespec ms50 = { 0, 50 * MS };
+struct timespec ms500 = { 0, 500 * MS };
+
+    /* shared state */
+uint64_t origin;
+uint64_t deadlines[CTOOL_TIMERS];
+atomic_size_t early = 0;
+atomic_size_t fired = 0;
+
+    /* sample tasks */
+task_output_t check_delay(task_input_t input) {
+    if (_ctool_thread_time() - origin < deadlines[(intptr_t) input]) {
+        early++;
+    }
+    fired++;
+    return task_output_default;
+}
+
+task_output_t count(task_input_t input) {
+    fired++;
+    return task_output_default;
+}
+
+    /* functions */
+/**
+ * Tests if many one-shot timers with random 
+ * delays across several levels of the wheel fire
+ * exactly once and never early
+ * 
+ * @return ST_FAIL if an assertion fails,
+ *          otherwise ST_OK
+ */
+status_t test_timer_delays() {
+    task_manager_t manager;
+    task_timer_wheel_t wheel;
+    static task_timer_t timers[CTOOL_TIMERS];
+    assertr_status(task_manager_create(&manager, CTOOL_TASK_THREADS), ST_FAIL);
+    /* 100 us ticks, so the delays span three levels */
+    assertr_status(task_timer_wheel_create(&wheel, &manager, 100000), ST_FAIL);
+
+    fired = 0;
+    origin = _ctool_thread_time();
+    srand(1);
+    for (size_t i = 0; i < CTOOL_TIMERS; i++) {
+        uint64_t delay = (uint64_t) (rand() % (CTOOL_TIMER_MAX_DELAY_MS * 1000)) * 1000;
+        deadlines[i] = _ctool_thread_time() - origin + delay;
+        task_timer_start(&wheel, &timers[i], (task_t) { check_delay, (task_input_t) (intptr_t) i }, delay, 0);
+    }
+    nanosleep(&ms500, NULL);
+    task_manager_await(&manager);
+    assertr_equals(fired, CTOOL_TIMERS, ST_FAIL);
+    assertr_zero(early, ST_FAIL);
+    for (size_t i = 0; i < CTOOL_TIMERS; i++) {
+        assertr_false(task_timer_cancel(&wheel, &timers[i]), ST_FAIL);
+    }
+
+    task_timer_wheel_delete(&wheel);
+    task_manager_delete(&manager);
+    return ST_OK;
+}
+
+/**
+ * Tests periodic timers, cancellation and restarting
+ * 
+ * @return ST_FAIL if an assertion fails,
+ *          otherwise ST_OK
+ */
+status_t test_timer_periodic() {
+    task_manager_t manager;
+    task_timer_wheel_t wheel;
+    task_timer_t periodic = { 0 }, cancelled = { 0 };
+    assertr_status(task_manager_create(&manager, CTOOL_TASK_THREADS), ST_FAIL);
+    assertr_status(task_timer_wheel_create(&wheel, &manager, 0), ST_FAIL);
+
+    /* a cancelled timer never fires */
+    fired = 0;
+    task_timer_start(&wheel, &cancelled, (task_t) { count, task_input_default }, 20 * MS, 0);
+    assertr_true(task_timer_cancel(&wheel, &cancelled), ST_FAIL);
+    assertr_false(task_timer_cancel(&wheel, &cancelled), ST_FAIL);
+
+    /* about 10 periods of 5 ms */
+    task_timer_start(&wheel, &periodic, (task_t) { count, task_input_default }, 5 * MS, 5 * MS);
+    nanosleep(&ms50, NULL);
+    assertr_true(task_timer_cancel(&wheel, &periodic), ST_FAIL);
+    task_manager_await(&manager);
+    size_t periods = fired;
+    assertr_true(periods >= 5 && periods <= 11, ST_FAIL);
+
+    /* nothing fires after cancellation */
+    nanosleep(&ms50, NULL);
+    task_manager_await(&manager);
+    assertr_equals(fired, periods, ST_FAIL);
+
+    /* restarting an active timer replaces it */
+    task_timer_start(&wheel, &periodic, (task_t) { count, task_input_default }, 200 * MS, 0);
+    task_timer_start(&wheel, &periodic, (task_t) { count, task_input_default }, 10 * MS, 0);
+    nanosleep(&ms50, NULL);
+    task_manager_await(&manager);
+    assertr_equals(fired, periods + 1, ST_FAIL);
+    assertr_false(task_timer_cancel(&wheel, &periodic), ST_FAIL);
+
+    task_timer_wheel_delete(&wheel);
+    task_manager_delete(&manager);
+    return ST_OK;
+}
+
+    /* main function */
+int main() {
+    if (test_timer_delays() != ST_OK) {
+        return EXIT_FAILURE;
+    }
+    if (test_timer_periodic() != ST_OK) {
+        return EXIT_FAILURE;
+    }
+    return EXIT_SUCCESS;
+}
\ No newline at end of file
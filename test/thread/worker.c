@@ -0,0 +1,115 @@
+/**
+ * @file worker.c
+ * @author andersonarc (e.andersonarc@gmail.com)
+ * @version 0.1
+ * @date 2021-06-14
+ *
+ *  Tests for worker indices, scratch buffers
+ *  and user data of the workers
+ */
+    /* includes */
+#include <stdint.h> /* uintptr_t */
+#include "ctool/assert.h" /* assertions */
+#include "ctool/thread.h" /* task manager */
+
+    /* constant presets */
+#define CTOOL_TASK_THREADS 4
+#define CTOOL_TASK_LIST_SIZE 10000
+#define CTOOL_TASK_SCRATCH_SIZE 24
+
+    /* worker slot data */
+size_t slots[CTOOL_TASK_THREADS];
+atomic_size_t mismatched = 0;
+
+    /* sample tasks */
+task_output_t count(task_input_t input) {
+    size_t index = task_worker_index();
+    size_t* counter = task_worker_scratch();
+    if (index == TASK_WORKER_NONE || counter == NULL || task_worker_data() != &slots[index]
+            || (uintptr_t) counter % CTOOL_CACHE_LINE != 0) {
+        mismatched++;
+        return task_output_default;
+    }
+    counter[0]++;
+    counter[1] += (size_t) input;
+    return task_output_default;
+}
+
+    /* functions */
+/**
+ * Tests if tasks can count in the scratch buffers
+ * of their workers without atomics
+ *
+ * @param[in] scheduler The task scheduler
+ *
+ * @return ST_FAIL if an assertion fails,
+ *          otherwise ST_OK
+ */
+status_t test_worker_scratch(task_scheduler_t scheduler) {
+    task_manager_t manager;
+    task_list_t tasks;
+    task_manager_options_t options = { .threads = CTOOL_TASK_THREADS, .scheduler = scheduler,
+        .scratch_size = CTOOL_TASK_SCRATCH_SIZE };
+    mismatched = 0;
+    assertr_status(task_manager_create_custom(&manager, options), ST_FAIL);
+    for (size_t i = 0; i < CTOOL_TASK_THREADS; i++) {
+        assertr_status(task_manager_set_data(&manager, i, &slots[i]), ST_FAIL);
+    }
+    assertr_equals(task_manager_set_data(&manager, CTOOL_TASK_THREADS, NULL), ST_BAD_ARG, ST_FAIL);
+    assertr_true(task_manager_scratch(&manager, CTOOL_TASK_THREADS) == NULL, ST_FAIL);
+
+    assertr_status(task_list_init(&tasks, CTOOL_TASK_LIST_SIZE), ST_FAIL);
+    for (size_t i = 0; i < CTOOL_TASK_LIST_SIZE; i++) {
+        tasks.data[i].function = count;
+        tasks.data[i].input = (task_input_t) i;
+    }
+    assertr_status(task_manager_submit(&manager, tasks), ST_FAIL);
+    task_manager_await(&manager);
+    assertr_equals(mismatched, 0, ST_FAIL);
+
+    /* combine the counters of all workers */
+    size_t executed = 0;
+    size_t sum = 0;
+    for (size_t i = 0; i < CTOOL_TASK_THREADS; i++) {
+        size_t* counter = task_manager_scratch(&manager, i);
+        assertr_true(counter != NULL, ST_FAIL);
+        executed += counter[0];
+        sum += counter[1];
+    }
+    assertr_equals(executed, CTOOL_TASK_LIST_SIZE, ST_FAIL);
+    assertr_equals(sum, (size_t) CTOOL_TASK_LIST_SIZE * (CTOOL_TASK_LIST_SIZE - 1) / 2, ST_FAIL);
+    task_manager_delete(&manager);
+    return ST_OK;
+}
+
+/**
+ * Tests the accessors outside of a worker
+ * and without scratch buffers
+ *
+ * @return ST_FAIL if an assertion fails,
+ *          otherwise ST_OK
+ */
+status_t test_worker_none() {
+    task_manager_t manager;
+    assertr_equals(task_worker_index(), TASK_WORKER_NONE, ST_FAIL);
+    assertr_true(task_worker_scratch() == NULL, ST_FAIL);
+    assertr_true(task_worker_data() == NULL, ST_FAIL);
+    assertr_status(task_manager_create(&manager, CTOOL_TASK_THREADS), ST_FAIL);
+    assertr_true(task_manager_scratch(&manager, 0) == NULL, ST_FAIL);
+    task_manager_delete(&manager);
+    return ST_OK;
+}
+
+    /* main function */
+int main() {
+    if (test_worker_scratch(CTOOL_TASK_SCHEDULER_SHARED) != ST_OK) {
+        return EXIT_FAILURE;
+    }
+    if (test_worker_scratch(CTOOL_TASK_SCHEDULER_STEALING) != ST_OK) {
+        return EXIT_FAILURE;
+    }
+    if (test_worker_none() != ST_OK) {
+        return EXIT_FAILURE;
+    }
+    return EXIT_SUCCESS;
+}
\ No newline at end of file
@@ -19,15 +19,30 @@ typedef struct sample_type {
     char* b;
 } sample_type;
 
+typedef uint32_t counter_t;
+typedef char byte_t;
+
     /* generic declarations */
 arraylist_declare(char);
 arraylist_declare(sample_type);
 arraylist_declare(uint64_t);
+arraylist_declare(counter_t);
+arraylist_declare(byte_t);
+arraylist_declare(uint16_t);
+arraylist_declare_inline(uint16_t, 4);
+arraylist_declare_inline(uint16_t, 8);
+arraylist_declare_inline(counter_t, 3);
 
     /* generic definitions */
 arraylist_define(char);
 arraylist_define(sample_type);
 arraylist_define_custom(uint64_t, ARRAYLIST_RESIZE_EXACT);
+arraylist_define_policy(counter_t, ARRAYLIST_RESIZE_ONE_AND_HALF, ARRAYLIST_SHRINK_NEVER);
+arraylist_define_policy(byte_t, ARRAYLIST_RESIZE_SIZE_CLASS, ARRAYLIST_SHRINK_QUARTER);
+arraylist_define(uint16_t);
+arraylist_define_inline(uint16_t, 4);
+arraylist_define_inline(uint16_t, 8);
+arraylist_define_inline_policy(counter_t, 3, ARRAYLIST_RESIZE_EXACT, ARRAYLIST_SHRINK_QUARTER);
 
 
     /* utility definitions */
@@ -41,6 +56,10 @@ arraylist_define_custom(uint64_t, ARRAYLIST_RESIZE_EXACT);
     arraylist_free(sample_type)(&b);    \
     arraylist_free(uint64_t)(&c);
 
+#define small_inline arraylist_inline_name(uint16_t, 4)
+#define large_inline arraylist_inline_name(uint16_t, 8)
+#define quarter_inline arraylist_inline_name(counter_t, 3)
+
 #define check_arraylist_state(name, expected_size, expected_allocated_size) \
     cr_assert(eq(sz, name.size, expected_size));                            \
     cr_assert(eq(sz, name._allocated_size, expected_allocated_size));
@@ -494,6 +513,526 @@ Test(arraylist, to_list) {
     free_arraylists();
 }
 
+Test(arraylist, reserve) {
+    create_arraylists();
+
+    /* create an address buffer to check for reallocations */
+    void* tmp;
+
+    /* test reserving memory for an empty char arraylist */
+    ncr_assert_status(arraylist_init_empty(char)(&a));
+    ncr_assert_status(arraylist_reserve(char)(&a, 5));
+        check_arraylist_state(a, 0, 5);
+        tmp = a.data;
+
+    /* test that adding within the reserved memory doesn't reallocate */
+    ncr_assert_status(arraylist_add(char)(&a, 'a'));
+    ncr_assert_status(arraylist_add(char)(&a, 'b'));
+    ncr_assert_status(arraylist_add(char)(&a, 'c'));
+    ncr_assert_status(arraylist_add(char)(&a, 'd'));
+    ncr_assert_status(arraylist_add(char)(&a, 'e'));
+        check_arraylist_state(a, 5, 5);
+        cr_assert(eq(ptr, a.data, tmp));
+
+    /* test that reserving less than allocated does nothing */
+    ncr_assert_status(arraylist_reserve(char)(&a, 3));
+        check_arraylist_state(a, 5, 5);
+        cr_assert(eq(ptr, a.data, tmp));
+
+    /* test reserving more memory for a preallocated structure arraylist */
+    sample_type s1 = { .a = 77, .b = "aseasd" };
+    ncr_assert_status(arraylist_init_with(sample_type)(&b, s1));
+    ncr_assert_status(arraylist_reserve(sample_type)(&b, 100));
+        check_arraylist_state(b, 1, 100);
+        cr_assert(eq(u16, b.data[0].a, 77));
+        cr_assert(eq(str, b.data[0].b, "aseasd"));
+
+    /* test reserving zero elements */
+    ncr_assert_status(arraylist_init_empty(uint64_t)(&c));
+    ncr_assert_status(arraylist_reserve(uint64_t)(&c, 0));
+        check_arraylist_state(c, 0, 0);
+        cr_assert(eq(ptr, c.data, NULL));
+
+    free_arraylists();
+}
+
+Test(arraylist, append_array) {
+    create_arraylists();
+
+    /* test appending to an empty char arraylist */
+    ncr_assert_status(arraylist_init_empty(char)(&a));
+    ncr_assert_status(arraylist_append_array(char)(&a, "abcde", 5));
+        check_arraylist_state(a, 5, 5);
+        cr_assert(eq(int, memcmp(a.data, "abcde", 5), 0));
+
+    /* test that appending grows the arraylist by its resizing method */
+    ncr_assert_status(arraylist_append_array(char)(&a, "f", 1));
+        check_arraylist_state(a, 6, 10);
+        cr_assert(eq(int, memcmp(a.data, "abcdef", 6), 0));
+
+    /* test appending more than the resizing method provides */
+    ncr_assert_status(arraylist_append_array(char)(&a, "ghijklmnopqrstu", 15));
+        check_arraylist_state(a, 21, 21);
+        cr_assert(eq(int, memcmp(a.data, "abcdefghijklmnopqrstu", 21), 0));
+
+    /* test appending nothing */
+    ncr_assert_status(arraylist_append_array(char)(&a, NULL, 0));
+        check_arraylist_state(a, 21, 21);
+
+    /* test appending structures */
+    sample_type s[] = { { .a = 77, .b = "aseasd" }, { .a = 12, .b = "afe" } };
+    ncr_assert_status(arraylist_init(sample_type)(&b, 4));
+    ncr_assert_status(arraylist_append_array(sample_type)(&b, s, 2));
+        check_arraylist_state(b, 2, 4);
+        cr_assert(eq(u16, b.data[1].a, 12));
+        cr_assert(eq(str, b.data[1].b, "afe"));
+
+    /* test appending to an exact resizing integer arraylist */
+    uint64_t values[] = { 646351, 74745, 1244 };
+    ncr_assert_status(arraylist_init_empty(uint64_t)(&c));
+    ncr_assert_status(arraylist_append_array(uint64_t)(&c, values, 3));
+        check_arraylist_state(c, 3, 3);
+    ncr_assert_status(arraylist_append_array(uint64_t)(&c, values, 2));
+        check_arraylist_state(c, 5, 5);
+        cr_assert(eq(u64, c.data[2], 1244));
+        cr_assert(eq(u64, c.data[3], 646351));
+        cr_assert(eq(u64, c.data[4], 74745));
+
+    free_arraylists();
+}
+
+Test(arraylist, append_arraylist) {
+    create_arraylists();
+
+    /* test appending one char arraylist to another */
+    arraylist(char) other;
+    ncr_assert_status(arraylist_init_empty(char)(&a));
+    ncr_assert_status(arraylist_append_array(char)(&a, "abc", 3));
+    ncr_assert_status(arraylist_init_empty(char)(&other));
+    ncr_assert_status(arraylist_append_array(char)(&other, "de", 2));
+
+    ncr_assert_status(arraylist_append_arraylist(char)(&a, &other));
+        check_arraylist_state(a, 5, 6);
+        check_arraylist_state(other, 2, 2);
+        cr_assert(eq(int, memcmp(a.data, "abcde", 5), 0));
+
+    /* test appending an arraylist to itself */
+    ncr_assert_status(arraylist_append_arraylist(char)(&a, &a));
+        check_arraylist_state(a, 10, 12);
+        cr_assert(eq(int, memcmp(a.data, "abcdeabcde", 10), 0));
+
+    /* test appending an empty arraylist */
+    arraylist_free(char)(&a);
+    ncr_assert_status(arraylist_append_arraylist(char)(&other, &a));
+        check_arraylist_state(other, 2, 2);
+        cr_assert(eq(int, memcmp(other.data, "de", 2), 0));
+
+    /* test appending an exact resizing integer arraylist to itself */
+    uint64_t values[] = { 646351, 74745 };
+    ncr_assert_status(arraylist_init_empty(uint64_t)(&c));
+    ncr_assert_status(arraylist_append_array(uint64_t)(&c, values, 2));
+    ncr_assert_status(arraylist_append_arraylist(uint64_t)(&c, &c));
+        check_arraylist_state(c, 4, 4);
+        cr_assert(eq(u64, c.data[2], 646351));
+        cr_assert(eq(u64, c.data[3], 74745));
+
+    arraylist_free(char)(&other);
+    ncr_assert_status(arraylist_init_empty(sample_type)(&b));
+    free_arraylists();
+}
+
+Test(arraylist, insert_range) {
+    create_arraylists();
+
+    /* test inserting into the middle of a char arraylist */
+    ncr_assert_status(arraylist_init_empty(char)(&a));
+    ncr_assert_status(arraylist_append_array(char)(&a, "abf", 3));
+    ncr_assert_status(arraylist_insert_range(char)(&a, 2, "cde", 3));
+        check_arraylist_state(a, 6, 6);
+        cr_assert(eq(int, memcmp(a.data, "abcdef", 6), 0));
+
+    /* test inserting at the beginning and at the end */
+    ncr_assert_status(arraylist_insert_range(char)(&a, 0, "__", 2));
+    ncr_assert_status(arraylist_insert_range(char)(&a, 8, "!", 1));
+        check_arraylist_state(a, 9, 12);
+        cr_assert(eq(int, memcmp(a.data, "__abcdef!", 9), 0));
+
+    /* test inserting out of bounds */
+    ncr_assert_bad_status(arraylist_insert_range(char)(&a, 10, "x", 1));
+        check_arraylist_state(a, 9, 12);
+
+    /* test inserting structures into an empty arraylist */
+    sample_type s[] = { { .a = 77, .b = "aseasd" }, { .a = 12, .b = "afe" } };
+    ncr_assert_status(arraylist_init_empty(sample_type)(&b));
+    ncr_assert_status(arraylist_insert_range(sample_type)(&b, 0, s, 2));
+        check_arraylist_state(b, 2, 2);
+        cr_assert(eq(u16, b.data[0].a, 77));
+        cr_assert(eq(str, b.data[1].b, "afe"));
+
+    /* test inserting into an exact resizing integer arraylist */
+    uint64_t values[] = { 1, 2, 3, 4 };
+    ncr_assert_status(arraylist_init(uint64_t)(&c, 0));
+    ncr_assert_status(arraylist_insert_range(uint64_t)(&c, 0, values, 2));
+    ncr_assert_status(arraylist_insert_range(uint64_t)(&c, 1, values + 2, 2));
+        check_arraylist_state(c, 4, 4);
+        cr_assert(eq(u64, c.data[0], 1));
+        cr_assert(eq(u64, c.data[1], 3));
+        cr_assert(eq(u64, c.data[2], 4));
+        cr_assert(eq(u64, c.data[3], 2));
+
+    free_arraylists();
+}
+
+Test(arraylist, resize_one_and_half) {
+    arraylist(counter_t) d;
+
+    /* test the allocated sizes of a growing arraylist */
+    size_t expected[] = { 2, 2, 3, 5, 5, 8, 8, 8, 12, 12 };
+    ncr_assert_status(arraylist_init_empty(counter_t)(&d));
+    for (counter_t i = 0; i < 10; i++) {
+        ncr_assert_status(arraylist_add(counter_t)(&d, i));
+            check_arraylist_state(d, i + 1, expected[i]);
+    }
+
+    /* test that the arraylist never shrinks */
+    void* tmp = d.data;
+    while (!arraylist_is_empty(d)) {
+        ncr_assert_status(arraylist_pop(counter_t)(&d));
+    }
+        check_arraylist_state(d, 0, 12);
+        cr_assert(eq(ptr, d.data, tmp));
+
+    /* test that trimming still releases the memory */
+    ncr_assert_status(arraylist_trim(counter_t)(&d));
+        check_arraylist_state(d, 0, 0);
+
+    arraylist_free(counter_t)(&d);
+}
+
+Test(arraylist, resize_size_class) {
+    arraylist(byte_t) e;
+
+    /* test that the first allocation fills the smallest size class */
+    ncr_assert_status(arraylist_init_empty(byte_t)(&e));
+    ncr_assert_status(arraylist_add(byte_t)(&e, 'a'));
+        check_arraylist_state(e, 1, ARRAYLIST_MIN_CLASS_SIZE);
+
+    /* test growing to the next power of two */
+    ncr_assert_status(arraylist_append_array(byte_t)(&e, "bcdefghijklmnopqr", 17));
+        check_arraylist_state(e, 18, 32);
+
+    /* test growing to whole pages */
+    byte_t block[5000] = { 0 };
+    ncr_assert_status(arraylist_append_array(byte_t)(&e, block, 5000));
+        check_arraylist_state(e, 5018, 2 * ARRAYLIST_PAGE_SIZE);
+        cr_assert(eq(int, memcmp(e.data, "abcdefghijklmnopqr", 18), 0));
+
+    arraylist_free(byte_t)(&e);
+}
+
+Test(arraylist, shrink_quarter) {
+    arraylist(byte_t) e;
+    byte_t block[4096] = { 0 };
+    ncr_assert_status(arraylist_init_empty(byte_t)(&e));
+    ncr_assert_status(arraylist_append_array(byte_t)(&e, block, 4096));
+        check_arraylist_state(e, 4096, 4096);
+
+    /* test that the arraylist keeps its memory down to a quarter */
+    while (e.size > 1025) {
+        ncr_assert_status(arraylist_pop(byte_t)(&e));
+    }
+        check_arraylist_state(e, 1025, 4096);
+
+    ncr_assert_status(arraylist_pop(byte_t)(&e));
+        check_arraylist_state(e, 1024, 2048);
+
+    /* test that adding and removing at the boundary doesn't reallocate */
+    void* tmp = e.data;
+    for (size_t i = 0; i < 100; i++) {
+        ncr_assert_status(arraylist_add(byte_t)(&e, 'x'));
+        ncr_assert_status(arraylist_pop(byte_t)(&e));
+        ncr_assert_status(arraylist_pop(byte_t)(&e));
+        ncr_assert_status(arraylist_add(byte_t)(&e, 'y'));
+    }
+        check_arraylist_state(e, 1024, 2048);
+        cr_assert(eq(ptr, e.data, tmp));
+
+    /* test that an emptied arraylist gives back most of its memory */
+    while (!arraylist_is_empty(e)) {
+        ncr_assert_status(arraylist_pop(byte_t)(&e));
+    }
+        cr_assert(e._allocated_size < 2048);
+    arraylist_free(byte_t)(&e);
+
+    /* test that a bulk removal shrinks down to a quarter at once */
+    ncr_assert_status(arraylist_init_empty(byte_t)(&e));
+    ncr_assert_status(arraylist_append_array(byte_t)(&e, block, 4096));
+        check_arraylist_state(e, 4096, 4096);
+    ncr_assert_status(arraylist_remove_range(byte_t)(&e, 10, 4086));
+        check_arraylist_state(e, 10, 32);
+
+    arraylist_free(byte_t)(&e);
+}
+
+Test(arraylist, swap_remove) {
+    create_arraylists();
+
+    /* test removing from the middle of a char arraylist */
+    ncr_assert_status(arraylist_init(char)(&a, 8));
+    ncr_assert_status(arraylist_append_array(char)(&a, "abcde", 5));
+    ncr_assert_status(arraylist_swap_remove(char)(&a, 1));
+        check_arraylist_state(a, 4, 4);
+        cr_assert(eq(int, memcmp(a.data, "aecd", 4), 0));
+
+    /* test removing the last element */
+    ncr_assert_status(arraylist_swap_remove(char)(&a, 3));
+        check_arraylist_state(a, 3, 4);
+        cr_assert(eq(int, memcmp(a.data, "aec", 3), 0));
+
+    ncr_assert_bad_status(arraylist_swap_remove(char)(&a, 3));
+
+    /* test removing the only structure of an arraylist */
+    sample_type s1 = { .a = 77, .b = "aseasd" };
+    ncr_assert_status(arraylist_init_with(sample_type)(&b, s1));
+    ncr_assert_status(arraylist_swap_remove(sample_type)(&b, 0));
+        check_arraylist_state(b, 0, 0);
+    ncr_assert_bad_status(arraylist_swap_remove(sample_type)(&b, 0));
+
+    /* test removing from an exact resizing integer arraylist */
+    uint64_t values[] = { 646351, 74745, 1244, 45745 };
+    ncr_assert_status(arraylist_init_empty(uint64_t)(&c));
+    ncr_assert_status(arraylist_append_array(uint64_t)(&c, values, 4));
+    ncr_assert_status(arraylist_swap_remove(uint64_t)(&c, 0));
+        check_arraylist_state(c, 3, 4);
+        cr_assert(eq(u64, c.data[0], 45745));
+        cr_assert(eq(u64, c.data[1], 74745));
+        cr_assert(eq(u64, c.data[2], 1244));
+
+    free_arraylists();
+}
+
+Test(arraylist, remove_range) {
+    create_arraylists();
+
+    /* test removing a range from the middle of a char arraylist */
+    ncr_assert_status(arraylist_init(char)(&a, 10));
+    ncr_assert_status(arraylist_append_array(char)(&a, "abcdefgh", 8));
+    ncr_assert_status(arraylist_remove_range(char)(&a, 2, 3));
+        check_arraylist_state(a, 5, 5);
+        cr_assert(eq(int, memcmp(a.data, "abfgh", 5), 0));
+
+    /* test removing from the front */
+    ncr_assert_status(arraylist_remove_range(char)(&a, 0, 2));
+        check_arraylist_state(a, 3, 5);
+        cr_assert(eq(int, memcmp(a.data, "fgh", 3), 0));
+
+    /* test removing an empty range and ranges out of bounds */
+    ncr_assert_status(arraylist_remove_range(char)(&a, 3, 0));
+        check_arraylist_state(a, 3, 5);
+    ncr_assert_bad_status(arraylist_remove_range(char)(&a, 4, 0));
+    ncr_assert_bad_status(arraylist_remove_range(char)(&a, 1, 3));
+    ncr_assert_bad_status(arraylist_remove_range(char)(&a, 1, SIZE_MAX));
+
+    /* test removing every element */
+    ncr_assert_status(arraylist_remove_range(char)(&a, 0, 3));
+        check_arraylist_state(a, 0, 0);
+
+    /* test removing the tail of an exact resizing integer arraylist */
+    uint64_t values[] = { 646351, 74745, 1244, 45745 };
+    ncr_assert_status(arraylist_init_empty(uint64_t)(&c));
+    ncr_assert_status(arraylist_append_array(uint64_t)(&c, values, 4));
+    ncr_assert_status(arraylist_remove_range(uint64_t)(&c, 1, 3));
+        check_arraylist_state(c, 1, 1);
+        cr_assert(eq(u64, c.data[0], 646351));
+
+    ncr_assert_status(arraylist_init_empty(sample_type)(&b));
+    free_arraylists();
+}
+
+/**
+ * Keeps the elements that are not vowels
+ */
+bool is_consonant(const char* element, void* context) {
+    return strchr(context, *element) == NULL;
+}
+
+/**
+ * Keeps the elements with an even value
+ */
+bool is_even(const counter_t* element, void* context) {
+    return *element % 2 == 0;
+}
+
+Test(arraylist, retain_if) {
+    create_arraylists();
+
+    /* test filtering a char arraylist */
+    ncr_assert_status(arraylist_init_empty(char)(&a));
+    ncr_assert_status(arraylist_append_array(char)(&a, "abcdefghij", 10));
+    ncr_assert_status(arraylist_retain_if(char)(&a, is_consonant, "aeiou"));
+        check_arraylist_state(a, 7, 10);
+        cr_assert(eq(int, memcmp(a.data, "bcdfghj", 7), 0));
+
+    /* test filtering out every element */
+    ncr_assert_status(arraylist_retain_if(char)(&a, is_consonant, "bcdfghj"));
+        check_arraylist_state(a, 0, 0);
+
+    /* test filtering an arraylist that never shrinks */
+    arraylist(counter_t) d;
+    ncr_assert_status(arraylist_init_empty(counter_t)(&d));
+    for (counter_t i = 0; i < 100; i++) {
+        ncr_assert_status(arraylist_add(counter_t)(&d, i));
+    }
+    size_t allocated = d._allocated_size;
+    ncr_assert_status(arraylist_retain_if(counter_t)(&d, is_even, NULL));
+        check_arraylist_state(d, 50, allocated);
+    for (counter_t i = 0; i < 50; i++) {
+        cr_assert(eq(u32, d.data[i], i * 2));
+    }
+
+    /* test that keeping every element changes nothing */
+    ncr_assert_status(arraylist_retain_if(counter_t)(&d, is_even, NULL));
+        check_arraylist_state(d, 50, allocated);
+
+    arraylist_free(counter_t)(&d);
+    ncr_assert_status(arraylist_init_empty(sample_type)(&b));
+    ncr_assert_status(arraylist_init_empty(uint64_t)(&c));
+    free_arraylists();
+}
+
+Test(arraylist, inline) {
+    arraylist_inline(uint16_t, 4) a;
+
+    /* test that an empty inline arraylist uses its buffer */
+    ncr_assert_status(arraylist_init_empty(small_inline)(&a));
+        check_arraylist_state(a, 0, 4);
+        cr_assert(eq(ptr, a.data, a._inline));
+
+    /* test adding elements without allocating memory */
+    for (uint16_t i = 0; i < 4; i++) {
+        ncr_assert_status(arraylist_add(small_inline)(&a, i));
+    }
+        check_arraylist_state(a, 4, 4);
+        cr_assert(eq(ptr, a.data, a._inline));
+
+    /* test spilling the elements to the heap */
+    ncr_assert_status(arraylist_add(small_inline)(&a, 4));
+        check_arraylist_state(a, 5, 8);
+        cr_assert(ne(ptr, a.data, a._inline));
+    for (uint16_t i = 0; i < 5; i++) {
+        cr_assert(eq(u16, a.data[i], i));
+    }
+
+    /* test moving the elements back into the buffer */
+    ncr_assert_status(arraylist_pop(small_inline)(&a));
+        check_arraylist_state(a, 4, 4);
+        cr_assert(eq(ptr, a.data, a._inline));
+    for (uint16_t i = 0; i < 4; i++) {
+        cr_assert(eq(u16, a.data[i], i));
+    }
+
+    /* test that the buffer is never released */
+    ncr_assert_status(arraylist_remove(small_inline)(&a, 0));
+    ncr_assert_status(arraylist_trim(small_inline)(&a));
+        check_arraylist_state(a, 3, 4);
+        cr_assert(eq(ptr, a.data, a._inline));
+        cr_assert(eq(u16, a.data[0], 1));
+
+    /* test bulk operations across the buffer */
+    uint16_t array[] = { 10, 11, 12, 13, 14, 15 };
+    ncr_assert_status(arraylist_append_array(small_inline)(&a, array, 6));
+        cr_assert(eq(sz, a.size, 9));
+        cr_assert(ne(ptr, a.data, a._inline));
+        cr_assert(eq(u16, a.data[8], 15));
+    ncr_assert_status(arraylist_remove_range(small_inline)(&a, 1, 7));
+        check_arraylist_state(a, 2, 4);
+        cr_assert(eq(ptr, a.data, a._inline));
+        cr_assert(eq(u16, a.data[0], 1));
+        cr_assert(eq(u16, a.data[1], 15));
+
+    /* test converting the buffer into a list */
+    list(uint16_t) l;
+    ncr_assert_status(arraylist_to_list(small_inline)(&a, &l));
+        cr_assert(eq(sz, l.size, 2));
+        cr_assert(ne(ptr, l.data, a.data));
+        cr_assert(eq(u16, l.data[0], 1));
+        cr_assert(eq(u16, l.data[1], 15));
+    free(l.data);
+
+    /* test moving an arraylist which uses its buffer */
+    arraylist_inline(uint16_t, 4) b;
+    ncr_assert_status(arraylist_move_append(small_inline)(&a, 16, &b));
+        check_arraylist_state(b, 3, 4);
+        cr_assert(eq(ptr, b.data, b._inline));
+        cr_assert(eq(u16, b.data[2], 16));
+
+    /* test initializing with a size larger than the buffer */
+    arraylist_free(small_inline)(&a);
+    ncr_assert_status(arraylist_init(small_inline)(&a, 16));
+        check_arraylist_state(a, 0, 16);
+        cr_assert(ne(ptr, a.data, a._inline));
+
+    /* test that freeing resets an arraylist to its buffer */
+    arraylist_free(small_inline)(&a);
+        check_arraylist_state(a, 0, 4);
+        cr_assert(eq(ptr, a.data, a._inline));
+    ncr_assert_status(arraylist_add(small_inline)(&a, 1));
+        check_arraylist_state(a, 1, 4);
+
+    arraylist_free(small_inline)(&b);
+    arraylist_free(small_inline)(&a);
+
+    /* test that regular and other inline arraylists of the type coexist */
+    arraylist(uint16_t) c;
+    arraylist_inline(uint16_t, 8) d;
+    ncr_assert_status(arraylist_init_empty(uint16_t)(&c));
+    ncr_assert_status(arraylist_init_empty(large_inline)(&d));
+    for (uint16_t i = 0; i < 8; i++) {
+        ncr_assert_status(arraylist_add(uint16_t)(&c, i));
+        ncr_assert_status(arraylist_add(large_inline)(&d, i));
+    }
+        check_arraylist_state(c, 8, 8);
+        check_arraylist_state(d, 8, 8);
+        cr_assert(eq(ptr, d.data, d._inline));
+        cr_assert(eq(u16, d.data[7], 7));
+    ncr_assert_status(arraylist_add(large_inline)(&d, 8));
+        check_arraylist_state(d, 9, 16);
+        cr_assert(ne(ptr, d.data, d._inline));
+
+    arraylist_free(uint16_t)(&c);
+    arraylist_free(large_inline)(&d);
+}
+
+Test(arraylist, inline_shrink_quarter) {
+    arraylist_inline(counter_t, 3) e;
+    ncr_assert_status(arraylist_init_empty(quarter_inline)(&e));
+    for (counter_t i = 0; i < 40; i++) {
+        ncr_assert_status(arraylist_add(quarter_inline)(&e, i));
+    }
+        check_arraylist_state(e, 40, 40);
+        cr_assert(ne(ptr, e.data, e._inline));
+
+    /* test that the elements move back although quarter shrinking keeps more memory */
+    ncr_assert_status(arraylist_remove_range(quarter_inline)(&e, 2, 38));
+        check_arraylist_state(e, 2, 3);
+        cr_assert(eq(ptr, e.data, e._inline));
+        cr_assert(eq(u32, e.data[0], 0));
+        cr_assert(eq(u32, e.data[1], 1));
+
+    /* test the same with removing one element at a time */
+    for (counter_t i = 0; i < 20; i++) {
+        ncr_assert_status(arraylist_add(quarter_inline)(&e, i));
+    }
+    while (e.size > 3) {
+        ncr_assert_status(arraylist_pop(quarter_inline)(&e));
+    }
+        check_arraylist_state(e, 3, 3);
+        cr_assert(eq(ptr, e.data, e._inline));
+        cr_assert(eq(u32, e.data[2], 0));
+
+    arraylist_free(quarter_inline)(&e);
+}
+
 Test(arraylist, move_append) {
 
 }
\ No newline at end of file